@@ -0,0 +1,523 @@
+/**
+ * @file rc6_bench.cpp
+ * @brief Throughput and latency benchmark for the RC6 library.
+ *
+ * Measures single-block and bulk block operations, every mode of operation,
+ * the parallel engine at several thread counts, asynchronous submission,
+ * key setup latency and key schedule cache lookups.
+ * Results are printed as a table, CSV (--csv) or JSON (--json).
+ *
+ * Usage: rc6_bench [--csv | --json] [--size=BYTES] [--min-time=SECONDS]
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define RC6_BENCH_HAVE_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define RC6_BENCH_HAVE_TSC 1
+#endif
+
+#include "rc6.hpp"
+#include "rc6_async.hpp"
+#include "rc6_backend.hpp"
+#include "rc6_batch.hpp"
+#include "rc6_cache.hpp"
+#include "rc6_cbc.hpp"
+#include "rc6_ctr.hpp"
+#include "rc6_generic.hpp"
+#include "rc6_ocb.hpp"
+#include "rc6_parallel.hpp"
+#include "rc6_schedule.hpp"
+#include "rc6_secure_pool.hpp"
+#include "rc6_stream.hpp"
+#include "rc6_xts.hpp"
+
+namespace {
+    /**
+     * @brief One benchmark measurement.
+     */
+    struct Result {
+        std::string name; //!< Benchmark name
+        std::string backend; //!< Kernel backend in use
+        size_t threads; //!< Number of threads
+        size_t bytes; //!< Bytes processed per iteration (0 for latency benchmarks)
+        size_t iterations; //!< Number of iterations run
+        double seconds; //!< Total wall-clock time
+        double cycles; //!< Total time stamp counter ticks, or -1 if unavailable
+    };
+
+    enum class Format {
+        Table,
+        Csv,
+        Json
+    };
+
+    double readCycles() {
+#ifdef RC6_BENCH_HAVE_TSC
+        return static_cast<double>(__rdtsc());
+#else
+        return -1.0;
+#endif
+    }
+
+    // Defeats dead-code elimination of benchmark results
+    volatile uint8_t sink;
+
+    /**
+     * @brief Run op repeatedly for at least min_time seconds.
+     */
+    template<typename Op>
+    Result measure(const std::string &name, const size_t threads, const size_t bytes,
+                   const double min_time, Op op) {
+        // Warm up caches, page tables and the kernel dispatcher
+        op();
+
+        size_t iterations = 0;
+        size_t batch = 1;
+        const auto start = std::chrono::steady_clock::now();
+        const double start_cycles = readCycles();
+        double elapsed = 0.0;
+        while (elapsed < min_time) {
+            for (size_t i = 0; i < batch; ++i) {
+                op();
+            }
+            iterations += batch;
+            batch *= 2;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        const double end_cycles = readCycles();
+        const double cycles = end_cycles < 0 ? -1.0 : end_cycles - start_cycles;
+
+        return Result{name, RC6Backend::active(), threads, bytes, iterations, elapsed, cycles};
+    }
+
+    /**
+     * @brief Run op on several threads at once for at least min_time seconds.
+     *
+     * Each thread calls op(thread index) in a loop. The iterations of all
+     * threads are added up, so ns/op is wall-clock time per call under
+     * contention and falls as the threads scale.
+     */
+    template<typename Op>
+    Result measureConcurrent(const std::string &name, const size_t threads, const double min_time, Op op) {
+        op(0);
+
+        std::atomic<bool> stop(false);
+        std::atomic<size_t> iterations(0);
+        std::vector<std::thread> workers;
+        const auto start = std::chrono::steady_clock::now();
+        const double start_cycles = readCycles();
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                size_t calls = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    op(t);
+                    ++calls;
+                }
+                iterations.fetch_add(calls);
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(min_time));
+        stop.store(true);
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double end_cycles = readCycles();
+        const double cycles = end_cycles < 0 ? -1.0 : end_cycles - start_cycles;
+
+        return Result{name, RC6Backend::active(), threads, 0, iterations.load(), elapsed, cycles};
+    }
+
+    double gigabytesPerSecond(const Result &r) {
+        return static_cast<double>(r.bytes) * static_cast<double>(r.iterations) / r.seconds / 1e9;
+    }
+
+    double cyclesPerByte(const Result &r) {
+        if (r.cycles < 0 || r.bytes == 0) {
+            return -1.0;
+        }
+        return r.cycles / (static_cast<double>(r.bytes) * static_cast<double>(r.iterations));
+    }
+
+    double nanosecondsPerOp(const Result &r) {
+        return r.seconds * 1e9 / static_cast<double>(r.iterations);
+    }
+
+    void print(const std::vector<Result> &results, const Format format) {
+        std::cout << std::fixed;
+        switch (format) {
+            case Format::Csv:
+                std::cout << "name,backend,threads,bytes,iterations,seconds,gb_per_s,cycles_per_byte,ns_per_op"
+                        << std::endl;
+                for (const auto &r: results) {
+                    std::cout << r.name << ',' << r.backend << ',' << r.threads << ',' << r.bytes << ','
+                            << r.iterations << ',' << std::setprecision(6) << r.seconds << ','
+                            << std::setprecision(4) << gigabytesPerSecond(r) << ',' << cyclesPerByte(r) << ','
+                            << nanosecondsPerOp(r) << std::endl;
+                }
+                break;
+            case Format::Json:
+                std::cout << "[" << std::endl;
+                for (size_t i = 0; i < results.size(); ++i) {
+                    const auto &r = results[i];
+                    std::cout << "  {\"name\": \"" << r.name << "\", \"backend\": \"" << r.backend
+                            << "\", \"threads\": " << r.threads << ", \"bytes\": " << r.bytes
+                            << ", \"iterations\": " << r.iterations << ", \"seconds\": "
+                            << std::setprecision(6) << r.seconds << ", \"gb_per_s\": " << std::setprecision(4)
+                            << gigabytesPerSecond(r) << ", \"cycles_per_byte\": " << cyclesPerByte(r)
+                            << ", \"ns_per_op\": " << nanosecondsPerOp(r) << "}"
+                            << (i + 1 < results.size() ? "," : "") << std::endl;
+                }
+                std::cout << "]" << std::endl;
+                break;
+            case Format::Table:
+                std::cout << std::left << std::setw(24) << "benchmark" << std::setw(10) << "backend"
+                        << std::right << std::setw(8) << "threads" << std::setw(12) << "GB/s"
+                        << std::setw(12) << "cycles/B" << std::setw(14) << "ns/op" << std::endl;
+                for (const auto &r: results) {
+                    std::cout << std::left << std::setw(24) << r.name << std::setw(10) << r.backend
+                            << std::right << std::setw(8) << r.threads << std::setprecision(3)
+                            << std::setw(12) << gigabytesPerSecond(r) << std::setw(12) << cyclesPerByte(r)
+                            << std::setw(14) << nanosecondsPerOp(r) << std::endl;
+                }
+                break;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    Format format = Format::Table;
+    size_t size = 1 << 20;
+    double min_time = 0.2;
+    std::string backend = "auto";
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--csv") {
+            format = Format::Csv;
+        } else if (arg == "--json") {
+            format = Format::Json;
+        } else if (arg.compare(0, 7, "--size=") == 0) {
+            size = std::strtoull(arg.c_str() + 7, nullptr, 10) / 16 * 16;
+        } else if (arg.compare(0, 11, "--min-time=") == 0) {
+            min_time = std::strtod(arg.c_str() + 11, nullptr);
+        } else if (arg.compare(0, 10, "--backend=") == 0) {
+            backend = arg.substr(10);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--csv | --json] [--size=BYTES] [--min-time=SECONDS]"
+                    << " [--backend=NAME]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (size == 0) {
+        std::cerr << "Error: size must be at least 16 bytes" << std::endl;
+        return 1;
+    }
+
+    try {
+        RC6Backend::force(backend);
+
+        uint8_t key[32];
+        uint8_t iv[16];
+        for (size_t i = 0; i < sizeof(key); ++i) {
+            key[i] = static_cast<uint8_t>(i * 17 + 1);
+        }
+        for (size_t i = 0; i < sizeof(iv); ++i) {
+            iv[i] = static_cast<uint8_t>(i * 5 + 3);
+        }
+
+        RC6 rc6;
+        rc6.init(key, 128);
+
+        std::vector<uint8_t> buffer(size, 0x5a);
+        std::vector<uint8_t> output(size + 2 * RC6Stream::BLOCK_SIZE);
+        const size_t nblocks = size / 16;
+        std::vector<Result> results;
+
+        results.push_back(measure("encrypt_block", 1, 16, min_time, [&] {
+            rc6.encrypt(buffer.data());
+        }));
+        results.push_back(measure("decrypt_block", 1, 16, min_time, [&] {
+            rc6.decrypt(buffer.data());
+        }));
+        results.push_back(measure("encrypt_block_unchecked", 1, 16, min_time, [&] {
+            rc6.encryptUnchecked(buffer.data());
+        }));
+        results.push_back(measure("encrypt_blocks", 1, size, min_time, [&] {
+            rc6.encryptBlocks(buffer.data(), nblocks);
+        }));
+        results.push_back(measure("decrypt_blocks", 1, size, min_time, [&] {
+            rc6.decryptBlocks(buffer.data(), nblocks);
+        }));
+        {
+            const RC6Schedule schedule(rc6);
+            results.push_back(measure("schedule_encrypt", 1, size, min_time, [&] {
+                schedule.encryptBlocks(buffer.data(), nblocks);
+            }));
+            results.push_back(measure("schedule_decrypt", 1, size, min_time, [&] {
+                schedule.decryptBlocks(buffer.data(), nblocks);
+            }));
+        }
+
+        // The word-size family without vector kernels, against the scalar backend
+        {
+            RC6T<uint16_t, 16> rc6_16;
+            RC6T<uint32_t, 20> rc6_32;
+            RC6T<uint64_t, 24> rc6_64;
+            rc6_16.init(key, 128);
+            rc6_32.init(key, 128);
+            rc6_64.init(key, 128);
+            results.push_back(measure("rc6_16_encrypt_blocks", 1, size, min_time, [&] {
+                rc6_16.encryptBlocks(buffer.data(), size / rc6_16.BLOCK_SIZE);
+            }));
+            results.push_back(measure("rc6_32_encrypt_blocks", 1, size, min_time, [&] {
+                rc6_32.encryptBlocks(buffer.data(), size / rc6_32.BLOCK_SIZE);
+            }));
+            results.push_back(measure("rc6_64_encrypt_blocks", 1, size, min_time, [&] {
+                rc6_64.encryptBlocks(buffer.data(), size / rc6_64.BLOCK_SIZE);
+            }));
+        }
+
+        // Bulk throughput of each other backend on its own
+        if (!RC6Backend::isForced()) {
+            const std::string automatic = RC6Backend::active();
+            for (const auto &name: RC6Backend::available()) {
+                if (name == automatic) {
+                    continue;
+                }
+                RC6Backend::force(name);
+                results.push_back(measure("encrypt_blocks", 1, size, min_time, [&] {
+                    rc6.encryptBlocks(buffer.data(), nblocks);
+                }));
+                results.push_back(measure("decrypt_blocks", 1, size, min_time, [&] {
+                    rc6.decryptBlocks(buffer.data(), nblocks);
+                }));
+                const RC6Schedule schedule(rc6);
+                results.push_back(measure("schedule_encrypt", 1, size, min_time, [&] {
+                    schedule.encryptBlocks(buffer.data(), nblocks);
+                }));
+            }
+            RC6Backend::reset();
+        }
+
+        const struct {
+            const char *name;
+            RC6Stream::Mode mode;
+            RC6Stream::Direction direction;
+        } modes[] = {
+            {"cbc_encrypt", RC6Stream::Mode::CBC, RC6Stream::Direction::Encrypt},
+            {"cbc_decrypt", RC6Stream::Mode::CBC, RC6Stream::Direction::Decrypt},
+            {"ctr", RC6Stream::Mode::CTR, RC6Stream::Direction::Encrypt},
+            {"cfb_encrypt", RC6Stream::Mode::CFB, RC6Stream::Direction::Encrypt},
+            {"cfb_decrypt", RC6Stream::Mode::CFB, RC6Stream::Direction::Decrypt},
+            {"ofb", RC6Stream::Mode::OFB, RC6Stream::Direction::Encrypt},
+        };
+        for (const auto &m: modes) {
+            results.push_back(measure(m.name, 1, size, min_time, [&] {
+                RC6Stream stream(rc6, m.mode, m.direction, iv, false);
+                stream.update(buffer.data(), size, output.data());
+                sink = output[0];
+            }));
+        }
+
+        // Packet-sized segments of odd length, processed in place
+        std::vector<RC6Stream::Segment> segments;
+        for (size_t offset = 0; offset < size; offset += 1447) {
+            segments.push_back(RC6Stream::Segment{&output[offset], std::min<size_t>(1447, size - offset)});
+        }
+        results.push_back(measure("ctr_segments", 1, size, min_time, [&] {
+            RC6Stream stream(rc6, RC6Stream::Mode::CTR, RC6Stream::Direction::Encrypt, iv, false);
+            stream.update(segments.data(), segments.size());
+            sink = output[0];
+        }));
+
+        // 64-byte messages with their own IVs, under one key and under 64 keys
+        std::vector<RC6> tenants(64);
+        for (auto &tenant: tenants) {
+            tenant.init(key, 128);
+        }
+        const size_t job_count = size / 64;
+        std::vector<RC6Batch::Job> jobs(job_count);
+        for (size_t i = 0; i < job_count; ++i) {
+            jobs[i].cipher = &rc6;
+            std::memcpy(jobs[i].iv, iv, sizeof(iv));
+            jobs[i].iv[0] = static_cast<uint8_t>(i);
+            jobs[i].in = buffer.data() + 64 * i;
+            jobs[i].out = output.data() + 64 * i;
+            jobs[i].len = 64;
+        }
+        results.push_back(measure("ctr_64B_messages", 1, job_count * 64, min_time, [&] {
+            for (const auto &job: jobs) {
+                RC6CTR(*job.cipher, job.iv).process(job.in, job.out, job.len);
+            }
+            sink = output[0];
+        }));
+        results.push_back(measure("batch_ctr_64B", 1, job_count * 64, min_time, [&] {
+            RC6Batch::processCTR(jobs.data(), jobs.size());
+            sink = output[0];
+        }));
+        for (size_t i = 0; i < job_count; ++i) {
+            jobs[i].cipher = &tenants[i % tenants.size()];
+        }
+        results.push_back(measure("batch_ctr_64B_64keys", 1, job_count * 64, min_time, [&] {
+            RC6Batch::processCTR(jobs.data(), jobs.size());
+            sink = output[0];
+        }));
+
+        // The same schedule pattern without the counter mode around it
+        std::vector<const RC6 *> block_ciphers(job_count * 4);
+        for (size_t i = 0; i < block_ciphers.size(); ++i) {
+            block_ciphers[i] = jobs[i / 4].cipher;
+        }
+        results.push_back(measure("encrypt_many_64keys", 1, job_count * 64, min_time, [&] {
+            RC6::encryptBlocksMany(block_ciphers.data(), buffer.data(), output.data(), block_ciphers.size());
+            sink = output[0];
+        }));
+        {
+            std::vector<const RC6 *> lane_ciphers(RC6::bulkLanes());
+            for (size_t k = 0; k < lane_ciphers.size(); ++k) {
+                lane_ciphers[k] = &tenants[k];
+            }
+            const RC6Schedule schedule(lane_ciphers.data(), lane_ciphers.size());
+            results.push_back(measure("schedule_encrypt_lanes", 1, size, min_time, [&] {
+                schedule.encryptBlocks(buffer.data(), nblocks);
+            }));
+        }
+
+        // Submission, coalescing and completion of a burst; passes run in
+        // order, so once the last job completes all earlier ones have too
+        {
+            RC6Parallel async_engine(1);
+            RC6Async async(async_engine);
+            std::vector<RC6Async::Request> requests(job_count);
+            for (size_t i = 0; i < job_count; ++i) {
+                requests[i] = RC6Async::Request{RC6Async::Operation::ProcessCTR, jobs[i].cipher, {0},
+                                                jobs[i].in, jobs[i].out, jobs[i].len};
+                std::memcpy(requests[i].iv, jobs[i].iv, sizeof(iv));
+            }
+            results.push_back(measure("async_ctr_64B_64keys", 1, job_count * 64, min_time, [&] {
+                for (size_t i = 0; i + 1 < job_count; ++i) {
+                    async.submit(requests[i], [](std::exception_ptr) {
+                    });
+                }
+                async.submit(requests[job_count - 1]).get();
+                sink = output[0];
+            }));
+        }
+
+        // Independent messages sharing the buffer, one block of each per lane
+        const RC6CBC cbc(rc6);
+        const size_t message_count = std::min<size_t>(64, nblocks);
+        std::vector<RC6CBC::Message> messages(message_count);
+        results.push_back(measure("cbc_encrypt_many", 1, message_count * (nblocks / message_count) * 16,
+                                  min_time, [&] {
+            for (size_t k = 0; k < message_count; ++k) {
+                messages[k].in = buffer.data() + k * (nblocks / message_count) * 16;
+                messages[k].out = output.data() + k * (nblocks / message_count) * 16;
+                messages[k].nblocks = nblocks / message_count;
+                std::memcpy(messages[k].iv, iv, sizeof(iv));
+            }
+            cbc.encryptMany(messages.data(), message_count);
+            sink = output[0];
+        }));
+
+        const RC6OCB ocb(rc6);
+        uint8_t tag[RC6OCB::MAX_TAG_SIZE];
+        results.push_back(measure("ocb_encrypt", 1, size, min_time, [&] {
+            ocb.encrypt(iv, 12, nullptr, 0, buffer.data(), size, output.data(), tag);
+            sink = tag[0];
+        }));
+        results.push_back(measure("ocb_decrypt", 1, size, min_time, [&] {
+            sink = ocb.decrypt(iv, 12, nullptr, 0, output.data(), size, buffer.data(), tag);
+        }));
+
+        const RC6XTS xts(key, 256);
+        results.push_back(measure("xts_encrypt_sectors_512", 1, size / 512 * 512, min_time, [&] {
+            xts.encryptSectors(0, buffer.data(), output.data(), 512, size / 512);
+            sink = output[0];
+        }));
+        results.push_back(measure("xts_decrypt_sectors_512", 1, size / 512 * 512, min_time, [&] {
+            xts.decryptSectors(0, output.data(), buffer.data(), 512, size / 512);
+            sink = buffer[0];
+        }));
+
+        std::vector<size_t> thread_counts = {1, 2, 4};
+        const size_t hardware = std::thread::hardware_concurrency();
+        if (hardware > 4) {
+            thread_counts.push_back(hardware);
+        }
+        const RC6CTR ctr(rc6, iv);
+        for (const size_t threads: thread_counts) {
+            RC6Parallel engine(threads);
+            results.push_back(measure("parallel_ecb_encrypt", threads, size, min_time, [&] {
+                engine.encryptECB(rc6, buffer.data(), buffer.data(), nblocks);
+            }));
+            results.push_back(measure("parallel_ctr", threads, size, min_time, [&] {
+                engine.processCTR(ctr, 0, buffer.data(), buffer.data(), size);
+            }));
+            results.push_back(measure("parallel_cbc_decrypt", threads, size, min_time, [&] {
+                engine.decryptCBC(rc6, iv, buffer.data(), buffer.data(), nblocks);
+            }));
+
+            // Mid-sized buffers, where hand-off cost decides whether threads help
+            const size_t mid_size = std::min<size_t>(size, 64 * 1024);
+            results.push_back(measure("parallel_ctr_64K", threads, mid_size, min_time, [&] {
+                engine.processCTR(ctr, 0, buffer.data(), buffer.data(), mid_size);
+            }));
+        }
+
+        for (const uint16_t bits: {128, 192, 256}) {
+            RC6 keyed;
+            results.push_back(measure("init_" + std::to_string(bits), 1, 0, min_time, [&] {
+                keyed.init(key, bits);
+            }));
+        }
+
+        // Batch key setup; ns/op covers all keys of a call
+        std::vector<RC6> many(64);
+        std::vector<const void *> many_keys(many.size(), key);
+        results.push_back(measure("init_many_128x64", 1, 0, min_time, [&] {
+            RC6::initMany(many.data(), many_keys.data(), 128, many.size());
+        }));
+
+        // Create, key and destroy one context from locked memory
+        RC6SecurePool pool;
+        results.push_back(measure("secure_pool_create_128", 1, 0, min_time, [&] {
+            sink = pool.create(key, 128)->isInitialized();
+        }));
+
+        RC6KeyCache cache(1024);
+        uint64_t key_id = 0;
+        results.push_back(measure("cache_hit", 1, 0, min_time, [&] {
+            sink = cache.get(key_id++ & 255, key, 128)->isInitialized();
+        }));
+
+        // Hits from several threads on hot keys spread over the shards
+        for (const size_t threads: thread_counts) {
+            results.push_back(measureConcurrent("cache_hit_concurrent", threads, min_time, [&](const size_t t) {
+                static thread_local uint64_t next_id = 0;
+                sink = cache.get((next_id++ + 37 * t) & 255, key, 128)->isInitialized();
+            }));
+        }
+
+        sink = buffer[0];
+        print(results, format);
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
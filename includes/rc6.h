@@ -0,0 +1,351 @@
+/**
+ * @file rc6.h
+ * @brief C interface to the RC6 library.
+ *
+ * This header declares a stable C ABI for callers that cannot use the C++
+ * classes directly, such as Python (ctypes, cffi) or Go (cgo) bindings. A
+ * keyed schedule lives in an opaque context, and every data function takes a
+ * whole buffer as pointer and length, so a binding crosses the language
+ * boundary once per buffer rather than once per block. The calls go straight
+ * to the bulk kernels and modes of the C++ library.
+ *
+ * No function throws or aborts: errors are reported as rc6_status codes.
+ * Functions taking a const context may be called concurrently on the same
+ * context; a stream context must not be shared between threads.
+ */
+#ifndef RC6_H_
+#define RC6_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+#ifdef RC6_C_BUILD
+#define RC6_C_API __declspec(dllexport)
+#else
+#define RC6_C_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define RC6_C_API __attribute__((visibility("default")))
+#else
+#define RC6_C_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RC6_ABI_VERSION 1 /**< Version of this interface, see rc6_abi_version() */
+#define RC6_BLOCK_SIZE 16 /**< Block size in bytes */
+#define RC6_DEFAULT_ROUNDS 20 /**< Standard number of rounds */
+#define RC6_MAX_ROUNDS 125 /**< Largest supported number of rounds */
+#define RC6_MAX_KEY_BITS 2048 /**< Longest supported key in bits */
+#define RC6_MAX_NONCE_SIZE 15 /**< Longest OCB nonce in bytes */
+#define RC6_MAX_TAG_SIZE 16 /**< Longest OCB tag in bytes */
+
+/**
+ * @brief Result of a call.
+ *
+ * Values are part of the ABI and are never renumbered.
+ */
+typedef enum rc6_status {
+    RC6_OK = 0, /**< Success */
+    RC6_ERROR_NULL_POINTER = 1, /**< A required pointer is null */
+    RC6_ERROR_INVALID_KEY = 2, /**< Key length is out of range, or the XTS key halves are equal */
+    RC6_ERROR_INVALID_ROUNDS = 3, /**< Number of rounds is greater than RC6_MAX_ROUNDS */
+    RC6_ERROR_INVALID_LENGTH = 4, /**< A length is not a multiple of the block size or is out of range */
+    RC6_ERROR_AUTHENTICATION = 5, /**< OCB tag mismatch; the output has been zeroed */
+    RC6_ERROR_BAD_PADDING = 6, /**< CBC stream input is incomplete or its padding is invalid */
+    RC6_ERROR_STATE = 7, /**< Stream has already been finished */
+    RC6_ERROR_INVALID_ARGUMENT = 8, /**< An enumeration value is unknown */
+    RC6_ERROR_OUT_OF_MEMORY = 9, /**< Allocation failed */
+    RC6_ERROR_INTERNAL = 10 /**< Unexpected failure inside the library */
+} rc6_status;
+
+/**
+ * @brief Mode of a stream context.
+ */
+typedef enum rc6_stream_mode {
+    RC6_STREAM_CBC = 0, /**< Cipher block chaining, optionally with PKCS#7 padding */
+    RC6_STREAM_CTR = 1, /**< Counter mode (16-byte big-endian counter) */
+    RC6_STREAM_CFB = 2, /**< Cipher feedback with full 128-bit feedback */
+    RC6_STREAM_OFB = 3 /**< Output feedback */
+} rc6_stream_mode;
+
+/**
+ * @brief Direction of a stream context.
+ */
+typedef enum rc6_direction {
+    RC6_ENCRYPT = 0, /**< Encrypt the input */
+    RC6_DECRYPT = 1 /**< Decrypt the input */
+} rc6_direction;
+
+typedef struct rc6_ctx rc6_ctx; /**< Keyed cipher */
+typedef struct rc6_xts rc6_xts; /**< Keyed XTS cipher pair */
+typedef struct rc6_stream rc6_stream; /**< Incremental stream state */
+
+/**
+ * @brief Get the version of the interface the library implements.
+ * @return RC6_ABI_VERSION of the library at build time.
+ */
+RC6_C_API unsigned rc6_abi_version(void);
+
+/**
+ * @brief Get a description of a status code.
+ * @param status Status code.
+ * @return Static, NUL-terminated English text.
+ */
+RC6_C_API const char *rc6_status_string(rc6_status status);
+
+/**
+ * @brief Get the name of the bulk kernel backend in use.
+ *
+ * Reflects the backend active at the time of the call, which can change
+ * through RC6Backend::force() or the RC6_BACKEND environment variable.
+ *
+ * @return Static, NUL-terminated name, such as "avx2" or "scalar".
+ */
+RC6_C_API const char *rc6_backend_name(void);
+
+/**
+ * @brief Create a keyed context.
+ * @param ctx Receives the new context, or null on failure.
+ * @param key Pointer to key_bits / 8 bytes of key.
+ * @param key_bits Key length in bits (1 to RC6_MAX_KEY_BITS).
+ * @param rounds Number of rounds (0 to RC6_MAX_ROUNDS, normally RC6_DEFAULT_ROUNDS).
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER, RC6_ERROR_INVALID_KEY,
+ *         RC6_ERROR_INVALID_ROUNDS or RC6_ERROR_OUT_OF_MEMORY.
+ */
+RC6_C_API rc6_status rc6_ctx_new(rc6_ctx **ctx, const void *key, size_t key_bits, unsigned rounds);
+
+/**
+ * @brief Wipe and free a context.
+ * @param ctx Context, or null.
+ */
+RC6_C_API void rc6_ctx_free(rc6_ctx *ctx);
+
+/**
+ * @brief Encrypt consecutive blocks independently (ECB).
+ * @param ctx Context.
+ * @param in Pointer to len bytes of plaintext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes; a multiple of RC6_BLOCK_SIZE.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+RC6_C_API rc6_status rc6_ecb_encrypt(const rc6_ctx *ctx, const void *in, void *out, size_t len);
+
+/**
+ * @brief Decrypt consecutive blocks independently (ECB).
+ * @param ctx Context.
+ * @param in Pointer to len bytes of ciphertext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes; a multiple of RC6_BLOCK_SIZE.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+RC6_C_API rc6_status rc6_ecb_decrypt(const rc6_ctx *ctx, const void *in, void *out, size_t len);
+
+/**
+ * @brief Encrypt or decrypt in counter mode at a byte offset of the keystream.
+ *
+ * The counter is the whole 16-byte block, incremented big-endian. The call
+ * keeps no state, so a message may be processed in pieces, in any order or
+ * from several threads, by passing the offset of each piece.
+ *
+ * @param ctx Context.
+ * @param iv Pointer to the 16-byte initial counter block.
+ * @param offset Position of in within the message, in bytes.
+ * @param in Pointer to len bytes of input.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes.
+ * @return RC6_OK or RC6_ERROR_NULL_POINTER.
+ */
+RC6_C_API rc6_status rc6_ctr_crypt(const rc6_ctx *ctx, const void *iv, uint64_t offset,
+                                   const void *in, void *out, size_t len);
+
+/**
+ * @brief Encrypt blocks of one CBC message.
+ * @param ctx Context.
+ * @param iv Pointer to the 16-byte chaining value; updated on return, so a
+ *           message may be encrypted in pieces.
+ * @param in Pointer to len bytes of plaintext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes; a multiple of RC6_BLOCK_SIZE.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+RC6_C_API rc6_status rc6_cbc_encrypt(const rc6_ctx *ctx, void *iv, const void *in, void *out, size_t len);
+
+/**
+ * @brief Decrypt blocks of one CBC message.
+ * @param ctx Context.
+ * @param iv Pointer to the 16-byte chaining value; updated on return.
+ * @param in Pointer to len bytes of ciphertext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes; a multiple of RC6_BLOCK_SIZE.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+RC6_C_API rc6_status rc6_cbc_decrypt(const rc6_ctx *ctx, void *iv, const void *in, void *out, size_t len);
+
+/**
+ * @brief Encrypt and authenticate a message with OCB (RFC 7253).
+ * @param ctx Context.
+ * @param nonce Pointer to the nonce; never reuse one with the same key.
+ * @param nonce_len Nonce length in bytes (1 to RC6_MAX_NONCE_SIZE).
+ * @param ad Pointer to the associated data; may be null if ad_len is zero.
+ * @param ad_len Associated data length in bytes.
+ * @param in Pointer to len bytes of plaintext.
+ * @param len Message length in bytes.
+ * @param out Pointer to len bytes of ciphertext. Must either equal in or not overlap it.
+ * @param tag Pointer to tag_len bytes receiving the tag.
+ * @param tag_len Tag length in bytes (1 to RC6_MAX_TAG_SIZE).
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+RC6_C_API rc6_status rc6_ocb_encrypt(const rc6_ctx *ctx, const void *nonce, size_t nonce_len,
+                                     const void *ad, size_t ad_len, const void *in, size_t len,
+                                     void *out, void *tag, size_t tag_len);
+
+/**
+ * @brief Verify and decrypt a message with OCB (RFC 7253).
+ * @param ctx Context.
+ * @param nonce Pointer to the nonce used for encryption.
+ * @param nonce_len Nonce length in bytes (1 to RC6_MAX_NONCE_SIZE).
+ * @param ad Pointer to the associated data; may be null if ad_len is zero.
+ * @param ad_len Associated data length in bytes.
+ * @param in Pointer to len bytes of ciphertext.
+ * @param len Message length in bytes.
+ * @param out Pointer to len bytes of plaintext. Must either equal in or not overlap it.
+ * @param tag Pointer to the tag_len-byte tag to check.
+ * @param tag_len Tag length in bytes (1 to RC6_MAX_TAG_SIZE).
+ * @return RC6_OK, RC6_ERROR_AUTHENTICATION, RC6_ERROR_NULL_POINTER or
+ *         RC6_ERROR_INVALID_LENGTH.
+ */
+RC6_C_API rc6_status rc6_ocb_decrypt(const rc6_ctx *ctx, const void *nonce, size_t nonce_len,
+                                     const void *ad, size_t ad_len, const void *in, size_t len,
+                                     void *out, const void *tag, size_t tag_len);
+
+/**
+ * @brief Create a keyed XTS context.
+ * @param xts Receives the new context, or null on failure.
+ * @param key Pointer to the XTS key: the data key followed by the tweak key.
+ * @param key_bits Total key length in bits; a multiple of 16 up to
+ *                 2 * RC6_MAX_KEY_BITS, with two different halves.
+ * @param rounds Number of rounds (0 to RC6_MAX_ROUNDS, normally RC6_DEFAULT_ROUNDS).
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER, RC6_ERROR_INVALID_KEY,
+ *         RC6_ERROR_INVALID_ROUNDS or RC6_ERROR_OUT_OF_MEMORY.
+ */
+RC6_C_API rc6_status rc6_xts_new(rc6_xts **xts, const void *key, size_t key_bits, unsigned rounds);
+
+/**
+ * @brief Wipe and free an XTS context.
+ * @param xts Context, or null.
+ */
+RC6_C_API void rc6_xts_free(rc6_xts *xts);
+
+/**
+ * @brief Encrypt one data unit in XTS mode.
+ * @param xts Context.
+ * @param tweak Pointer to the 16-byte tweak of the data unit.
+ * @param in Pointer to len bytes of plaintext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes (at least RC6_BLOCK_SIZE).
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+RC6_C_API rc6_status rc6_xts_encrypt(const rc6_xts *xts, const void *tweak, const void *in, void *out, size_t len);
+
+/**
+ * @brief Decrypt one data unit in XTS mode.
+ * @param xts Context.
+ * @param tweak Pointer to the 16-byte tweak of the data unit.
+ * @param in Pointer to len bytes of ciphertext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes (at least RC6_BLOCK_SIZE).
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+RC6_C_API rc6_status rc6_xts_decrypt(const rc6_xts *xts, const void *tweak, const void *in, void *out, size_t len);
+
+/**
+ * @brief Encrypt consecutive sectors in XTS mode.
+ *
+ * The tweak of sector first_sector + i is its number as a 16-byte
+ * little-endian value.
+ *
+ * @param xts Context.
+ * @param first_sector Number of the first sector.
+ * @param in Pointer to count * sector_size bytes of plaintext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param sector_size Sector size in bytes (at least RC6_BLOCK_SIZE).
+ * @param count Number of sectors.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+RC6_C_API rc6_status rc6_xts_encrypt_sectors(const rc6_xts *xts, uint64_t first_sector, const void *in,
+                                             void *out, size_t sector_size, size_t count);
+
+/**
+ * @brief Decrypt consecutive sectors in XTS mode.
+ * @param xts Context.
+ * @param first_sector Number of the first sector.
+ * @param in Pointer to count * sector_size bytes of ciphertext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param sector_size Sector size in bytes (at least RC6_BLOCK_SIZE).
+ * @param count Number of sectors.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+RC6_C_API rc6_status rc6_xts_decrypt_sectors(const rc6_xts *xts, uint64_t first_sector, const void *in,
+                                             void *out, size_t sector_size, size_t count);
+
+/**
+ * @brief Create a stream context for incremental processing.
+ *
+ * The key context must stay alive until the stream is freed.
+ *
+ * @param stream Receives the new stream, or null on failure.
+ * @param ctx Key context.
+ * @param mode Mode of operation.
+ * @param direction Whether the stream encrypts or decrypts.
+ * @param iv Pointer to the 16-byte IV or initial counter block.
+ * @param padding Non-zero for PKCS#7 padding in CBC mode; ignored otherwise.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER, RC6_ERROR_INVALID_ARGUMENT or
+ *         RC6_ERROR_OUT_OF_MEMORY.
+ */
+RC6_C_API rc6_status rc6_stream_new(rc6_stream **stream, const rc6_ctx *ctx, rc6_stream_mode mode,
+                                    rc6_direction direction, const void *iv, int padding);
+
+/**
+ * @brief Wipe and free a stream context.
+ * @param stream Stream, or null.
+ */
+RC6_C_API void rc6_stream_free(rc6_stream *stream);
+
+/**
+ * @brief Process a chunk of input.
+ *
+ * In CTR, CFB and OFB modes out may equal in and exactly len bytes are
+ * written. In CBC mode out must not overlap in, must have room for
+ * len + 15 bytes, and only complete blocks are written.
+ *
+ * @param stream Stream.
+ * @param in Pointer to len bytes of input.
+ * @param len Number of input bytes.
+ * @param out Pointer to the output buffer.
+ * @param written Receives the number of bytes written to out.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_STATE.
+ */
+RC6_C_API rc6_status rc6_stream_update(rc6_stream *stream, const void *in, size_t len, void *out, size_t *written);
+
+/**
+ * @brief Finish a stream.
+ *
+ * In CBC mode this adds or checks and removes the padding; out must have
+ * room for 16 bytes. No further calls but rc6_stream_free() are allowed.
+ *
+ * @param stream Stream.
+ * @param out Pointer to the output buffer.
+ * @param written Receives the number of bytes written to out.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER, RC6_ERROR_BAD_PADDING or RC6_ERROR_STATE.
+ */
+RC6_C_API rc6_status rc6_stream_final(rc6_stream *stream, void *out, size_t *written);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RC6_H_ */
@@ -9,42 +9,79 @@
 #ifndef RC6_HPP_
 #define RC6_HPP_
 
+#include <cassert>
 #include <cstdint>
-#include <vector>
 #include <stdexcept>
 #include <cstddef>
 
+#include "rc6_detail.hpp"
+
+/**
+ * @brief Result of the non-throwing RC6 entry points.
+ */
+enum class RC6Status : uint8_t {
+    Ok = 0, //!< Success
+    NotInitialized, //!< No key has been set
+    NullPointer, //!< A required pointer was null
+    InvalidKeyLength //!< Key length is zero or greater than RC6::MAX_KEY_BITS
+};
+
 /**
  * @class RC6
  * @brief Implementation of the RC6 block cipher algorithm.
  *
  * This class provides a modern C++ implementation of the RC6 block cipher.
  * RC6 is a 128-bit block cipher with variable key size and number of rounds.
- * This implementation is restricted to 32-bit words and assumes a little-endian system.
+ * This implementation is restricted to 32-bit words. Blocks are read and
+ * written byte-wise in little-endian word order, so they may have any
+ * alignment and results are identical on big-endian systems.
  */
 class RC6 {
     static constexpr uint32_t P32 = 0xB7E15163; //!< Magic constant (e - 2)
     static constexpr uint32_t Q32 = 0x9E3779B9; //!< Magic constant (Golden Ratio - 1)
-    static constexpr uint8_t LG_W = 5; //!< Log2 of word size (32 bits)
+
+public:
+    static constexpr uint8_t MAX_ROUNDS = 125; //!< Largest supported number of rounds
+    static constexpr uint16_t MAX_KEY_BITS = 2048; //!< Largest supported key length in bits
+
+private:
+    static constexpr uint16_t MAX_ROUND_KEYS = 2 * MAX_ROUNDS + 4; //!< Round key capacity in words
 
     uint8_t rounds_; //!< Number of rounds, default: 20
-    std::vector<uint32_t> round_keys_; //!< The round keys
+    bool initialized_; //!< Whether a key has been set
+    uint32_t round_keys_[MAX_ROUND_KEYS]; //!< The round keys, stored inline so rekeying never allocates
+
+    friend class RC6Schedule; //!< Transposes round_keys_ into its lane table
+
+    /**
+     * @brief Convert key bytes into little-endian 32-bit key words.
+     * @param key Pointer to the key data.
+     * @param keylength_bits Length of the key in bits (1 to 2048).
+     * @param words Output array of at least MAX_KEY_BITS / 32 words.
+     * @return Number of key words.
+     */
+    static uint16_t loadKeyWords(const void *key, uint16_t keylength_bits, uint32_t *words);
+
+    /**
+     * @brief Run the key schedule for an already validated key.
+     * @param key Pointer to the key data.
+     * @param keylength_bits Length of the key in bits (1 to 2048).
+     */
+    void expandKey(const void *key, uint16_t keylength_bits) noexcept;
 
     /**
-     * @brief Rotate left helper function.
-     * @param a The value to rotate.
-     * @param n The number of bits to rotate.
-     * @return The rotated value.
+     * @brief Encrypt a single block without validating the cipher state.
+     * @param in Pointer to the 16-byte input block.
+     * @param out Pointer to the 16-byte output block (may equal in).
      */
-    static uint32_t rotl32(uint32_t a, uint8_t n);
+    void encryptBlock(const uint8_t *in, uint8_t *out) const noexcept;
 
     /**
-     * @brief Rotate right helper function.
-     * @param a The value to rotate.
-     * @param n The number of bits to rotate.
-     * @return The rotated value.
+     * @brief Decrypt a single block without validating the cipher state.
+     * @param in Pointer to the 16-byte input block.
+     * @param out Pointer to the 16-byte output block (may equal in).
      */
-    static uint32_t rotr32(uint32_t a, uint8_t n);
+    void decryptBlock(const uint8_t *in, uint8_t *out) const noexcept;
 
 public:
     /**
@@ -63,8 +100,10 @@ public:
 
     /**
      * @brief Destructor.
+     *
+     * Wipes the round keys.
      */
-    ~RC6() = default;
+    ~RC6();
 
     /**
      * @brief Copy constructor (deleted).
@@ -82,25 +121,54 @@ public:
     RC6 &operator=(const RC6 &) = delete;
 
     /**
-     * @brief Move constructor (default).
+     * @brief Move constructor.
+     *
+     * The moved-from object is wiped and left uninitialized.
      */
-    RC6(RC6 &&) noexcept = default;
+    RC6(RC6 &&other) noexcept;
 
     /**
-     * @brief Move assignment operator (default).
+     * @brief Move assignment operator.
+     *
+     * The previous round keys of this object are wiped first; the moved-from
+     * object is wiped and left uninitialized.
      * @return Reference to this object.
      */
-    RC6 &operator=(RC6 &&) noexcept = default;
+    RC6 &operator=(RC6 &&other) noexcept;
 
     /**
      * @brief Initialize the cipher with a key.
      * @param key Pointer to the key data.
      * @param keylength_bits Length of the key in bits.
      * @throws std::invalid_argument if key is null or keylength_bits is zero.
+     * @throws std::invalid_argument if keylength_bits is greater than 2048.
      * @throws std::invalid_argument if rounds_ is greater than 125.
      */
     void init(const void *key, uint16_t keylength_bits);
 
+    /**
+     * @brief Initialize several ciphers with keys of the same length.
+     *
+     * Equivalent to calling init() on each cipher, but expands up to one
+     * key per SIMD lane at once.
+     *
+     * @param ciphers Array of count ciphers; each keeps its number of rounds.
+     * @param keys Array of count pointers to the key data.
+     * @param keylength_bits Length of every key in bits.
+     * @param count Number of ciphers.
+     * @throws std::invalid_argument if ciphers, keys or any key is null and count is non-zero.
+     * @throws std::invalid_argument if keylength_bits is zero or greater than 2048.
+     */
+    static void initMany(RC6 *ciphers, const void *const *keys, uint16_t keylength_bits, size_t count);
+
+    /**
+     * @brief Initialize the cipher with a key without throwing.
+     * @param key Pointer to the key data.
+     * @param keylength_bits Length of the key in bits.
+     * @return RC6Status::Ok, RC6Status::NullPointer or RC6Status::InvalidKeyLength.
+     */
+    RC6Status tryInit(const void *key, uint16_t keylength_bits) noexcept;
+
     /**
      * @brief Encrypt a block of data.
      * @param block Pointer to the 16-byte block to encrypt.
@@ -117,6 +185,147 @@ public:
      */
     void decrypt(void *block) const;
 
+    /**
+     * @brief Encrypt a block without any checks.
+     *
+     * Inline and noexcept so it can be used in tight loops and in code built
+     * without exceptions. The caller guarantees that the cipher is
+     * initialized and block is valid; debug builds assert both.
+     *
+     * @param block Pointer to the 16-byte block to encrypt.
+     */
+    void encryptUnchecked(void *block) const noexcept;
+
+    /**
+     * @brief Decrypt a block without any checks.
+     * @param block Pointer to the 16-byte block to decrypt.
+     * @see encryptUnchecked()
+     */
+    void decryptUnchecked(void *block) const noexcept;
+
+    /**
+     * @brief Encrypt multiple consecutive blocks in place.
+     * @param blocks Pointer to nblocks * 16 bytes of data.
+     * @param nblocks Number of 16-byte blocks to encrypt.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if blocks is null and nblocks is non-zero.
+     */
+    void encryptBlocks(void *blocks, size_t nblocks) const;
+
+    /**
+     * @brief Encrypt multiple consecutive blocks out of place.
+     * @param in Pointer to nblocks * 16 bytes of plaintext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to encrypt.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+     */
+    void encryptBlocks(const void *in, void *out, size_t nblocks) const;
+
+    /**
+     * @brief Decrypt multiple consecutive blocks in place.
+     * @param blocks Pointer to nblocks * 16 bytes of data.
+     * @param nblocks Number of 16-byte blocks to decrypt.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if blocks is null and nblocks is non-zero.
+     */
+    void decryptBlocks(void *blocks, size_t nblocks) const;
+
+    /**
+     * @brief Decrypt multiple consecutive blocks out of place.
+     * @param in Pointer to nblocks * 16 bytes of ciphertext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to decrypt.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+     */
+    void decryptBlocks(const void *in, void *out, size_t nblocks) const;
+
+    /**
+     * @brief Encrypt multiple consecutive blocks without any checks.
+     * @param in Pointer to nblocks * 16 bytes of plaintext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to encrypt.
+     * @see encryptUnchecked()
+     */
+    void encryptBlocksUnchecked(const void *in, void *out, size_t nblocks) const noexcept;
+
+    /**
+     * @brief Decrypt multiple consecutive blocks without any checks.
+     * @param in Pointer to nblocks * 16 bytes of ciphertext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to decrypt.
+     * @see encryptUnchecked()
+     */
+    void decryptBlocksUnchecked(const void *in, void *out, size_t nblocks) const noexcept;
+
+    /**
+     * @brief Encrypt blocks that each have their own cipher.
+     *
+     * Block i is encrypted with *ciphers[i]. The bulk kernels run a
+     * different schedule in each lane, so short messages under many keys
+     * still run at vector speed. A lane's schedule is only reloaded when its
+     * cipher changes, so blocks are best laid out lane-major: block i and
+     * block i + bulkLanes() under the same cipher.
+     *
+     * @param ciphers Array of nblocks cipher pointers.
+     * @param in Pointer to nblocks * 16 bytes of plaintext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to encrypt.
+     * @throws std::invalid_argument if ciphers, in, out or any cipher pointer
+     *         is null and nblocks is non-zero.
+     * @throws std::runtime_error if a cipher is not initialized.
+     */
+    static void encryptBlocksMany(const RC6 *const *ciphers, const void *in, void *out, size_t nblocks);
+
+    /**
+     * @brief Encrypt blocks that each have their own cipher, without any checks.
+     * @param ciphers Array of nblocks pointers to initialized ciphers.
+     * @param in Pointer to nblocks * 16 bytes of plaintext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to encrypt.
+     * @see encryptBlocksMany()
+     */
+    static void encryptBlocksManyUnchecked(const RC6 *const *ciphers, const void *in, void *out,
+                                           size_t nblocks) noexcept;
+
+    /**
+     * @brief Get the number of blocks the bulk kernels process side by side.
+     * @return Lane count of the widest kernel in use.
+     */
+    static size_t bulkLanes() noexcept;
+
+    /**
+     * @brief Encrypt multiple consecutive blocks without throwing.
+     * @param in Pointer to nblocks * 16 bytes of plaintext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to encrypt.
+     * @return RC6Status::Ok, RC6Status::NotInitialized or RC6Status::NullPointer.
+     */
+    RC6Status tryEncryptBlocks(const void *in, void *out, size_t nblocks) const noexcept;
+
+    /**
+     * @brief Decrypt multiple consecutive blocks without throwing.
+     * @param in Pointer to nblocks * 16 bytes of ciphertext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to decrypt.
+     * @return RC6Status::Ok, RC6Status::NotInitialized or RC6Status::NullPointer.
+     */
+    RC6Status tryDecryptBlocks(const void *in, void *out, size_t nblocks) const noexcept;
+
+    /**
+     * @brief Wipe the round keys and return to the uninitialized state.
+     */
+    void clear() noexcept;
+
     /**
      * @brief Check if the cipher is initialized.
      * @return True if the cipher is initialized, false otherwise.
@@ -124,4 +333,24 @@ public:
     bool isInitialized() const;
 };
 
+inline void RC6::encryptBlock(const uint8_t *in, uint8_t *out) const noexcept {
+    rc6_detail::encryptBlock(round_keys_, rounds_, in, out);
+}
+
+inline void RC6::decryptBlock(const uint8_t *in, uint8_t *out) const noexcept {
+    rc6_detail::decryptBlock(round_keys_, rounds_, in, out);
+}
+
+inline void RC6::encryptUnchecked(void *block) const noexcept {
+    assert(initialized_ && block != nullptr);
+    auto *data = static_cast<uint8_t *>(block);
+    encryptBlock(data, data);
+}
+
+inline void RC6::decryptUnchecked(void *block) const noexcept {
+    assert(initialized_ && block != nullptr);
+    auto *data = static_cast<uint8_t *>(block);
+    decryptBlock(data, data);
+}
+
 #endif /* RC6_HPP_ */
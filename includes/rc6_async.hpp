@@ -0,0 +1,240 @@
+/**
+ * @file rc6_async.hpp
+ * @brief Header file for asynchronous submission of RC6 jobs.
+ *
+ * This file provides a non-blocking front end to the parallel engine for
+ * event loops: a job is queued and the call returns at once, and a
+ * dispatcher thread runs it and reports completion through a callback, a
+ * future or, with C++20 coroutines, an awaitable. Small CTR jobs that
+ * accumulate while the dispatcher is busy are coalesced into one batch.
+ */
+#ifndef RC6_ASYNC_HPP_
+#define RC6_ASYNC_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "rc6.hpp"
+#include "rc6_parallel.hpp"
+
+// The library header is checked too: it can be empty when the language
+// feature is enabled by a flag but the selected standard is older
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#endif
+#endif
+
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_coroutine)
+#define RC6_ASYNC_COROUTINES 1
+#endif
+
+/**
+ * @class RC6Async
+ * @brief Queues encryption jobs and completes them without blocking the caller.
+ *
+ * Submission validates the job, appends it to a queue and returns. A single
+ * dispatcher thread takes everything queued at once: each run of
+ * consecutively submitted CTR jobs of at most batch_bytes is packed into
+ * one RC6Batch call, so a burst of small messages costs a few kernel calls,
+ * and larger jobs are split across the referenced engine. Completion
+ * handlers run on the dispatcher thread, in submission order, and should
+ * only hand the result back to the caller's loop.
+ *
+ * Jobs run in submission order, except that the jobs of one small-CTR run
+ * are processed together, interleaved block by block. A job that reads
+ * another job's output must therefore not be submitted before that job
+ * has completed. Each job is checked again just before it runs, so a
+ * cipher cleared after submission fails only its own jobs.
+ *
+ * Buffers, ciphers and the engine must stay valid until the job completes.
+ * The destructor finishes every queued job before returning. Submission is
+ * thread-safe, including from completion handlers.
+ */
+class RC6Async {
+public:
+    static constexpr size_t BLOCK_SIZE = 16; //!< RC6 block size in bytes
+
+    /**
+     * @brief Operation performed by a job.
+     */
+    enum class Operation {
+        EncryptECB, //!< Encrypt blocks independently
+        DecryptECB, //!< Decrypt blocks independently
+        ProcessCTR, //!< Encrypt or decrypt in counter mode
+        DecryptCBC //!< Decrypt a CBC message
+    };
+
+    /**
+     * @brief One job.
+     *
+     * A CTR job is equivalent to RC6CTR(*cipher, iv).process(in, out, len).
+     */
+    struct Request {
+        Operation operation; //!< What to do
+        const RC6 *cipher; //!< Keyed schedule
+        uint8_t iv[BLOCK_SIZE]; //!< Initial counter block (CTR) or IV (CBC); unused for ECB
+        const void *in; //!< Input, len bytes
+        void *out; //!< Output, len bytes; must either equal in or not overlap it
+        size_t len; //!< Length in bytes; a multiple of 16 except for CTR
+    };
+
+    /**
+     * @brief Completion handler; receives null on success or the job's exception.
+     */
+    using Callback = std::function<void(std::exception_ptr)>;
+
+private:
+    static constexpr size_t DEFAULT_BATCH_BYTES = 4096; //!< Default small job limit
+
+    /**
+     * @brief A queued job and its handler.
+     */
+    struct Pending {
+        Request request; //!< The job
+        Callback done; //!< Completion handler
+    };
+
+    RC6Parallel &engine_; //!< Engine that runs large jobs
+    size_t batch_bytes_; //!< CTR jobs up to this size are coalesced
+    std::deque<Pending> queue_; //!< Submitted jobs
+    std::mutex mutex_; //!< Protects queue_ and stopping_
+    std::condition_variable work_cv_; //!< Signals new work or shutdown
+    bool stopping_; //!< Set when the object is destroyed
+    std::thread dispatcher_; //!< Dispatcher thread, started last
+
+    /**
+     * @brief Dispatcher thread main loop.
+     */
+    void dispatchLoop();
+
+    /**
+     * @brief Check a job's arguments.
+     * @param request The job.
+     */
+    static void validate(const Request &request);
+
+    /**
+     * @brief Run and complete every job taken from the queue in one pass.
+     * @param jobs The jobs.
+     */
+    void runJobs(std::deque<Pending> &jobs);
+
+    /**
+     * @brief Run a run of small CTR jobs as one batch and complete them.
+     * @param jobs The jobs taken from the queue.
+     * @param first Index of the first job of the run.
+     * @param last Index one past the last job of the run.
+     */
+    void runBatch(std::deque<Pending> &jobs, size_t first, size_t last);
+
+    /**
+     * @brief Run one job on the engine.
+     * @param request The job.
+     */
+    void run(const Request &request);
+
+public:
+    /**
+     * @brief Constructor.
+     * @param engine Parallel engine used for large jobs.
+     * @param batch_bytes CTR jobs of at most this many bytes are coalesced
+     *                    (default: 4096); 0 disables coalescing.
+     */
+    explicit RC6Async(RC6Parallel &engine, size_t batch_bytes = DEFAULT_BATCH_BYTES);
+
+    /**
+     * @brief Destructor.
+     *
+     * Completes all queued jobs and stops the dispatcher.
+     */
+    ~RC6Async();
+
+    /**
+     * @brief Copy constructor (deleted).
+     */
+    RC6Async(const RC6Async &) = delete;
+
+    /**
+     * @brief Copy assignment operator (deleted).
+     * @return Reference to this object.
+     */
+    RC6Async &operator=(const RC6Async &) = delete;
+
+    /**
+     * @brief Queue a job and call a handler when it completes.
+     * @param request The job; it is copied.
+     * @param done Handler run on the dispatcher thread; must not throw.
+     * @throws std::invalid_argument if done is empty, the operation is
+     *         unknown, cipher is null, in or out is null and len is
+     *         non-zero, or an ECB or CBC length is not a multiple of 16.
+     * @throws std::runtime_error if the cipher is not initialized.
+     */
+    void submit(const Request &request, Callback done);
+
+    /**
+     * @brief Queue a job and get a future for its completion.
+     * @param request The job; it is copied.
+     * @return Future that becomes ready when the job completes.
+     * @throws std::invalid_argument if the request is invalid (see above).
+     * @throws std::runtime_error if the cipher is not initialized.
+     */
+    std::future<void> submit(const Request &request);
+
+#ifdef RC6_ASYNC_COROUTINES
+    /**
+     * @class Awaitable
+     * @brief Awaiter that queues its job on co_await.
+     *
+     * The coroutine is resumed on the dispatcher thread; a job failure is
+     * rethrown from the co_await expression.
+     */
+    class Awaitable {
+        RC6Async &async_; //!< Queue the job goes to
+        Request request_; //!< The job
+        std::exception_ptr error_; //!< Result of the job
+
+    public:
+        Awaitable(RC6Async &async, const Request &request) : async_(async), request_(request) {
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(const std::coroutine_handle<> handle) {
+            async_.submit(request_, [this, handle](const std::exception_ptr error) {
+                error_ = error;
+                handle.resume();
+            });
+        }
+
+        void await_resume() const {
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+        }
+    };
+
+    /**
+     * @brief Get an awaitable for a job.
+     *
+     * Defined in the header so that the library itself can be built as C++11.
+     *
+     * @param request The job; it is copied.
+     * @return Awaitable that queues the job when awaited.
+     */
+    Awaitable schedule(const Request &request) {
+        return Awaitable(*this, request);
+    }
+#endif
+};
+
+#endif /* RC6_ASYNC_HPP_ */
@@ -0,0 +1,66 @@
+/**
+ * @file rc6_backend.hpp
+ * @brief Header file for inspecting and selecting the RC6 bulk kernel backends.
+ *
+ * The library probes the CPU once, on first use, and from then on runs
+ * every bulk operation through a fixed table of the fastest kernels it
+ * supports, from the widest to the narrowest. This interface reports that table and can
+ * pin all bulk operations to a single backend, for benchmarking or to get
+ * identical behaviour across a mixed fleet. The RC6_BACKEND environment
+ * variable does the same at startup, e.g. RC6_BACKEND=avx2.
+ */
+#ifndef RC6_BACKEND_HPP_
+#define RC6_BACKEND_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * @class RC6Backend
+ * @brief Lists and forces kernel backends.
+ *
+ * Backend names are "avx512", "avx2", "sse2", "neon" and "scalar"; only
+ * those supported by the running CPU are available. Selection is global
+ * and thread-safe: an operation already in progress finishes with the
+ * table it started with.
+ */
+class RC6Backend {
+public:
+    RC6Backend() = delete;
+
+    /**
+     * @brief Get the backends supported by this CPU.
+     * @return Backend names, from the widest to the narrowest.
+     */
+    static std::vector<std::string> available();
+
+    /**
+     * @brief Get the widest backend used by bulk operations.
+     * @return The forced backend, or the first one of the automatic selection.
+     */
+    static std::string active();
+
+    /**
+     * @brief Check whether a backend has been forced.
+     * @return True if bulk operations are pinned to one backend.
+     */
+    static bool isForced();
+
+    /**
+     * @brief Pin all bulk operations to one backend.
+     *
+     * Blocks that do not fill the backend's lanes are processed one at a
+     * time. "auto" restores the automatic selection.
+     *
+     * @param name Name of an available backend, or "auto".
+     * @throws std::invalid_argument if the backend is unknown or not supported by this CPU.
+     */
+    static void force(const std::string &name);
+
+    /**
+     * @brief Restore the automatic selection.
+     */
+    static void reset();
+};
+
+#endif /* RC6_BACKEND_HPP_ */
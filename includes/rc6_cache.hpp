@@ -0,0 +1,146 @@
+/**
+ * @file rc6_cache.hpp
+ * @brief Header file for the RC6 key schedule cache.
+ *
+ * This file provides a bounded, thread-safe cache of expanded RC6 key
+ * schedules indexed by an application-defined key ID, so that long-lived
+ * keys are expanded once and then shared by every thread that uses them.
+ */
+#ifndef RC6_CACHE_HPP_
+#define RC6_CACHE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "rc6.hpp"
+
+/**
+ * @class RC6KeyCache
+ * @brief Least-recently-used cache of keyed RC6 objects.
+ *
+ * Entries are handed out as shared read-only handles. A handle stays valid
+ * after its entry is evicted or erased, so callers never need to hold a
+ * lock while encrypting.
+ *
+ * Lookups never take a lock: each shard publishes an immutable table that
+ * readers load with std::atomic_load, and a hit only stamps its entry with
+ * the shard's insertion clock. Inserts, evictions and erases copy the
+ * table under the shard's mutex and publish the copy, which suits the
+ * read-mostly use of a few hundred long-lived keys. Key expansion runs
+ * outside of any lock. Recency is approximate: entries hit since the last
+ * insertion into their shard count as equally recent, and for large caches
+ * the LRU order is kept per shard.
+ *
+ * The cache trusts the key ID: a second get() with a known ID but different
+ * key material returns the schedule cached for that ID.
+ */
+class RC6KeyCache {
+public:
+    typedef std::shared_ptr<const RC6> Handle; //!< Shared read-only keyed cipher
+
+private:
+    static constexpr size_t MAX_SHARDS = 16; //!< Upper bound on the number of shards
+    static constexpr size_t MIN_SHARD_CAPACITY = 64; //!< Smallest capacity worth a shard of its own
+
+    /**
+     * @brief A cached schedule and its recency stamp.
+     */
+    struct Entry {
+        Handle cipher; //!< The keyed cipher
+        std::atomic<uint64_t> last_used; //!< Shard clock value at the last use
+    };
+
+    typedef std::unordered_map<uint64_t, std::shared_ptr<Entry> > Table;
+
+    /**
+     * @brief Independently updated part of the cache.
+     */
+    struct Shard {
+        std::mutex mutex; //!< Serializes writers of table
+        std::shared_ptr<const Table> table; //!< Published entries; accessed with std::atomic_load/store
+        std::atomic<uint64_t> clock; //!< Advanced by every insertion
+        size_t capacity; //!< Maximum number of entries
+    };
+
+    uint8_t rounds_; //!< Number of rounds of cached ciphers
+    size_t capacity_; //!< Total maximum number of entries
+    std::vector<Shard> shards_; //!< Shards, a power-of-two count
+
+    /**
+     * @brief Select the shard responsible for a key ID.
+     * @param key_id The key ID.
+     * @return Reference to the shard.
+     */
+    Shard &shardFor(uint64_t key_id);
+
+    /**
+     * @brief Mark an entry as used now.
+     * @param shard The entry's shard.
+     * @param entry The entry.
+     */
+    static void touch(const Shard &shard, Entry &entry);
+
+public:
+    /**
+     * @brief Constructor.
+     * @param capacity Maximum number of cached schedules.
+     * @param rounds Number of rounds of the cached ciphers (default: 20).
+     * @throws std::invalid_argument if capacity is zero or rounds is greater than 125.
+     */
+    explicit RC6KeyCache(size_t capacity, uint8_t rounds = 20);
+
+    RC6KeyCache(const RC6KeyCache &) = delete;
+
+    RC6KeyCache &operator=(const RC6KeyCache &) = delete;
+
+    /**
+     * @brief Look up a cached schedule.
+     * @param key_id The key ID.
+     * @return Handle to the keyed cipher, or an empty handle if not cached.
+     */
+    Handle find(uint64_t key_id);
+
+    /**
+     * @brief Look up a schedule, expanding and caching the key on a miss.
+     * @param key_id The key ID.
+     * @param key Pointer to the key data, used only on a miss.
+     * @param keylength_bits Length of the key in bits.
+     * @return Handle to the keyed cipher.
+     * @throws std::invalid_argument if the key is needed and invalid (see RC6::init).
+     */
+    Handle get(uint64_t key_id, const void *key, uint16_t keylength_bits);
+
+    /**
+     * @brief Remove a schedule from the cache.
+     *
+     * Outstanding handles remain usable.
+     *
+     * @param key_id The key ID.
+     * @return True if an entry was removed.
+     */
+    bool erase(uint64_t key_id);
+
+    /**
+     * @brief Remove all schedules from the cache.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of cached schedules.
+     * @return Entry count.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the maximum number of cached schedules.
+     * @return Capacity.
+     */
+    size_t capacity() const;
+};
+
+#endif /* RC6_CACHE_HPP_ */
@@ -0,0 +1,90 @@
+/**
+ * @file rc6_cbc.hpp
+ * @brief Header file for the RC6 cipher block chaining (CBC) mode.
+ *
+ * This file provides CBC on whole blocks. Decryption has no dependency
+ * between blocks and runs through the bulk kernels; encryption is serial
+ * within a message, so independent messages can be encrypted together with
+ * one block of each message per vector lane.
+ */
+#ifndef RC6_CBC_HPP_
+#define RC6_CBC_HPP_
+
+#include <cstdint>
+#include <cstddef>
+
+#include "rc6.hpp"
+
+/**
+ * @class RC6CBC
+ * @brief RC6 in CBC mode, without padding.
+ *
+ * Every call takes the chaining value (the IV for the first call of a
+ * message) and replaces it with the last ciphertext block, so a message can
+ * be processed in several calls.
+ *
+ * The referenced RC6 object must stay alive and keyed for the lifetime of
+ * this object. Calls do not modify it and may run concurrently.
+ */
+class RC6CBC {
+public:
+    static constexpr size_t BLOCK_SIZE = 16; //!< RC6 block size in bytes
+
+    /**
+     * @brief One message of a multi-buffer call.
+     */
+    struct Message {
+        const void *in; //!< Plaintext, nblocks * 16 bytes
+        void *out; //!< Ciphertext output; may equal in
+        size_t nblocks; //!< Number of blocks
+        uint8_t iv[BLOCK_SIZE]; //!< Chaining value, updated to the last ciphertext block
+    };
+
+private:
+    static constexpr size_t BATCH_BLOCKS = 64; //!< Blocks per bulk kernel call
+
+    const RC6 &cipher_; //!< The keyed block cipher
+
+public:
+    /**
+     * @brief Constructor.
+     * @param cipher Initialized RC6 object.
+     * @throws std::runtime_error if the cipher is not initialized.
+     */
+    explicit RC6CBC(const RC6 &cipher);
+
+    /**
+     * @brief Encrypt blocks of one message.
+     * @param iv Pointer to the 16-byte chaining value; updated on return.
+     * @param in Pointer to nblocks * 16 bytes of plaintext.
+     * @param out Pointer to the output. Must either equal in or not overlap it.
+     * @param nblocks Number of blocks.
+     * @throws std::invalid_argument if iv, in or out is null and nblocks is non-zero.
+     */
+    void encrypt(void *iv, const void *in, void *out, size_t nblocks) const;
+
+    /**
+     * @brief Decrypt blocks of one message.
+     * @param iv Pointer to the 16-byte chaining value; updated on return.
+     * @param in Pointer to nblocks * 16 bytes of ciphertext.
+     * @param out Pointer to the output. Must either equal in or not overlap it.
+     * @param nblocks Number of blocks.
+     * @throws std::invalid_argument if iv, in or out is null and nblocks is non-zero.
+     */
+    void decrypt(void *iv, const void *in, void *out, size_t nblocks) const;
+
+    /**
+     * @brief Encrypt several independent messages at once.
+     *
+     * Equivalent to calling encrypt() on each message, but runs block i of
+     * all messages through the bulk kernels together.
+     *
+     * @param messages Array of count messages; their iv fields are updated.
+     * @param count Number of messages.
+     * @throws std::invalid_argument if messages is null and count is non-zero,
+     *         or if a message with blocks has a null in or out pointer.
+     */
+    void encryptMany(Message *messages, size_t count) const;
+};
+
+#endif /* RC6_CBC_HPP_ */
@@ -0,0 +1,80 @@
+/**
+ * @file rc6_file.hpp
+ * @brief Header file for RC6 CTR encryption of whole files.
+ *
+ * This file provides file encryption on top of the parallel engine. On
+ * POSIX systems regular files are memory-mapped in large windows, so the
+ * cipher reads and writes the page cache directly and no user-space copy or
+ * per-block system call is made. Pipes and other unmappable inputs, and all
+ * files on other platforms, go through large aligned buffers instead.
+ */
+#ifndef RC6_FILE_HPP_
+#define RC6_FILE_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "rc6_ctr.hpp"
+#include "rc6_parallel.hpp"
+
+/**
+ * @class RC6File
+ * @brief Encrypts or decrypts files in CTR mode.
+ *
+ * Byte i of the file is combined with keystream byte i, so encryption and
+ * decryption are the same operation. The referenced engine must outlive
+ * this object; calls on one engine are serialized by the caller.
+ */
+class RC6File {
+    static constexpr size_t DEFAULT_WINDOW_BYTES = 64 * 1024 * 1024; //!< Default mapping/buffer size
+
+    RC6Parallel &engine_; //!< Engine that runs the keystream
+    size_t window_bytes_; //!< Bytes mapped or buffered at once
+
+    /**
+     * @brief Process a file through read and write calls on a buffer.
+     * @param ctr Counter mode context.
+     * @param in_fd Input descriptor.
+     * @param out_fd Output descriptor (may equal in_fd for in-place use).
+     * @return Number of bytes processed.
+     * @throws std::runtime_error on I/O errors.
+     */
+    uint64_t processBuffered(const RC6CTR &ctr, int in_fd, int out_fd) const;
+
+public:
+    /**
+     * @brief Constructor.
+     * @param engine Parallel engine used for the keystream.
+     * @param window_bytes Bytes mapped or buffered at once (default: 64 MiB).
+     * @throws std::invalid_argument if window_bytes is zero.
+     */
+    explicit RC6File(RC6Parallel &engine, size_t window_bytes = DEFAULT_WINDOW_BYTES);
+
+    /**
+     * @brief Encrypt or decrypt a file in place.
+     * @param ctr Counter mode context; its stream position is not used.
+     * @param path Path of the file.
+     * @return Number of bytes processed.
+     * @throws std::runtime_error on I/O errors.
+     */
+    uint64_t processInPlace(const RC6CTR &ctr, const std::string &path) const;
+
+    /**
+     * @brief Encrypt or decrypt a file into another file.
+     * @param ctr Counter mode context; its stream position is not used.
+     * @param in_path Path of the input; "-" reads standard input.
+     * @param out_path Path of the output, created or truncated; "-" writes standard output.
+     * @return Number of bytes processed.
+     * @throws std::runtime_error on I/O errors.
+     */
+    uint64_t process(const RC6CTR &ctr, const std::string &in_path, const std::string &out_path) const;
+
+    /**
+     * @brief Get the window size.
+     * @return Bytes mapped or buffered at once.
+     */
+    size_t windowBytes() const;
+};
+
+#endif /* RC6_FILE_HPP_ */
@@ -0,0 +1,511 @@
+/**
+ * @file rc6_generic.hpp
+ * @brief Header file for RC6-w/r/b with any supported word size and round count.
+ *
+ * RC6 is defined for a word size w, a number of rounds r and a key length
+ * b. The RC6 class fixes w = 32 and is the one with vectorized kernels and
+ * modes of operation; this header provides the whole family as a class
+ * template over the word type and the round count, with the magic
+ * constants of each word size. A block is four words, so RC6-64 works on
+ * 32-byte blocks and moves twice the data per round on a 64-bit core.
+ *
+ * The template is header-only and uses the same conventions as RC6:
+ * little-endian words, byte-wise loads of any alignment, keys given in
+ * bits, and round keys wiped on destruction, move and clear().
+ */
+#ifndef RC6_GENERIC_HPP_
+#define RC6_GENERIC_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "rc6_detail.hpp"
+
+/**
+ * @class RC6T
+ * @brief RC6-w/r/b block cipher for a word type and a compile-time round count.
+ *
+ * Word is uint16_t, uint32_t or uint64_t, and the block size is 4 *
+ * sizeof(Word) bytes. RC6T<uint32_t, 20> computes the same function as
+ * RC6 with 20 rounds. Bulk calls interleave independent blocks in
+ * general-purpose registers, like the scalar backend of RC6.
+ *
+ * @tparam Word Unsigned word type; w is its width in bits.
+ * @tparam Rounds Number of rounds r (1-255).
+ */
+template<typename Word, unsigned Rounds = 20>
+class RC6T {
+    static_assert(std::is_same<Word, uint16_t>::value || std::is_same<Word, uint32_t>::value ||
+                  std::is_same<Word, uint64_t>::value, "Word must be uint16_t, uint32_t or uint64_t");
+    static_assert(Rounds >= 1 && Rounds <= 255, "Rounds must be between 1 and 255");
+
+public:
+    static constexpr unsigned WORD_BITS = 8 * sizeof(Word); //!< Word size w in bits
+    static constexpr unsigned LG_W = WORD_BITS == 16 ? 4 : WORD_BITS == 32 ? 5 : 6; //!< Base-two logarithm of w
+    static constexpr size_t BLOCK_SIZE = 4 * sizeof(Word); //!< Block size in bytes
+    static constexpr unsigned ROUNDS = Rounds; //!< Number of rounds r
+    static constexpr uint16_t MAX_KEY_BITS = 2048; //!< Largest supported key length in bits
+
+    /**
+     * @brief Magic constant P_w = Odd((e - 2) * 2^w).
+     *
+     * The constants of every word size are leading bits of the 64-bit ones,
+     * made odd; this gives 0xB7E1, 0xB7E15163 and 0xB7E151628AED2A6B.
+     */
+    static constexpr Word P = static_cast<Word>(0xB7E151628AED2A6BULL >> (64 - WORD_BITS)) | 1;
+
+    /**
+     * @brief Magic constant Q_w = Odd((phi - 1) * 2^w).
+     *
+     * Gives 0x9E37, 0x9E3779B9 and 0x9E3779B97F4A7C15.
+     */
+    static constexpr Word Q = static_cast<Word>(0x9E3779B97F4A7C15ULL >> (64 - WORD_BITS)) | 1;
+
+private:
+    static constexpr size_t KEY_SIZE = 2 * Rounds + 4; //!< Number of round keys
+    static constexpr size_t WIDE_GROUP = 2; //!< Blocks interleaved by bulk calls
+
+    // Word arithmetic in at least unsigned int, so that uint16_t never promotes to int
+    typedef decltype(Word() + 0u) Arith;
+
+    Word round_keys_[KEY_SIZE]; //!< The round keys
+    bool initialized_; //!< Whether a key has been set
+
+    /**
+     * @brief Rotate left by the low lg(w) bits of n, without undefined shifts.
+     */
+    static Word rotateLeft(Word x, Arith n) noexcept;
+
+    /**
+     * @brief Rotate right by the low lg(w) bits of n, without undefined shifts.
+     */
+    static Word rotateRight(Word x, Arith n) noexcept;
+
+    /**
+     * @brief Round function f(x) = (x * (2x + 1)) <<< lg(w).
+     */
+    static Word mix(Word x) noexcept;
+
+    /**
+     * @brief Load a little-endian word from any address.
+     */
+    static Word loadWord(const uint8_t *p) noexcept;
+
+    /**
+     * @brief Store a word in little-endian order to any address.
+     */
+    static void storeWord(uint8_t *p, Word w) noexcept;
+
+    /**
+     * @brief Encrypt N consecutive blocks with their rounds interleaved.
+     */
+    template<size_t N>
+    void encryptGroup(const uint8_t *in, uint8_t *out) const noexcept;
+
+    /**
+     * @brief Decrypt N consecutive blocks with their rounds interleaved.
+     */
+    template<size_t N>
+    void decryptGroup(const uint8_t *in, uint8_t *out) const noexcept;
+
+public:
+    /**
+     * @brief Default constructor.
+     *
+     * Creates an uninitialized cipher.
+     */
+    RC6T() noexcept;
+
+    /**
+     * @brief Destructor.
+     *
+     * Wipes the round keys.
+     */
+    ~RC6T();
+
+    /**
+     * @brief Copy constructor (deleted).
+     *
+     * Copy constructor is deleted to prevent key leakage.
+     */
+    RC6T(const RC6T &) = delete;
+
+    /**
+     * @brief Copy assignment operator (deleted).
+     *
+     * Copy assignment operator is deleted to prevent key leakage.
+     * @return Reference to this object.
+     */
+    RC6T &operator=(const RC6T &) = delete;
+
+    /**
+     * @brief Move constructor.
+     *
+     * The moved-from object is wiped and left uninitialized.
+     */
+    RC6T(RC6T &&other) noexcept;
+
+    /**
+     * @brief Move assignment operator.
+     *
+     * The previous round keys of this object are wiped first; the moved-from
+     * object is wiped and left uninitialized.
+     * @return Reference to this object.
+     */
+    RC6T &operator=(RC6T &&other) noexcept;
+
+    /**
+     * @brief Initialize the cipher with a key.
+     *
+     * The key is read as ceil(keylength_bits / w) little-endian words, like
+     * RC6::init().
+     *
+     * @param key Pointer to the key data.
+     * @param keylength_bits Length of the key in bits.
+     * @throws std::invalid_argument if key is null or keylength_bits is zero.
+     * @throws std::invalid_argument if keylength_bits is greater than 2048.
+     */
+    void init(const void *key, uint16_t keylength_bits);
+
+    /**
+     * @brief Encrypt a block of data.
+     * @param block Pointer to the BLOCK_SIZE-byte block to encrypt.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if block is null.
+     */
+    void encrypt(void *block) const;
+
+    /**
+     * @brief Decrypt a block of data.
+     * @param block Pointer to the BLOCK_SIZE-byte block to decrypt.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if block is null.
+     */
+    void decrypt(void *block) const;
+
+    /**
+     * @brief Encrypt multiple consecutive blocks in place.
+     * @param blocks Pointer to nblocks * BLOCK_SIZE bytes of data.
+     * @param nblocks Number of blocks to encrypt.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if blocks is null and nblocks is non-zero.
+     */
+    void encryptBlocks(void *blocks, size_t nblocks) const;
+
+    /**
+     * @brief Encrypt multiple consecutive blocks out of place.
+     * @param in Pointer to nblocks * BLOCK_SIZE bytes of plaintext.
+     * @param out Pointer to nblocks * BLOCK_SIZE bytes of output. Must either
+     *            equal in or not overlap it.
+     * @param nblocks Number of blocks to encrypt.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+     */
+    void encryptBlocks(const void *in, void *out, size_t nblocks) const;
+
+    /**
+     * @brief Decrypt multiple consecutive blocks in place.
+     * @param blocks Pointer to nblocks * BLOCK_SIZE bytes of data.
+     * @param nblocks Number of blocks to decrypt.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if blocks is null and nblocks is non-zero.
+     */
+    void decryptBlocks(void *blocks, size_t nblocks) const;
+
+    /**
+     * @brief Decrypt multiple consecutive blocks out of place.
+     * @param in Pointer to nblocks * BLOCK_SIZE bytes of ciphertext.
+     * @param out Pointer to nblocks * BLOCK_SIZE bytes of output. Must either
+     *            equal in or not overlap it.
+     * @param nblocks Number of blocks to decrypt.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+     */
+    void decryptBlocks(const void *in, void *out, size_t nblocks) const;
+
+    /**
+     * @brief Wipe the round keys and return to the uninitialized state.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Check if the cipher is initialized.
+     * @return True if the cipher is initialized, false otherwise.
+     */
+    bool isInitialized() const noexcept;
+};
+
+template<typename Word, unsigned Rounds>
+constexpr unsigned RC6T<Word, Rounds>::WORD_BITS;
+template<typename Word, unsigned Rounds>
+constexpr unsigned RC6T<Word, Rounds>::LG_W;
+template<typename Word, unsigned Rounds>
+constexpr size_t RC6T<Word, Rounds>::BLOCK_SIZE;
+template<typename Word, unsigned Rounds>
+constexpr unsigned RC6T<Word, Rounds>::ROUNDS;
+template<typename Word, unsigned Rounds>
+constexpr uint16_t RC6T<Word, Rounds>::MAX_KEY_BITS;
+template<typename Word, unsigned Rounds>
+constexpr Word RC6T<Word, Rounds>::P;
+template<typename Word, unsigned Rounds>
+constexpr Word RC6T<Word, Rounds>::Q;
+template<typename Word, unsigned Rounds>
+constexpr size_t RC6T<Word, Rounds>::KEY_SIZE;
+template<typename Word, unsigned Rounds>
+constexpr size_t RC6T<Word, Rounds>::WIDE_GROUP;
+
+template<typename Word, unsigned Rounds>
+RC6_ALWAYS_INLINE Word RC6T<Word, Rounds>::rotateLeft(const Word x, const Arith n) noexcept {
+    const unsigned s = static_cast<unsigned>(n & (WORD_BITS - 1));
+    return static_cast<Word>((static_cast<Arith>(x) << s) | (static_cast<Arith>(x) >> ((WORD_BITS - s) & (WORD_BITS - 1))));
+}
+
+template<typename Word, unsigned Rounds>
+RC6_ALWAYS_INLINE Word RC6T<Word, Rounds>::rotateRight(const Word x, const Arith n) noexcept {
+    const unsigned s = static_cast<unsigned>(n & (WORD_BITS - 1));
+    return static_cast<Word>((static_cast<Arith>(x) >> s) | (static_cast<Arith>(x) << ((WORD_BITS - s) & (WORD_BITS - 1))));
+}
+
+template<typename Word, unsigned Rounds>
+RC6_ALWAYS_INLINE Word RC6T<Word, Rounds>::mix(const Word x) noexcept {
+    const Arith a = x;
+    return rotateLeft(static_cast<Word>(a * (2 * a + 1)), LG_W);
+}
+
+template<typename Word, unsigned Rounds>
+RC6_ALWAYS_INLINE Word RC6T<Word, Rounds>::loadWord(const uint8_t *p) noexcept {
+    // Compilers merge the byte loads into one load, plus a swap on big-endian targets
+    Word w = 0;
+    for (size_t i = 0; i < sizeof(Word); ++i) {
+        w = static_cast<Word>(w | static_cast<Word>(static_cast<Word>(p[i]) << (8 * i)));
+    }
+    return w;
+}
+
+template<typename Word, unsigned Rounds>
+RC6_ALWAYS_INLINE void RC6T<Word, Rounds>::storeWord(uint8_t *p, const Word w) noexcept {
+    for (size_t i = 0; i < sizeof(Word); ++i) {
+        p[i] = static_cast<uint8_t>(w >> (8 * i));
+    }
+}
+
+template<typename Word, unsigned Rounds>
+template<size_t N>
+RC6_ALWAYS_INLINE void RC6T<Word, Rounds>::encryptGroup(const uint8_t *in, uint8_t *out) const noexcept {
+    const size_t u = sizeof(Word);
+    Word a[N], b[N], c[N], d[N];
+    for (size_t g = 0; g < N; ++g) {
+        a[g] = loadWord(in + BLOCK_SIZE * g);
+        b[g] = static_cast<Word>(loadWord(in + BLOCK_SIZE * g + u) + round_keys_[0]);
+        c[g] = loadWord(in + BLOCK_SIZE * g + 2 * u);
+        d[g] = static_cast<Word>(loadWord(in + BLOCK_SIZE * g + 3 * u) + round_keys_[1]);
+    }
+
+    for (size_t i = 1; i <= Rounds; ++i) {
+        for (size_t g = 0; g < N; ++g) {
+            const Word t = mix(b[g]);
+            const Word v = mix(d[g]);
+            const Word na = static_cast<Word>(rotateLeft(static_cast<Word>(a[g] ^ t), v) + round_keys_[2 * i]);
+            const Word nc = static_cast<Word>(rotateLeft(static_cast<Word>(c[g] ^ v), t) + round_keys_[2 * i + 1]);
+            a[g] = b[g];
+            b[g] = nc;
+            c[g] = d[g];
+            d[g] = na;
+        }
+    }
+
+    for (size_t g = 0; g < N; ++g) {
+        storeWord(out + BLOCK_SIZE * g, static_cast<Word>(a[g] + round_keys_[2 * Rounds + 2]));
+        storeWord(out + BLOCK_SIZE * g + u, b[g]);
+        storeWord(out + BLOCK_SIZE * g + 2 * u, static_cast<Word>(c[g] + round_keys_[2 * Rounds + 3]));
+        storeWord(out + BLOCK_SIZE * g + 3 * u, d[g]);
+    }
+}
+
+template<typename Word, unsigned Rounds>
+template<size_t N>
+RC6_ALWAYS_INLINE void RC6T<Word, Rounds>::decryptGroup(const uint8_t *in, uint8_t *out) const noexcept {
+    const size_t u = sizeof(Word);
+    Word a[N], b[N], c[N], d[N];
+    for (size_t g = 0; g < N; ++g) {
+        a[g] = static_cast<Word>(loadWord(in + BLOCK_SIZE * g) - round_keys_[2 * Rounds + 2]);
+        b[g] = loadWord(in + BLOCK_SIZE * g + u);
+        c[g] = static_cast<Word>(loadWord(in + BLOCK_SIZE * g + 2 * u) - round_keys_[2 * Rounds + 3]);
+        d[g] = loadWord(in + BLOCK_SIZE * g + 3 * u);
+    }
+
+    for (size_t i = Rounds; i > 0; --i) {
+        for (size_t g = 0; g < N; ++g) {
+            const Word pa = d[g];
+            const Word pc = b[g];
+            b[g] = a[g];
+            d[g] = c[g];
+            const Word v = mix(d[g]);
+            const Word t = mix(b[g]);
+            c[g] = static_cast<Word>(rotateRight(static_cast<Word>(pc - round_keys_[2 * i + 1]), t) ^ v);
+            a[g] = static_cast<Word>(rotateRight(static_cast<Word>(pa - round_keys_[2 * i]), v) ^ t);
+        }
+    }
+
+    for (size_t g = 0; g < N; ++g) {
+        storeWord(out + BLOCK_SIZE * g, a[g]);
+        storeWord(out + BLOCK_SIZE * g + u, static_cast<Word>(b[g] - round_keys_[0]));
+        storeWord(out + BLOCK_SIZE * g + 2 * u, c[g]);
+        storeWord(out + BLOCK_SIZE * g + 3 * u, static_cast<Word>(d[g] - round_keys_[1]));
+    }
+}
+
+template<typename Word, unsigned Rounds>
+RC6T<Word, Rounds>::RC6T() noexcept : round_keys_(), initialized_(false) {
+}
+
+template<typename Word, unsigned Rounds>
+RC6T<Word, Rounds>::~RC6T() {
+    clear();
+}
+
+template<typename Word, unsigned Rounds>
+RC6T<Word, Rounds>::RC6T(RC6T &&other) noexcept : round_keys_(), initialized_(other.initialized_) {
+    std::memcpy(round_keys_, other.round_keys_, sizeof(round_keys_));
+    other.clear();
+}
+
+template<typename Word, unsigned Rounds>
+RC6T<Word, Rounds> &RC6T<Word, Rounds>::operator=(RC6T &&other) noexcept {
+    if (this != &other) {
+        std::memcpy(round_keys_, other.round_keys_, sizeof(round_keys_));
+        initialized_ = other.initialized_;
+        other.clear();
+    }
+    return *this;
+}
+
+template<typename Word, unsigned Rounds>
+void RC6T<Word, Rounds>::init(const void *key, const uint16_t keylength_bits) {
+    if (key == nullptr) {
+        throw std::invalid_argument("Key cannot be null");
+    }
+
+    if (keylength_bits == 0 || keylength_bits > MAX_KEY_BITS) {
+        throw std::invalid_argument("Key length must be between 1 and 2048 bits");
+    }
+
+    // Load the key as little-endian words; trailing bits of a partial byte are ignored, as in RC6
+    const auto *key_bytes = static_cast<const uint8_t *>(key);
+    Word key_words[MAX_KEY_BITS / 16];
+    const size_t c = (keylength_bits + WORD_BITS - 1) / WORD_BITS;
+    std::memset(key_words, 0, c * sizeof(Word));
+    for (size_t i = 0; i < keylength_bits / 8u; ++i) {
+        key_words[i / sizeof(Word)] = static_cast<Word>(
+            key_words[i / sizeof(Word)] | static_cast<Word>(static_cast<Word>(key_bytes[i]) << (8 * (i % sizeof(Word)))));
+    }
+
+    round_keys_[0] = P;
+    for (size_t i = 1; i < KEY_SIZE; ++i) {
+        round_keys_[i] = static_cast<Word>(round_keys_[i - 1] + Q);
+    }
+
+    Word a = 0, b = 0;
+    size_t i = 0, j = 0;
+    const size_t v = 3 * (c > KEY_SIZE ? c : KEY_SIZE);
+    for (size_t s = 0; s < v; ++s) {
+        a = round_keys_[i] = rotateLeft(static_cast<Word>(round_keys_[i] + a + b), 3);
+        b = key_words[j] = rotateLeft(static_cast<Word>(key_words[j] + a + b), static_cast<Arith>(a + b));
+        if (++i == KEY_SIZE) {
+            i = 0;
+        }
+        if (++j == c) {
+            j = 0;
+        }
+    }
+
+    rc6_detail::secureZero(key_words, c * sizeof(Word));
+    initialized_ = true;
+}
+
+template<typename Word, unsigned Rounds>
+void RC6T<Word, Rounds>::encrypt(void *block) const {
+    encryptBlocks(block, block, 1);
+}
+
+template<typename Word, unsigned Rounds>
+void RC6T<Word, Rounds>::decrypt(void *block) const {
+    decryptBlocks(block, block, 1);
+}
+
+template<typename Word, unsigned Rounds>
+void RC6T<Word, Rounds>::encryptBlocks(void *blocks, const size_t nblocks) const {
+    encryptBlocks(blocks, blocks, nblocks);
+}
+
+template<typename Word, unsigned Rounds>
+void RC6T<Word, Rounds>::encryptBlocks(const void *in, void *out, const size_t nblocks) const {
+    if (!initialized_) {
+        throw std::runtime_error("RC6 not initialized");
+    }
+
+    if (nblocks == 0) {
+        return;
+    }
+
+    if (in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    size_t n = 0;
+    for (; n + WIDE_GROUP <= nblocks; n += WIDE_GROUP) {
+        encryptGroup<WIDE_GROUP>(src + BLOCK_SIZE * n, dst + BLOCK_SIZE * n);
+    }
+    for (; n < nblocks; ++n) {
+        encryptGroup<1>(src + BLOCK_SIZE * n, dst + BLOCK_SIZE * n);
+    }
+}
+
+template<typename Word, unsigned Rounds>
+void RC6T<Word, Rounds>::decryptBlocks(void *blocks, const size_t nblocks) const {
+    decryptBlocks(blocks, blocks, nblocks);
+}
+
+template<typename Word, unsigned Rounds>
+void RC6T<Word, Rounds>::decryptBlocks(const void *in, void *out, const size_t nblocks) const {
+    if (!initialized_) {
+        throw std::runtime_error("RC6 not initialized");
+    }
+
+    if (nblocks == 0) {
+        return;
+    }
+
+    if (in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    size_t n = 0;
+    for (; n + WIDE_GROUP <= nblocks; n += WIDE_GROUP) {
+        decryptGroup<WIDE_GROUP>(src + BLOCK_SIZE * n, dst + BLOCK_SIZE * n);
+    }
+    for (; n < nblocks; ++n) {
+        decryptGroup<1>(src + BLOCK_SIZE * n, dst + BLOCK_SIZE * n);
+    }
+}
+
+template<typename Word, unsigned Rounds>
+void RC6T<Word, Rounds>::clear() noexcept {
+    rc6_detail::secureZero(round_keys_, sizeof(round_keys_));
+    initialized_ = false;
+}
+
+template<typename Word, unsigned Rounds>
+bool RC6T<Word, Rounds>::isInitialized() const noexcept {
+    return initialized_;
+}
+
+#endif /* RC6_GENERIC_HPP_ */
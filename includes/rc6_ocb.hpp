@@ -0,0 +1,129 @@
+/**
+ * @file rc6_ocb.hpp
+ * @brief Header file for RC6 in OCB authenticated encryption mode.
+ *
+ * This file provides OCB3 as specified in RFC 7253 on top of the RC6 block
+ * cipher. OCB encrypts and authenticates in a single pass: each batch of
+ * blocks is whitened with its offsets, run through the bulk kernels and
+ * folded into the checksum while it is still in cache.
+ */
+#ifndef RC6_OCB_HPP_
+#define RC6_OCB_HPP_
+
+#include <cstdint>
+#include <cstddef>
+
+#include "rc6.hpp"
+
+/**
+ * @class RC6OCB
+ * @brief RC6 in OCB3 mode (RFC 7253).
+ *
+ * Each message needs a nonce that is never reused with the same key. Every
+ * call is independent, so one object can be shared by several threads.
+ * The referenced RC6 object must stay alive and keyed for the lifetime of
+ * this object.
+ */
+class RC6OCB {
+public:
+    static constexpr size_t BLOCK_SIZE = 16; //!< RC6 block size in bytes
+    static constexpr size_t MAX_NONCE_SIZE = 15; //!< Longest nonce in bytes (120 bits)
+    static constexpr size_t MAX_TAG_SIZE = 16; //!< Longest tag in bytes
+
+private:
+    static constexpr size_t BATCH_BLOCKS = 64; //!< Blocks processed per bulk call
+    static constexpr size_t L_COUNT = 64; //!< Number of precomputed L_i values
+
+    const RC6 &cipher_; //!< The keyed block cipher
+    size_t tag_size_; //!< Tag length in bytes
+    uint8_t l_star_[BLOCK_SIZE]; //!< L_* = E(0)
+    uint8_t l_dollar_[BLOCK_SIZE]; //!< L_$ = double(L_*)
+    uint8_t l_[L_COUNT][BLOCK_SIZE]; //!< L_i = double^(i+1)(L_*)
+
+    /**
+     * @brief Derive Offset_0 from the nonce.
+     * @param nonce Pointer to the nonce.
+     * @param nonce_len Nonce length in bytes.
+     * @param offset Pointer to the 16-byte output.
+     */
+    void initialOffset(const uint8_t *nonce, size_t nonce_len, uint8_t *offset) const;
+
+    /**
+     * @brief Compute the associated data hash HASH(K, A).
+     * @param ad Pointer to the associated data.
+     * @param ad_len Associated data length in bytes.
+     * @param sum Pointer to the 16-byte output.
+     */
+    void hash(const uint8_t *ad, size_t ad_len, uint8_t *sum) const;
+
+    /**
+     * @brief Compute the offsets of the next blocks.
+     * @param offset Current offset, advanced to the last block's offset.
+     * @param index Index of the last block done, advanced by count.
+     * @param offsets Output, count * 16 bytes.
+     * @param count Number of blocks.
+     */
+    void nextOffsets(uint8_t *offset, uint64_t &index, uint8_t *offsets, size_t count) const;
+
+    /**
+     * @brief Encrypt or decrypt the message and compute the final tag block.
+     */
+    void crypt(bool encrypting, const void *nonce, size_t nonce_len, const void *ad, size_t ad_len,
+               const void *in, size_t len, void *out, uint8_t *tag) const;
+
+public:
+    /**
+     * @brief Constructor.
+     * @param cipher Initialized RC6 object.
+     * @param tag_size Tag length in bytes (1 to 16, default: 16).
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if tag_size is out of range.
+     */
+    explicit RC6OCB(const RC6 &cipher, size_t tag_size = MAX_TAG_SIZE);
+
+    /**
+     * @brief Destructor.
+     *
+     * Wipes the key-derived L values.
+     */
+    ~RC6OCB();
+
+    /**
+     * @brief Encrypt and authenticate a message.
+     * @param nonce Pointer to the nonce.
+     * @param nonce_len Nonce length in bytes (1 to 15).
+     * @param ad Pointer to the associated data (may be null if ad_len is zero).
+     * @param ad_len Associated data length in bytes.
+     * @param in Pointer to the plaintext (may be null if len is zero).
+     * @param len Message length in bytes.
+     * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+     * @param tag Pointer to the tag output (tagSize() bytes).
+     * @throws std::invalid_argument if a required pointer is null or nonce_len is out of range.
+     */
+    void encrypt(const void *nonce, size_t nonce_len, const void *ad, size_t ad_len,
+                 const void *in, size_t len, void *out, void *tag) const;
+
+    /**
+     * @brief Decrypt a message and verify its tag.
+     * @param nonce Pointer to the nonce.
+     * @param nonce_len Nonce length in bytes (1 to 15).
+     * @param ad Pointer to the associated data (may be null if ad_len is zero).
+     * @param ad_len Associated data length in bytes.
+     * @param in Pointer to the ciphertext (may be null if len is zero).
+     * @param len Message length in bytes.
+     * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+     * @param tag Pointer to the tag to verify (tagSize() bytes).
+     * @return True if the tag is valid; otherwise out is zeroed and false is returned.
+     * @throws std::invalid_argument if a required pointer is null or nonce_len is out of range.
+     */
+    bool decrypt(const void *nonce, size_t nonce_len, const void *ad, size_t ad_len,
+                 const void *in, size_t len, void *out, const void *tag) const;
+
+    /**
+     * @brief Get the tag length.
+     * @return Tag length in bytes.
+     */
+    size_t tagSize() const;
+};
+
+#endif /* RC6_OCB_HPP_ */
@@ -0,0 +1,211 @@
+/**
+ * @file rc6_parallel.hpp
+ * @brief Header file for the multithreaded RC6 bulk engine.
+ *
+ * This file provides a worker pool that splits large buffers into chunks
+ * and processes them concurrently. Only modes whose blocks are independent
+ * are offered: ECB, CTR and CBC decryption.
+ */
+#ifndef RC6_PARALLEL_HPP_
+#define RC6_PARALLEL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rc6.hpp"
+#include "rc6_ctr.hpp"
+
+/**
+ * @class RC6Parallel
+ * @brief Worker pool for parallel bulk encryption.
+ *
+ * Each call splits its buffer into fixed-size chunks and publishes one
+ * ticket per helper it wants on a lock-free ring. A worker that takes a
+ * ticket claims chunks of that call from a shared counter until none are
+ * left, so idle threads steal whatever remains and no chunk is assigned
+ * in advance. The calling thread claims chunks too, so a pool created with
+ * one thread runs everything inline. Idle threads spin for a short while
+ * before parking, which keeps hand-off latency low for back-to-back calls
+ * on mid-sized buffers; an oversubscribed pool parks at once. Cipher objects are only read, so one RC6 instance
+ * can be shared by all workers.
+ *
+ * The engine itself is thread-safe: several threads may submit work at the
+ * same time.
+ */
+class RC6Parallel {
+    static constexpr size_t BLOCK_SIZE = 16; //!< RC6 block size in bytes
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 16 * 1024; //!< Default chunk size
+    static constexpr size_t RING_SIZE = 256; //!< Ticket ring capacity, a power of two
+    static constexpr size_t SPIN_LIMIT = 4096; //!< Empty polls before a thread parks
+    static constexpr size_t CACHE_LINE = 64; //!< Assumed cache line size
+
+    /**
+     * @brief State of one parallel call, shared by its tickets.
+     */
+    struct Call {
+        const std::function<void(size_t)> *body; //!< Chunk function of the call
+        size_t count; //!< Number of chunks
+        std::atomic<size_t> next; //!< Next chunk to claim
+        std::atomic<size_t> remaining; //!< Chunks not yet finished
+        std::atomic<size_t> refs; //!< Caller plus unreleased tickets
+        std::atomic<bool> parked; //!< Set when the caller sleeps on done_cv_
+    };
+
+    /**
+     * @brief One slot of the ticket ring (bounded MPMC queue).
+     */
+    struct Cell {
+        std::atomic<size_t> sequence; //!< Position the slot is ready for
+        Call *call; //!< Ticket stored in the slot
+    };
+
+    size_t chunk_bytes_; //!< Chunk size in bytes (multiple of 16)
+    size_t spin_limit_; //!< SPIN_LIMIT, or 0 when threads outnumber CPUs
+    std::vector<std::thread> workers_; //!< Worker threads
+    std::unique_ptr<Cell[]> ring_; //!< Ticket ring
+    std::atomic<size_t> enqueue_pos_; //!< Next ring position to fill
+    char pad0_[CACHE_LINE]; //!< Keeps the two positions on separate lines
+    std::atomic<size_t> dequeue_pos_; //!< Next ring position to take
+    char pad1_[CACHE_LINE]; //!< Keeps the positions apart from the rest
+    std::atomic<size_t> sleepers_; //!< Workers parked or about to park
+    std::atomic<bool> stopping_; //!< Set when the pool shuts down
+    std::mutex mutex_; //!< Only used to park and wake threads
+    std::condition_variable work_cv_; //!< Wakes parked workers
+    std::condition_variable done_cv_; //!< Wakes parked callers
+
+    /**
+     * @brief Add a ticket to the ring.
+     * @param call The call.
+     * @return False if the ring is full.
+     */
+    bool push(Call *call);
+
+    /**
+     * @brief Take a ticket from the ring.
+     * @return The ticket's call, or null if the ring is empty.
+     */
+    Call *pop();
+
+    /**
+     * @brief Claim and run chunks of a call until none are left.
+     * @param call The call.
+     */
+    void help(Call *call);
+
+    /**
+     * @brief Drop one reference to a call, freeing it with the last one.
+     * @param call The call.
+     */
+    static void release(Call *call);
+
+    /**
+     * @brief Worker thread main loop.
+     * @param index Worker number, used for pinning.
+     * @param pin Pin the worker to one CPU.
+     */
+    void workerLoop(size_t index, bool pin);
+
+    /**
+     * @brief Run body(0) .. body(count - 1) on the pool and wait for completion.
+     * @param count Number of chunks.
+     * @param body Chunk function.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)> &body);
+
+public:
+    /**
+     * @brief Constructor.
+     * @param threads Total number of threads including the caller; 0 uses
+     *                the number of hardware threads.
+     * @param chunk_bytes Amount of data per task; rounded up to a multiple of
+     *                    16 (default: 16 KiB).
+     * @param pin_threads Pin worker i to the i-th CPU the process may run on
+     *                    (Linux only; ignored elsewhere).
+     * @throws std::invalid_argument if chunk_bytes is zero or too large to round up.
+     */
+    explicit RC6Parallel(size_t threads = 0, size_t chunk_bytes = DEFAULT_CHUNK_BYTES, bool pin_threads = false);
+
+    /**
+     * @brief Destructor.
+     *
+     * Waits for the worker threads to exit.
+     */
+    ~RC6Parallel();
+
+    /**
+     * @brief Copy constructor (deleted).
+     */
+    RC6Parallel(const RC6Parallel &) = delete;
+
+    /**
+     * @brief Copy assignment operator (deleted).
+     * @return Reference to this object.
+     */
+    RC6Parallel &operator=(const RC6Parallel &) = delete;
+
+    /**
+     * @brief Get the number of threads used, including the caller.
+     * @return Thread count.
+     */
+    size_t threadCount() const;
+
+    /**
+     * @brief Get the chunk size.
+     * @return Bytes per task.
+     */
+    size_t chunkBytes() const;
+
+    /**
+     * @brief Encrypt consecutive blocks independently (ECB).
+     * @param cipher Initialized RC6 object.
+     * @param in Pointer to nblocks * 16 bytes of plaintext.
+     * @param out Pointer to the output. Must either equal in or not overlap it.
+     * @param nblocks Number of blocks.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+     */
+    void encryptECB(const RC6 &cipher, const void *in, void *out, size_t nblocks);
+
+    /**
+     * @brief Decrypt consecutive blocks independently (ECB).
+     * @param cipher Initialized RC6 object.
+     * @param in Pointer to nblocks * 16 bytes of ciphertext.
+     * @param out Pointer to the output. Must either equal in or not overlap it.
+     * @param nblocks Number of blocks.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+     */
+    void decryptECB(const RC6 &cipher, const void *in, void *out, size_t nblocks);
+
+    /**
+     * @brief Encrypt or decrypt data in counter mode.
+     * @param ctr Counter mode context; its position is not used or changed.
+     * @param offset Byte offset of the data within the message.
+     * @param in Pointer to the input data.
+     * @param out Pointer to the output. Must either equal in or not overlap it.
+     * @param len Number of bytes.
+     * @throws std::invalid_argument if in or out is null and len is non-zero.
+     */
+    void processCTR(const RC6CTR &ctr, uint64_t offset, const void *in, void *out, size_t len);
+
+    /**
+     * @brief Decrypt a CBC message.
+     * @param cipher Initialized RC6 object.
+     * @param iv Pointer to the 16-byte IV.
+     * @param in Pointer to nblocks * 16 bytes of ciphertext.
+     * @param out Pointer to the output. Must either equal in or not overlap it.
+     * @param nblocks Number of blocks.
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if iv, in or out is null and nblocks is non-zero.
+     */
+    void decryptCBC(const RC6 &cipher, const void *iv, const void *in, void *out, size_t nblocks);
+};
+
+#endif /* RC6_PARALLEL_HPP_ */
@@ -0,0 +1,213 @@
+/**
+ * @file rc6_schedule.hpp
+ * @brief Header file for key schedules laid out for the vector kernels.
+ *
+ * RC6 keeps its round keys as one flat array, so a bulk kernel broadcasts
+ * each key word into a vector every round. This file provides a second,
+ * precomputed layout: the round keys transposed into one aligned vector per
+ * key word, one lane per block of a group. Built from one cipher it holds
+ * the schedule already broadcast; built from several it gives each lane its
+ * own key, so the kernels read key material with plain aligned loads and no
+ * shuffles or gathers.
+ */
+#ifndef RC6_SCHEDULE_HPP_
+#define RC6_SCHEDULE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "rc6.hpp"
+
+namespace rc6_kernels {
+    struct Backend;
+}
+
+/**
+ * @class RC6Schedule
+ * @brief Round keys of one or more ciphers, transposed for the bulk kernels.
+ *
+ * The layout is built for the widest backend in use at init time and keeps
+ * using that backend afterwards. With count ciphers, block i of a call is
+ * processed with ciphers[i % count]; count must divide lanes(), so that
+ * every lane always holds the same key. Blocks that do not fill a group are
+ * processed one at a time with the same keys.
+ *
+ * The table is allocated once per init, wiped on destruction, move and
+ * clear(), and independent of the ciphers it was built from.
+ */
+class RC6Schedule {
+    const rc6_kernels::Backend *backend_; //!< Backend the layout is built for
+    uint8_t rounds_; //!< Number of rounds of every cipher
+    size_t words_; //!< Table size in words, (2 * rounds + 4) * lanes
+    std::unique_ptr<uint32_t[]> storage_; //!< Table allocation, with room for alignment
+    uint32_t *lane_keys_; //!< Aligned word-major table inside storage_
+
+    /**
+     * @brief Copy the round keys of one lane out of the table.
+     * @param lane Lane index as used by the backend.
+     * @param round_keys Output array of 2 * rounds + 4 words.
+     */
+    void laneSchedule(size_t lane, uint32_t *round_keys) const noexcept;
+
+public:
+    /**
+     * @brief Default constructor.
+     *
+     * Creates an uninitialized schedule.
+     */
+    RC6Schedule() noexcept;
+
+    /**
+     * @brief Construct the broadcast layout of one cipher.
+     * @param cipher Initialized cipher.
+     * @throws std::runtime_error if the cipher is not initialized.
+     */
+    explicit RC6Schedule(const RC6 &cipher);
+
+    /**
+     * @brief Construct a layout with one cipher per lane.
+     * @param ciphers Array of count cipher pointers.
+     * @param count Number of ciphers; must divide lanes().
+     * @throws std::invalid_argument if ciphers or any cipher is null, count
+     *         does not divide the lane count, or the round counts differ.
+     * @throws std::runtime_error if a cipher is not initialized.
+     */
+    RC6Schedule(const RC6 *const *ciphers, size_t count);
+
+    /**
+     * @brief Destructor.
+     *
+     * Wipes the table.
+     */
+    ~RC6Schedule();
+
+    /**
+     * @brief Copy constructor (deleted).
+     *
+     * Copy constructor is deleted to prevent key leakage.
+     */
+    RC6Schedule(const RC6Schedule &) = delete;
+
+    /**
+     * @brief Copy assignment operator (deleted).
+     *
+     * Copy assignment operator is deleted to prevent key leakage.
+     * @return Reference to this object.
+     */
+    RC6Schedule &operator=(const RC6Schedule &) = delete;
+
+    /**
+     * @brief Move constructor.
+     *
+     * The moved-from object is left uninitialized.
+     */
+    RC6Schedule(RC6Schedule &&other) noexcept;
+
+    /**
+     * @brief Move assignment operator.
+     *
+     * The previous table of this object is wiped first; the moved-from
+     * object is left uninitialized.
+     * @return Reference to this object.
+     */
+    RC6Schedule &operator=(RC6Schedule &&other) noexcept;
+
+    /**
+     * @brief Build the broadcast layout of one cipher.
+     * @param cipher Initialized cipher.
+     * @throws std::runtime_error if the cipher is not initialized.
+     */
+    void init(const RC6 &cipher);
+
+    /**
+     * @brief Build a layout with one cipher per lane.
+     *
+     * Lane k holds ciphers[k % count].
+     *
+     * @param ciphers Array of count cipher pointers.
+     * @param count Number of ciphers; must divide lanes().
+     * @throws std::invalid_argument if ciphers or any cipher is null, count
+     *         does not divide the lane count, or the round counts differ.
+     * @throws std::runtime_error if a cipher is not initialized.
+     */
+    void initMany(const RC6 *const *ciphers, size_t count);
+
+    /**
+     * @brief Encrypt multiple consecutive blocks in place.
+     * @param blocks Pointer to nblocks * 16 bytes of data.
+     * @param nblocks Number of 16-byte blocks to encrypt.
+     * @throws std::runtime_error if the schedule is not initialized.
+     * @throws std::invalid_argument if blocks is null and nblocks is non-zero.
+     */
+    void encryptBlocks(void *blocks, size_t nblocks) const;
+
+    /**
+     * @brief Encrypt multiple consecutive blocks out of place.
+     * @param in Pointer to nblocks * 16 bytes of plaintext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to encrypt.
+     * @throws std::runtime_error if the schedule is not initialized.
+     * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+     */
+    void encryptBlocks(const void *in, void *out, size_t nblocks) const;
+
+    /**
+     * @brief Decrypt multiple consecutive blocks in place.
+     * @param blocks Pointer to nblocks * 16 bytes of data.
+     * @param nblocks Number of 16-byte blocks to decrypt.
+     * @throws std::runtime_error if the schedule is not initialized.
+     * @throws std::invalid_argument if blocks is null and nblocks is non-zero.
+     */
+    void decryptBlocks(void *blocks, size_t nblocks) const;
+
+    /**
+     * @brief Decrypt multiple consecutive blocks out of place.
+     * @param in Pointer to nblocks * 16 bytes of ciphertext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to decrypt.
+     * @throws std::runtime_error if the schedule is not initialized.
+     * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+     */
+    void decryptBlocks(const void *in, void *out, size_t nblocks) const;
+
+    /**
+     * @brief Encrypt multiple consecutive blocks without any checks.
+     * @param in Pointer to nblocks * 16 bytes of plaintext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to encrypt.
+     */
+    void encryptBlocksUnchecked(const void *in, void *out, size_t nblocks) const noexcept;
+
+    /**
+     * @brief Decrypt multiple consecutive blocks without any checks.
+     * @param in Pointer to nblocks * 16 bytes of ciphertext.
+     * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+     *            or not overlap it.
+     * @param nblocks Number of 16-byte blocks to decrypt.
+     */
+    void decryptBlocksUnchecked(const void *in, void *out, size_t nblocks) const noexcept;
+
+    /**
+     * @brief Get the number of lanes of the layout.
+     * @return Lane count of the backend the layout was built for, or of the
+     *         backend in use if the schedule is not initialized.
+     */
+    size_t lanes() const noexcept;
+
+    /**
+     * @brief Wipe the table and return to the uninitialized state.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Check if the schedule is initialized.
+     * @return True if a layout has been built.
+     */
+    bool isInitialized() const noexcept;
+};
+
+#endif /* RC6_SCHEDULE_HPP_ */
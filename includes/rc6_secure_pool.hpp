@@ -0,0 +1,152 @@
+/**
+ * @file rc6_secure_pool.hpp
+ * @brief Header file for the locked-memory pool of RC6 objects.
+ *
+ * This file provides an allocator that keeps keyed RC6 objects in pages
+ * locked into RAM, so their round keys are never written to swap and are
+ * left out of core dumps where the platform allows it. Pages are locked a
+ * slab at a time and recycled through a free list, so creating and
+ * destroying contexts costs no system call in the steady state.
+ */
+#ifndef RC6_SECURE_POOL_HPP_
+#define RC6_SECURE_POOL_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "rc6.hpp"
+
+/**
+ * @class RC6SecurePool
+ * @brief Thread-safe pool of RC6 objects in locked memory.
+ *
+ * Objects are handed out as unique handles that return their slot to the
+ * pool on destruction. RC6 wipes its round keys when destroyed, so a slot
+ * never holds key material while it is free. Every handle must be released
+ * before the pool is destroyed.
+ *
+ * Locking is best effort: if the process has reached its locked-memory
+ * limit (RLIMIT_MEMLOCK on POSIX), slabs are still used unlocked and
+ * isLocked() reports false.
+ */
+class RC6SecurePool {
+public:
+    /**
+     * @brief Returns an object to the pool it came from.
+     */
+    class Deleter {
+        RC6SecurePool *pool_; //!< Owning pool
+
+    public:
+        /**
+         * @brief Constructor.
+         * @param pool Owning pool.
+         */
+        explicit Deleter(RC6SecurePool *pool = nullptr);
+
+        /**
+         * @brief Destroy an object and return its slot.
+         * @param cipher The object.
+         */
+        void operator()(RC6 *cipher) const;
+    };
+
+    typedef std::unique_ptr<RC6, Deleter> Handle; //!< Owning handle to a pooled object
+
+private:
+    static constexpr size_t DEFAULT_SLAB_OBJECTS = 256; //!< Default slots per slab
+
+    /**
+     * @brief One locked allocation of slots.
+     */
+    struct Slab {
+        void *memory; //!< Start of the pages
+        size_t bytes; //!< Size in bytes, a multiple of the page size
+        bool locked; //!< Whether the pages are locked
+    };
+
+    size_t slot_bytes_; //!< Bytes per slot, a multiple of the cache line size
+    size_t slab_bytes_; //!< Bytes per slab
+    mutable std::mutex mutex_; //!< Protects the members below
+    std::vector<Slab> slabs_; //!< All slabs
+    void *free_list_; //!< First free slot; each free slot stores the next one
+    size_t live_; //!< Number of objects handed out
+
+    /**
+     * @brief Take a free slot, adding a slab if none is left.
+     * @return Pointer to the slot.
+     * @throws std::bad_alloc if the pages cannot be allocated.
+     */
+    void *acquire();
+
+    /**
+     * @brief Return a slot to the free list.
+     * @param slot Pointer to the slot.
+     */
+    void release(void *slot);
+
+public:
+    /**
+     * @brief Constructor.
+     *
+     * No memory is allocated until the first object is created.
+     *
+     * @param slab_objects Number of slots allocated and locked at once (default: 256).
+     * @throws std::invalid_argument if slab_objects is zero.
+     */
+    explicit RC6SecurePool(size_t slab_objects = DEFAULT_SLAB_OBJECTS);
+
+    /**
+     * @brief Destructor.
+     *
+     * Wipes, unlocks and frees all slabs.
+     */
+    ~RC6SecurePool();
+
+    RC6SecurePool(const RC6SecurePool &) = delete;
+
+    RC6SecurePool &operator=(const RC6SecurePool &) = delete;
+
+    /**
+     * @brief Create an uninitialized object.
+     * @param rounds The number of rounds to use (1-125, default: 20).
+     * @return Handle to the object.
+     * @throws std::invalid_argument if rounds is greater than 125.
+     * @throws std::bad_alloc if the pages cannot be allocated.
+     */
+    Handle create(uint8_t rounds = 20);
+
+    /**
+     * @brief Create an object and initialize it with a key.
+     * @param key Pointer to the key data.
+     * @param keylength_bits Length of the key in bits.
+     * @param rounds The number of rounds to use (1-125, default: 20).
+     * @return Handle to the keyed object.
+     * @throws std::invalid_argument if the key or rounds are invalid, as for RC6::init().
+     * @throws std::bad_alloc if the pages cannot be allocated.
+     */
+    Handle create(const void *key, uint16_t keylength_bits, uint8_t rounds = 20);
+
+    /**
+     * @brief Get the number of objects currently handed out.
+     * @return Live object count.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the number of slots allocated so far.
+     * @return Slot count.
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Check whether all allocated slabs are locked in memory.
+     * @return True if every slab is locked (or none is allocated yet).
+     */
+    bool isLocked() const;
+};
+
+#endif /* RC6_SECURE_POOL_HPP_ */
@@ -0,0 +1,74 @@
+/**
+ * @file rc6_stats.hpp
+ * @brief Header file for the RC6 usage counters.
+ *
+ * This file provides read access to the optional instrumentation of the
+ * library: keys expanded, bulk calls and blocks, a histogram of blocks per
+ * call and the blocks processed by each kernel backend. The counters are
+ * compiled in only when the library is built with RC6_ENABLE_STATS (CMake
+ * option of the same name); otherwise the hooks compile to nothing and
+ * every snapshot is zero.
+ */
+#ifndef RC6_STATS_HPP_
+#define RC6_STATS_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <string>
+
+/**
+ * @struct RC6Stats
+ * @brief Usage counters summed over all threads.
+ *
+ * Bulk calls include those made internally by the modes of operation, so
+ * a tiny CTR or OCB message shows up as a call with few blocks. The inline
+ * single-block encrypt() and decrypt() are not counted.
+ */
+struct RC6Stats {
+    static constexpr size_t SIZE_BUCKETS = 12; //!< Buckets of the blocks-per-call histogram
+
+    uint64_t keys_expanded; //!< Key schedules computed by init(), tryInit() and initMany()
+    uint64_t encrypt_calls; //!< Bulk encryption calls
+    uint64_t encrypt_blocks; //!< Blocks encrypted by bulk calls
+    uint64_t decrypt_calls; //!< Bulk decryption calls
+    uint64_t decrypt_blocks; //!< Blocks decrypted by bulk calls
+
+    /**
+     * @brief Bulk calls by size: bucket i counts calls of [2^i, 2^(i+1))
+     *        blocks, the last bucket everything larger. Empty calls are in bucket 0.
+     */
+    uint64_t calls_by_blocks[SIZE_BUCKETS];
+
+    /**
+     * @brief Blocks per kernel backend, e.g. "avx2"; "single" counts tail
+     *        blocks processed one at a time.
+     */
+    std::map<std::string, uint64_t> blocks_by_backend;
+
+    /**
+     * @brief Check whether the counters are compiled in.
+     * @return True if the library was built with RC6_ENABLE_STATS.
+     */
+    static bool enabled();
+
+    /**
+     * @brief Sum the counters of all threads, including exited ones.
+     *
+     * Each counter is read atomically, but counters of a thread that is
+     * running a call may be mutually out of date by that call.
+     *
+     * @return Counts since the start of the process or the last reset().
+     */
+    static RC6Stats snapshot();
+
+    /**
+     * @brief Start counting from zero.
+     *
+     * Threads are not interrupted: the current totals become the baseline
+     * that later snapshots subtract.
+     */
+    static void reset();
+};
+
+#endif /* RC6_STATS_HPP_ */
@@ -0,0 +1,192 @@
+/**
+ * @file rc6_stream.hpp
+ * @brief Header file for the incremental RC6 stream context.
+ *
+ * This file provides a streaming interface over the CBC, CTR, CFB and OFB
+ * modes of operation. Data can be fed in chunks of any size; partial blocks
+ * are buffered internally and full runs of blocks go straight to the bulk
+ * block API. Data held in non-contiguous segments can be processed without
+ * first copying it into one buffer.
+ */
+#ifndef RC6_STREAM_HPP_
+#define RC6_STREAM_HPP_
+
+#include <cstdint>
+#include <cstddef>
+
+#include "rc6.hpp"
+#include "rc6_cbc.hpp"
+#include "rc6_ctr.hpp"
+
+/**
+ * @class RC6Stream
+ * @brief Incremental encryption and decryption context.
+ *
+ * CBC mode optionally applies PKCS#7 padding, which is added or removed by
+ * final(). CTR, CFB (full-block feedback) and OFB are stream modes: every
+ * byte passed to update() is returned immediately and final() produces no
+ * output.
+ *
+ * The referenced RC6 object must stay alive and keyed for the lifetime of
+ * this object. A context is not thread-safe.
+ */
+class RC6Stream {
+public:
+    /**
+     * @brief Mode of operation.
+     */
+    enum class Mode {
+        CBC, //!< Cipher block chaining
+        CTR, //!< Counter mode (16-byte big-endian counter)
+        CFB, //!< Cipher feedback with full 128-bit feedback
+        OFB //!< Output feedback
+    };
+
+    /**
+     * @brief Processing direction.
+     */
+    enum class Direction {
+        Encrypt, //!< Encrypt the input
+        Decrypt //!< Decrypt the input
+    };
+
+    static constexpr size_t BLOCK_SIZE = 16; //!< RC6 block size in bytes
+
+    /**
+     * @brief One input segment of a scatter/gather call.
+     */
+    struct ConstSegment {
+        const void *data; //!< Start of the segment
+        size_t len; //!< Segment length in bytes
+    };
+
+    /**
+     * @brief One output (or in-place) segment of a scatter/gather call.
+     */
+    struct Segment {
+        void *data; //!< Start of the segment
+        size_t len; //!< Segment length in bytes
+    };
+
+private:
+    static constexpr size_t BATCH_BLOCKS = 64; //!< Blocks processed per bulk call
+
+    const RC6 &cipher_; //!< The keyed block cipher
+    Mode mode_; //!< Mode of operation
+    Direction direction_; //!< Processing direction
+    bool padding_; //!< Whether CBC uses PKCS#7 padding
+    bool finished_; //!< Whether final() has been called
+    RC6CBC cbc_; //!< CBC block chaining
+    RC6CTR ctr_; //!< Counter mode state
+    uint8_t iv_[BLOCK_SIZE]; //!< Chaining value (CBC, CFB) or last output block (OFB)
+    uint8_t buffer_[BLOCK_SIZE]; //!< CBC partial or held-back block, CFB/OFB keystream
+    size_t buffered_; //!< CBC: bytes in buffer_, CFB/OFB: keystream bytes used
+
+    /**
+     * @brief Run full blocks through CBC.
+     * @param in Pointer to nblocks * 16 bytes of input.
+     * @param out Pointer to nblocks * 16 bytes of output (no overlap with in).
+     * @param nblocks Number of blocks.
+     */
+    void cbcBlocks(const uint8_t *in, uint8_t *out, size_t nblocks);
+
+    /**
+     * @brief Process data in CBC mode.
+     * @return Number of bytes written to out.
+     */
+    size_t updateCBC(const uint8_t *in, size_t len, uint8_t *out);
+
+    /**
+     * @brief Process data in CFB mode.
+     * @return Number of bytes written to out.
+     */
+    size_t updateCFB(const uint8_t *in, size_t len, uint8_t *out);
+
+    /**
+     * @brief Process data in OFB mode.
+     * @return Number of bytes written to out.
+     */
+    size_t updateOFB(const uint8_t *in, size_t len, uint8_t *out);
+
+    /**
+     * @brief Process data, with no state or argument checks.
+     * @return Number of bytes written to out.
+     */
+    size_t updateChunk(const uint8_t *in, size_t len, uint8_t *out);
+
+public:
+    /**
+     * @brief Constructor.
+     * @param cipher Initialized RC6 object.
+     * @param mode Mode of operation.
+     * @param direction Whether to encrypt or decrypt.
+     * @param iv Pointer to the 16-byte IV (initial counter block for CTR).
+     * @param padding Whether CBC mode applies PKCS#7 padding (ignored otherwise).
+     * @throws std::runtime_error if the cipher is not initialized.
+     * @throws std::invalid_argument if iv is null.
+     */
+    RC6Stream(const RC6 &cipher, Mode mode, Direction direction, const void *iv, bool padding = true);
+
+    /**
+     * @brief Process a chunk of input.
+     *
+     * In stream modes out may equal in and exactly len bytes are written. In
+     * CBC mode out must not overlap in, must have room for len + 15 bytes,
+     * and only complete blocks are written.
+     *
+     * @param in Pointer to the input data.
+     * @param len Number of input bytes.
+     * @param out Pointer to the output buffer.
+     * @return Number of bytes written to out.
+     * @throws std::runtime_error if final() has already been called.
+     * @throws std::invalid_argument if in or out is null and len is non-zero.
+     */
+    size_t update(const void *in, size_t len, void *out);
+
+    /**
+     * @brief Process input gathered from several segments into several segments.
+     *
+     * Equivalent to calling update() on the concatenated input and
+     * splitting the result over the output segments, which are filled in
+     * order. Blocks straddling segment boundaries are handled internally;
+     * long contiguous runs are passed to the bulk kernels directly.
+     *
+     * In stream modes out may describe the same memory as in. In CBC mode
+     * the output must not overlap the input. The output segments must hold
+     * the total input length, plus 15 bytes in CBC mode.
+     *
+     * @param in Array of in_count input segments.
+     * @param in_count Number of input segments.
+     * @param out Array of out_count output segments.
+     * @param out_count Number of output segments.
+     * @return Number of bytes written across the output segments.
+     * @throws std::runtime_error if final() has already been called.
+     * @throws std::invalid_argument if an array or a non-empty segment is null,
+     *         or if the output segments are too small.
+     */
+    size_t update(const ConstSegment *in, size_t in_count, const Segment *out, size_t out_count);
+
+    /**
+     * @brief Process segments in place (CTR, CFB and OFB only).
+     * @param segments Array of count segments, each overwritten with its output.
+     * @param count Number of segments.
+     * @throws std::runtime_error if final() has already been called or the mode is CBC.
+     * @throws std::invalid_argument if segments or a non-empty segment is null.
+     */
+    void update(const Segment *segments, size_t count);
+
+    /**
+     * @brief Finish the stream.
+     *
+     * In CBC mode this adds or checks and removes the padding. The output
+     * buffer must have room for 16 bytes.
+     *
+     * @param out Pointer to the output buffer.
+     * @return Number of bytes written to out.
+     * @throws std::runtime_error if final() has already been called.
+     * @throws std::runtime_error if CBC input is incomplete or the padding is invalid.
+     */
+    size_t final(void *out);
+};
+
+#endif /* RC6_STREAM_HPP_ */
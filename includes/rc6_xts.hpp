@@ -0,0 +1,116 @@
+/**
+ * @file rc6_xts.hpp
+ * @brief Header file for RC6 in XTS mode for storage encryption.
+ *
+ * This file provides the XTS tweakable mode (IEEE 1619, NIST SP 800-38E)
+ * on top of the RC6 block cipher, with ciphertext stealing for data units
+ * that are not a multiple of the block size. Within a data unit the tweak
+ * of every block is known up front, so blocks are whitened and run through
+ * the bulk kernels in batches.
+ */
+#ifndef RC6_XTS_HPP_
+#define RC6_XTS_HPP_
+
+#include <cstdint>
+#include <cstddef>
+
+#include "rc6.hpp"
+
+/**
+ * @class RC6XTS
+ * @brief RC6 in XTS mode.
+ *
+ * The object owns its two key schedules: one for the data and one for the
+ * tweaks. A data unit (sector) is addressed by a 128-bit tweak; the sector
+ * APIs use the sector number in little-endian order, as in IEEE 1619.
+ * Every call is independent, so one object can be shared by several
+ * threads.
+ */
+class RC6XTS {
+public:
+    static constexpr size_t BLOCK_SIZE = 16; //!< RC6 block size in bytes
+
+private:
+    static constexpr size_t BATCH_BLOCKS = 64; //!< Blocks processed per bulk call
+
+    RC6 data_cipher_; //!< Schedule for the data (first key half)
+    RC6 tweak_cipher_; //!< Schedule for the tweaks (second key half)
+
+    /**
+     * @brief Encrypt or decrypt one data unit given its encrypted tweak.
+     * @param encrypting True to encrypt, false to decrypt.
+     * @param tweak Encrypted tweak of the first block.
+     * @param in Pointer to len bytes of input.
+     * @param out Pointer to len bytes of output.
+     * @param len Data unit length in bytes (at least 16).
+     */
+    void crypt(bool encrypting, const uint8_t *tweak, const uint8_t *in, uint8_t *out, size_t len) const;
+
+    /**
+     * @brief Encrypt or decrypt consecutive sectors.
+     */
+    void cryptSectors(bool encrypting, uint64_t first_sector, const void *in, void *out,
+                      size_t sector_size, size_t count) const;
+
+public:
+    /**
+     * @brief Constructor.
+     * @param key Pointer to the key: the data key followed by the tweak key.
+     * @param keylength_bits Length of the whole key in bits (twice the RC6 key length).
+     * @param rounds The number of rounds to use (1-125, default: 20).
+     * @throws std::invalid_argument if key is null, keylength_bits is zero, odd
+     *         in bytes or greater than 4096, rounds is greater than 125, or the
+     *         two key halves are equal.
+     */
+    RC6XTS(const void *key, uint16_t keylength_bits, uint8_t rounds = 20);
+
+    /**
+     * @brief Encrypt one data unit.
+     * @param tweak Pointer to the 16-byte tweak (data unit number).
+     * @param in Pointer to len bytes of plaintext.
+     * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+     * @param len Data unit length in bytes (at least 16).
+     * @throws std::invalid_argument if a pointer is null or len is less than 16.
+     */
+    void encrypt(const void *tweak, const void *in, void *out, size_t len) const;
+
+    /**
+     * @brief Decrypt one data unit.
+     * @param tweak Pointer to the 16-byte tweak (data unit number).
+     * @param in Pointer to len bytes of ciphertext.
+     * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+     * @param len Data unit length in bytes (at least 16).
+     * @throws std::invalid_argument if a pointer is null or len is less than 16.
+     */
+    void decrypt(const void *tweak, const void *in, void *out, size_t len) const;
+
+    /**
+     * @brief Encrypt consecutive sectors.
+     *
+     * Sector first_sector + i occupies bytes [i * sector_size, (i + 1) * sector_size)
+     * of in and out.
+     *
+     * @param first_sector Number of the first sector.
+     * @param in Pointer to count * sector_size bytes of plaintext.
+     * @param out Pointer to the output. Must either equal in or not overlap it.
+     * @param sector_size Sector size in bytes (at least 16).
+     * @param count Number of sectors.
+     * @throws std::invalid_argument if in or out is null and count is non-zero,
+     *         or if sector_size is less than 16.
+     */
+    void encryptSectors(uint64_t first_sector, const void *in, void *out, size_t sector_size, size_t count) const;
+
+    /**
+     * @brief Decrypt consecutive sectors.
+     * @param first_sector Number of the first sector.
+     * @param in Pointer to count * sector_size bytes of ciphertext.
+     * @param out Pointer to the output. Must either equal in or not overlap it.
+     * @param sector_size Sector size in bytes (at least 16).
+     * @param count Number of sectors.
+     * @throws std::invalid_argument if in or out is null and count is non-zero,
+     *         or if sector_size is less than 16.
+     */
+    void decryptSectors(uint64_t first_sector, const void *in, void *out, size_t sector_size, size_t count) const;
+};
+
+#endif /* RC6_XTS_HPP_ */
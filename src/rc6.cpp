@@ -6,16 +6,80 @@
  * as defined in the rc6.hpp header file.
  */
 #include <algorithm>
+#include <cassert>
 #include <climits>
+#include <cstring>
 
 #include "rc6.hpp"
+#include "rc6_kernels.hpp"
+#include "rc6_trace.hpp"
+#include "rc6_util.hpp"
+
+constexpr uint8_t RC6::MAX_ROUNDS;
+constexpr uint16_t RC6::MAX_KEY_BITS;
+constexpr uint16_t RC6::MAX_ROUND_KEYS;
+
+namespace {
+    /**
+     * @brief Initial round key table, INITIAL_KEYS[i] = P32 + i * Q32.
+     *
+     * Covers the largest schedule (2 * MAX_ROUNDS + 4 words), so key setup
+     * starts with a copy instead of a dependent chain of additions.
+     */
+    const uint32_t INITIAL_KEYS[254] = {
+        0xb7e15163, 0x5618cb1c, 0xf45044d5, 0x9287be8e, 0x30bf3847, 0xcef6b200,
+        0x6d2e2bb9, 0x0b65a572, 0xa99d1f2b, 0x47d498e4, 0xe60c129d, 0x84438c56,
+        0x227b060f, 0xc0b27fc8, 0x5ee9f981, 0xfd21733a, 0x9b58ecf3, 0x399066ac,
+        0xd7c7e065, 0x75ff5a1e, 0x1436d3d7, 0xb26e4d90, 0x50a5c749, 0xeedd4102,
+        0x8d14babb, 0x2b4c3474, 0xc983ae2d, 0x67bb27e6, 0x05f2a19f, 0xa42a1b58,
+        0x42619511, 0xe0990eca, 0x7ed08883, 0x1d08023c, 0xbb3f7bf5, 0x5976f5ae,
+        0xf7ae6f67, 0x95e5e920, 0x341d62d9, 0xd254dc92, 0x708c564b, 0x0ec3d004,
+        0xacfb49bd, 0x4b32c376, 0xe96a3d2f, 0x87a1b6e8, 0x25d930a1, 0xc410aa5a,
+        0x62482413, 0x007f9dcc, 0x9eb71785, 0x3cee913e, 0xdb260af7, 0x795d84b0,
+        0x1794fe69, 0xb5cc7822, 0x5403f1db, 0xf23b6b94, 0x9072e54d, 0x2eaa5f06,
+        0xcce1d8bf, 0x6b195278, 0x0950cc31, 0xa78845ea, 0x45bfbfa3, 0xe3f7395c,
+        0x822eb315, 0x20662cce, 0xbe9da687, 0x5cd52040, 0xfb0c99f9, 0x994413b2,
+        0x377b8d6b, 0xd5b30724, 0x73ea80dd, 0x1221fa96, 0xb059744f, 0x4e90ee08,
+        0xecc867c1, 0x8affe17a, 0x29375b33, 0xc76ed4ec, 0x65a64ea5, 0x03ddc85e,
+        0xa2154217, 0x404cbbd0, 0xde843589, 0x7cbbaf42, 0x1af328fb, 0xb92aa2b4,
+        0x57621c6d, 0xf5999626, 0x93d10fdf, 0x32088998, 0xd0400351, 0x6e777d0a,
+        0x0caef6c3, 0xaae6707c, 0x491dea35, 0xe75563ee, 0x858cdda7, 0x23c45760,
+        0xc1fbd119, 0x60334ad2, 0xfe6ac48b, 0x9ca23e44, 0x3ad9b7fd, 0xd91131b6,
+        0x7748ab6f, 0x15802528, 0xb3b79ee1, 0x51ef189a, 0xf0269253, 0x8e5e0c0c,
+        0x2c9585c5, 0xcaccff7e, 0x69047937, 0x073bf2f0, 0xa5736ca9, 0x43aae662,
+        0xe1e2601b, 0x8019d9d4, 0x1e51538d, 0xbc88cd46, 0x5ac046ff, 0xf8f7c0b8,
+        0x972f3a71, 0x3566b42a, 0xd39e2de3, 0x71d5a79c, 0x100d2155, 0xae449b0e,
+        0x4c7c14c7, 0xeab38e80, 0x88eb0839, 0x272281f2, 0xc559fbab, 0x63917564,
+        0x01c8ef1d, 0xa00068d6, 0x3e37e28f, 0xdc6f5c48, 0x7aa6d601, 0x18de4fba,
+        0xb715c973, 0x554d432c, 0xf384bce5, 0x91bc369e, 0x2ff3b057, 0xce2b2a10,
+        0x6c62a3c9, 0x0a9a1d82, 0xa8d1973b, 0x470910f4, 0xe5408aad, 0x83780466,
+        0x21af7e1f, 0xbfe6f7d8, 0x5e1e7191, 0xfc55eb4a, 0x9a8d6503, 0x38c4debc,
+        0xd6fc5875, 0x7533d22e, 0x136b4be7, 0xb1a2c5a0, 0x4fda3f59, 0xee11b912,
+        0x8c4932cb, 0x2a80ac84, 0xc8b8263d, 0x66ef9ff6, 0x052719af, 0xa35e9368,
+        0x41960d21, 0xdfcd86da, 0x7e050093, 0x1c3c7a4c, 0xba73f405, 0x58ab6dbe,
+        0xf6e2e777, 0x951a6130, 0x3351dae9, 0xd18954a2, 0x6fc0ce5b, 0x0df84814,
+        0xac2fc1cd, 0x4a673b86, 0xe89eb53f, 0x86d62ef8, 0x250da8b1, 0xc345226a,
+        0x617c9c23, 0xffb415dc, 0x9deb8f95, 0x3c23094e, 0xda5a8307, 0x7891fcc0,
+        0x16c97679, 0xb500f032, 0x533869eb, 0xf16fe3a4, 0x8fa75d5d, 0x2dded716,
+        0xcc1650cf, 0x6a4dca88, 0x08854441, 0xa6bcbdfa, 0x44f437b3, 0xe32bb16c,
+        0x81632b25, 0x1f9aa4de, 0xbdd21e97, 0x5c099850, 0xfa411209, 0x98788bc2,
+        0x36b0057b, 0xd4e77f34, 0x731ef8ed, 0x115672a6, 0xaf8dec5f, 0x4dc56618,
+        0xebfcdfd1, 0x8a34598a, 0x286bd343, 0xc6a34cfc, 0x64dac6b5, 0x0312406e,
+        0xa149ba27, 0x3f8133e0, 0xddb8ad99, 0x7bf02752, 0x1a27a10b, 0xb85f1ac4,
+        0x5696947d, 0xf4ce0e36, 0x930587ef, 0x313d01a8, 0xcf747b61, 0x6dabf51a,
+        0x0be36ed3, 0xaa1ae88c, 0x48526245, 0xe689dbfe, 0x84c155b7, 0x22f8cf70,
+        0xc1304929, 0x5f67c2e2, 0xfd9f3c9b, 0x9bd6b654, 0x3a0e300d, 0xd845a9c6,
+        0x767d237f, 0x14b49d38
+    };
+
+}
 
 /**
  * @brief Default constructor for RC6 class.
  * 
  * Initializes the RC6 object with the default number of rounds (20).
  */
-RC6::RC6() : rounds_(20) {
+RC6::RC6() : rounds_(20), initialized_(false), round_keys_() {
 }
 
 /**
@@ -26,38 +90,139 @@ RC6::RC6() : rounds_(20) {
  * @param rounds The number of rounds to use (must be between 0 and 125).
  * @throws std::invalid_argument if the number of rounds is greater than 125.
  */
-RC6::RC6(const uint8_t rounds) : rounds_(rounds) {
-    if (rounds > 125) {
+RC6::RC6(const uint8_t rounds) : rounds_(rounds), initialized_(false), round_keys_() {
+    if (rounds > MAX_ROUNDS) {
         throw std::invalid_argument("Number of rounds must be between 0 and 125");
     }
 }
 
 /**
- * @brief Rotate left helper function.
- * 
- * Performs a bitwise rotate left operation on a 32-bit value.
- * 
- * @param a The 32-bit value to rotate.
- * @param n The number of bits to rotate (mod 32).
- * @return The rotated 32-bit value.
+ * @brief Destructor.
+ *
+ * Wipes the round keys, so no key material is left in freed memory.
  */
-uint32_t RC6::rotl32(const uint32_t a, uint8_t n) {
-    n &= 0x1f; // Higher rotates would not bring anything
-    return ((a << n) | (a >> (32 - n)));
+RC6::~RC6() {
+    clear();
 }
 
 /**
- * @brief Rotate right helper function.
- * 
- * Performs a bitwise rotate right operation on a 32-bit value.
- * 
- * @param a The 32-bit value to rotate.
- * @param n The number of bits to rotate (mod 32).
- * @return The rotated 32-bit value.
+ * @brief Move constructor.
+ *
+ * Copies the round keys in use and wipes the source.
+ *
+ * @param other The object to move from.
  */
-uint32_t RC6::rotr32(const uint32_t a, uint8_t n) {
-    n &= 0x1f; // Higher rotates would not bring anything
-    return ((a >> n) | (a << (32 - n)));
+RC6::RC6(RC6 &&other) noexcept : rounds_(other.rounds_), initialized_(other.initialized_), round_keys_() {
+    std::memcpy(round_keys_, other.round_keys_, sizeof(uint32_t) * (2 * rounds_ + 4));
+    other.clear();
+}
+
+/**
+ * @brief Move assignment operator.
+ *
+ * Wipes the current round keys, copies the ones in use by the source and
+ * wipes the source.
+ *
+ * @param other The object to move from.
+ * @return Reference to this object.
+ */
+RC6 &RC6::operator=(RC6 &&other) noexcept {
+    if (this != &other) {
+        clear();
+        rounds_ = other.rounds_;
+        initialized_ = other.initialized_;
+        std::memcpy(round_keys_, other.round_keys_, sizeof(uint32_t) * (2 * rounds_ + 4));
+        other.clear();
+    }
+    return *this;
+}
+
+/**
+ * @brief Convert key bytes into little-endian 32-bit key words.
+ *
+ * Only whole bytes of the key are used; trailing bits of a partial byte
+ * are ignored.
+ *
+ * @param key Pointer to the key data.
+ * @param keylength_bits Length of the key in bits (1 to 2048).
+ * @param words Output array of at least MAX_KEY_BITS / 32 words.
+ * @return Number of key words (at least 1).
+ */
+uint16_t RC6::loadKeyWords(const void *key, const uint16_t keylength_bits, uint32_t *words) {
+    const auto *key_bytes = static_cast<const uint8_t *>(key);
+    const uint16_t c = (keylength_bits + 31) / 32;
+
+    std::memset(words, 0, c * sizeof(uint32_t));
+    for (uint16_t i = 0; i < keylength_bits / 8; ++i) {
+        words[i / 4] |= static_cast<uint32_t>(key_bytes[i]) << (8 * (i % 4));
+    }
+    return c;
+}
+
+/**
+ * @brief Run the key schedule for an already validated key.
+ *
+ * Copies the P32/Q32 initial table and mixes in the key words with
+ * modulo-free index wrapping.
+ *
+ * @param key Pointer to the key data.
+ * @param keylength_bits Length of the key in bits (1 to 2048).
+ */
+void RC6::expandKey(const void *key, const uint16_t keylength_bits) noexcept {
+    static_assert(sizeof(INITIAL_KEYS) / sizeof(INITIAL_KEYS[0]) == MAX_ROUND_KEYS,
+                  "Initial key table must cover the largest schedule");
+
+    rc6_trace::initEntry(1, keylength_bits, rounds_);
+
+    uint32_t key_words[MAX_KEY_BITS / 32];
+    const uint16_t c = loadKeyWords(key, keylength_bits, key_words);
+
+    // Initialize round keys
+    const uint16_t key_size = 2 * rounds_ + 4;
+    std::memcpy(round_keys_, INITIAL_KEYS, key_size * sizeof(uint32_t));
+
+    // Mix the key into the round keys
+    uint32_t a = 0, b = 0;
+    uint16_t i = 0, j = 0;
+    const uint16_t v = 3 * std::max(c, key_size);
+
+    for (uint16_t p = 0; p < v; ++p) {
+        a = round_keys_[i] = rc6_detail::rotateLeft(round_keys_[i] + a + b, 3);
+        b = key_words[j] = rc6_detail::rotateLeft(key_words[j] + a + b, a + b);
+        if (++i == key_size) {
+            i = 0;
+        }
+        if (++j == c) {
+            j = 0;
+        }
+    }
+
+    rc6_util::secureZero(key_words, c * sizeof(uint32_t));
+    initialized_ = true;
+    rc6_trace::initReturn(1);
+}
+
+/**
+ * @brief Initialize the cipher with a key without throwing.
+ *
+ * Same as init(), but reports invalid arguments through the return value.
+ * The cipher is left unchanged on error.
+ *
+ * @param key Pointer to the key data.
+ * @param keylength_bits Length of the key in bits.
+ * @return RC6Status::Ok, RC6Status::NullPointer or RC6Status::InvalidKeyLength.
+ */
+RC6Status RC6::tryInit(const void *key, const uint16_t keylength_bits) noexcept {
+    if (key == nullptr) {
+        return RC6Status::NullPointer;
+    }
+
+    if (keylength_bits == 0 || keylength_bits > MAX_KEY_BITS) {
+        return RC6Status::InvalidKeyLength;
+    }
+
+    expandKey(key, keylength_bits);
+    return RC6Status::Ok;
 }
 
 /**
@@ -69,6 +234,7 @@ uint32_t RC6::rotr32(const uint32_t a, uint8_t n) {
  * @param key Pointer to the key data.
  * @param keylength_bits Length of the key in bits.
  * @throws std::invalid_argument if key is null or keylength_bits is zero.
+ * @throws std::invalid_argument if keylength_bits is greater than 2048.
  * @throws std::invalid_argument if the number of rounds is greater than 125.
  */
 void RC6::init(const void *key, const uint16_t keylength_bits) {
@@ -80,54 +246,116 @@ void RC6::init(const void *key, const uint16_t keylength_bits) {
         throw std::invalid_argument("Key length cannot be zero");
     }
 
-    if (rounds_ > 125) {
+    if (keylength_bits > MAX_KEY_BITS) {
+        throw std::invalid_argument("Key length cannot exceed 2048 bits");
+    }
+
+    if (rounds_ > MAX_ROUNDS) {
         throw std::invalid_argument("Number of rounds must be between 0 and 125");
     }
 
-    const auto *key_bytes = static_cast<const uint8_t *>(key);
+    expandKey(key, keylength_bits);
+}
 
-    // Calculate number of 32-bit words in the key
-    uint16_t c = keylength_bits / 32;
-    if (keylength_bits % 32 != 0) {
-        c++;
+/**
+ * @brief Initialize several ciphers with keys of the same length.
+ *
+ * Produces the same round keys as calling init() on each cipher. Runs of
+ * consecutive ciphers with the same number of rounds are expanded together,
+ * one key per vector lane, using the widest kernel supported by the CPU.
+ * All arguments are validated before any cipher is modified.
+ *
+ * @param ciphers Array of count ciphers; each keeps its number of rounds.
+ * @param keys Array of count pointers to the key data.
+ * @param keylength_bits Length of every key in bits.
+ * @param count Number of ciphers.
+ * @throws std::invalid_argument if ciphers, keys or any key is null and count is non-zero.
+ * @throws std::invalid_argument if keylength_bits is zero or greater than 2048.
+ */
+void RC6::initMany(RC6 *ciphers, const void *const *keys, const uint16_t keylength_bits, const size_t count) {
+    if (count == 0) {
+        return;
     }
 
-    // Prepare key as array of 32-bit words
-    std::vector<uint32_t> key_words(c, 0);
-    for (uint16_t i = 0; i < keylength_bits / 8; ++i) {
-        key_words[i / 4] |= static_cast<uint32_t>(key_bytes[i]) << (8 * (i % 4));
+    if (ciphers == nullptr || keys == nullptr) {
+        throw std::invalid_argument("Key cannot be null");
     }
 
-    // Handle remaining bits if key length is not a multiple of 32
-    if (keylength_bits % 32 != 0) {
-        const uint8_t remaining_bits = keylength_bits % 8;
-        if (remaining_bits > 0) {
-            // Clear the remaining bits in the last byte
-            key_words[c - 1] &= ~(0xFF << (8 * (keylength_bits / 8 % 4)));
-        }
+    if (keylength_bits == 0) {
+        throw std::invalid_argument("Key length cannot be zero");
     }
 
-    // Initialize round keys
-    const uint16_t key_size = 2 * rounds_ + 4;
-    round_keys_.resize(key_size);
+    if (keylength_bits > MAX_KEY_BITS) {
+        throw std::invalid_argument("Key length cannot exceed 2048 bits");
+    }
 
-    // Initialize S array with P32 and Q32 constants
-    round_keys_[0] = P32;
-    for (uint16_t i = 1; i < key_size; ++i) {
-        round_keys_[i] = round_keys_[i - 1] + Q32;
+    for (size_t k = 0; k < count; ++k) {
+        if (keys[k] == nullptr) {
+            throw std::invalid_argument("Key cannot be null");
+        }
     }
 
-    // Mix the key into the round keys
-    uint32_t a = 0, b = 0;
-    uint16_t i = 0, j = 0;
-    const uint16_t v = 3 * std::max(c, key_size);
+    const rc6_kernels::Backend *backend = rc6_kernels::keyScheduleBackend();
+    const size_t max_lanes = rc6_kernels::MAX_LANES;
+    uint32_t s[MAX_ROUND_KEYS * max_lanes];
+    uint32_t l[MAX_KEY_BITS / 32 * max_lanes];
+    uint32_t key_words[MAX_KEY_BITS / 32];
+    size_t s_used = 0;
+    size_t l_used = 0;
+
+    for (size_t first = 0; first < count;) {
+        // Group consecutive ciphers sharing a schedule size, up to one per lane
+        const uint8_t rounds = ciphers[first].rounds_;
+        size_t lanes = 1;
+        if (backend != nullptr && backend->lanes <= max_lanes) {
+            while (lanes < backend->lanes && first + lanes < count && ciphers[first + lanes].rounds_ == rounds) {
+                ++lanes;
+            }
+        }
 
-    for (uint16_t p = 0; p < v; ++p) {
-        a = round_keys_[i] = rotl32(round_keys_[i] + a + b, 3);
-        b = key_words[j] = rotl32(key_words[j] + a + b, (a + b) & 0x1F);
-        i = (i + 1) % key_size;
-        j = (j + 1) % c;
+        if (lanes == 1) {
+            ciphers[first].init(keys[first], keylength_bits);
+            ++first;
+            continue;
+        }
+
+        rc6_trace::initEntry(lanes, keylength_bits, rounds);
+
+        // Transpose into the word-major layout; unused lanes carry a zero key
+        const size_t width = backend->lanes;
+        const uint16_t key_size = 2 * rounds + 4;
+        uint16_t c = 0;
+        std::memset(l, 0, sizeof(l));
+        for (size_t k = 0; k < lanes; ++k) {
+            c = loadKeyWords(keys[first + k], keylength_bits, key_words);
+            for (uint16_t j = 0; j < c; ++j) {
+                l[j * width + k] = key_words[j];
+            }
+        }
+        for (uint16_t i = 0; i < key_size; ++i) {
+            for (size_t k = 0; k < width; ++k) {
+                s[i * width + k] = INITIAL_KEYS[i];
+            }
+        }
+
+        backend->mixKeys(s, l, key_size, c);
+
+        for (size_t k = 0; k < lanes; ++k) {
+            RC6 &cipher = ciphers[first + k];
+            for (uint16_t i = 0; i < key_size; ++i) {
+                cipher.round_keys_[i] = s[i * width + k];
+            }
+            cipher.initialized_ = true;
+        }
+        rc6_trace::initReturn(lanes);
+        first += lanes;
+        s_used = std::max<size_t>(s_used, key_size * width);
+        l_used = std::max<size_t>(l_used, c * width);
     }
+
+    rc6_util::secureZero(s, s_used * sizeof(uint32_t));
+    rc6_util::secureZero(l, l_used * sizeof(uint32_t));
+    rc6_util::secureZero(key_words, sizeof(key_words));
 }
 
 /**
@@ -150,37 +378,8 @@ void RC6::encrypt(void *block) const {
         throw std::invalid_argument("Block cannot be null");
     }
 
-    auto *data = static_cast<uint32_t *>(block);
-    auto a = data[0];
-    auto b = data[1];
-    auto c = data[2];
-    auto d = data[3];
-
-    b += round_keys_[0];
-    d += round_keys_[1];
-
-    for (size_t i = 1; i <= rounds_; ++i) {
-        const auto t = rotl32(b * (2 * b + 1), LG_W);
-        const auto u = rotl32(d * (2 * d + 1), LG_W);
-        a = rotl32((a ^ t), u) + round_keys_[2 * i];
-        c = rotl32((c ^ u), t) + round_keys_[2 * i + 1];
-
-        // Swap variables
-        const auto temp = a;
-        a = b;
-        b = c;
-        c = d;
-        d = temp;
-    }
-
-    a += round_keys_[2 * rounds_ + 2];
-    c += round_keys_[2 * rounds_ + 3];
-
-    // Store the result back to the block
-    data[0] = a;
-    data[1] = b;
-    data[2] = c;
-    data[3] = d;
+    auto *data = static_cast<uint8_t *>(block);
+    encryptBlock(data, data);
 }
 
 /**
@@ -203,37 +402,329 @@ void RC6::decrypt(void *block) const {
         throw std::invalid_argument("Block cannot be null");
     }
 
-    auto *data = static_cast<uint32_t *>(block);
-    auto a = data[0];
-    auto b = data[1];
-    auto c = data[2];
-    auto d = data[3];
+    auto *data = static_cast<uint8_t *>(block);
+    decryptBlock(data, data);
+}
 
-    c -= round_keys_[2 * rounds_ + 3];
-    a -= round_keys_[2 * rounds_ + 2];
+/**
+ * @brief Encrypt multiple consecutive blocks in place.
+ *
+ * Validates the cipher state once and then encrypts every block in a
+ * tight loop.
+ *
+ * @param blocks Pointer to nblocks * 16 bytes of data.
+ * @param nblocks Number of 16-byte blocks to encrypt.
+ * @throws std::runtime_error if the cipher is not initialized.
+ * @throws std::invalid_argument if blocks is null and nblocks is non-zero.
+ */
+void RC6::encryptBlocks(void *blocks, const size_t nblocks) const {
+    encryptBlocks(blocks, blocks, nblocks);
+}
 
-    for (uint8_t i = rounds_; i > 0; --i) {
-        // Swap variables
-        const auto temp = a;
-        a = d;
-        d = c;
-        c = b;
-        b = temp;
+/**
+ * @brief Encrypt multiple consecutive blocks out of place.
+ *
+ * Validates the cipher state once, hands as many blocks as possible to
+ * the vectorized kernels selected for this CPU and encrypts the remaining
+ * tail with the scalar transform.
+ *
+ * @param in Pointer to nblocks * 16 bytes of plaintext.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks to encrypt.
+ * @throws std::runtime_error if the cipher is not initialized.
+ * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+ */
+void RC6::encryptBlocks(const void *in, void *out, const size_t nblocks) const {
+    if (!isInitialized()) {
+        throw std::runtime_error("RC6 not initialized");
+    }
+
+    if (nblocks == 0) {
+        return;
+    }
+
+    if (in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    encryptBlocksUnchecked(in, out, nblocks);
+}
+
+/**
+ * @brief Encrypt multiple consecutive blocks without any checks.
+ *
+ * Runs the vectorized kernels selected for this CPU and finishes the tail
+ * with the scalar transform. Debug builds assert the preconditions.
+ *
+ * @param in Pointer to nblocks * 16 bytes of input.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks.
+ */
+void RC6::encryptBlocksUnchecked(const void *in, void *out, const size_t nblocks) const noexcept {
+    assert(initialized_ && (nblocks == 0 || (in != nullptr && out != nullptr)));
+
+    rc6_trace::encryptEntry(nblocks);
+
+    // Vectorized kernels take as many blocks as they can, the scalar path finishes the tail
+    const size_t done = rc6_kernels::encryptBlocks(round_keys_, rounds_, in, out, nblocks);
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    for (size_t n = done; n < nblocks; ++n) {
+        encryptBlock(src + 16 * n, dst + 16 * n);
+    }
+    rc6_trace::backendBlocks(rc6_kernels::BACKEND_COUNT, nblocks - done);
+    rc6_trace::encryptReturn(nblocks);
+}
+
+/**
+ * @brief Encrypt blocks that each have their own cipher.
+ * @param ciphers Array of nblocks cipher pointers.
+ * @param in Pointer to nblocks * 16 bytes of plaintext.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks to encrypt.
+ * @throws std::invalid_argument if ciphers, in, out or any cipher pointer
+ *         is null and nblocks is non-zero.
+ * @throws std::runtime_error if a cipher is not initialized.
+ */
+void RC6::encryptBlocksMany(const RC6 *const *ciphers, const void *in, void *out, const size_t nblocks) {
+    if (nblocks == 0) {
+        return;
+    }
+
+    if (ciphers == nullptr || in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    for (size_t n = 0; n < nblocks; ++n) {
+        if (ciphers[n] == nullptr) {
+            throw std::invalid_argument("Cipher cannot be null");
+        }
+        if (!ciphers[n]->isInitialized()) {
+            throw std::runtime_error("RC6 not initialized");
+        }
+    }
+
+    encryptBlocksManyUnchecked(ciphers, in, out, nblocks);
+}
+
+/**
+ * @brief Encrypt blocks that each have their own cipher, without any checks.
+ *
+ * Keeps the schedules of the current lane ciphers transposed into the
+ * word-major table of the lane kernel, copying a lane's column only when
+ * its cipher changes, and passes every run of groups with unchanged lanes
+ * to the kernel in one call. Groups whose ciphers differ in the number of
+ * rounds, and the final partial group, are encrypted one block at a time.
+ *
+ * @param ciphers Array of nblocks pointers to initialized ciphers.
+ * @param in Pointer to nblocks * 16 bytes of plaintext.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks to encrypt.
+ */
+void RC6::encryptBlocksManyUnchecked(const RC6 *const *ciphers, const void *in, void *out,
+                                     const size_t nblocks) noexcept {
+    assert(nblocks == 0 || (ciphers != nullptr && in != nullptr && out != nullptr));
+
+    rc6_trace::encryptEntry(nblocks);
+
+    const rc6_kernels::Backend *backend = rc6_kernels::activeBackend();
+    const size_t lanes = backend->lanes;
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+
+    size_t lane_of[rc6_kernels::MAX_LANES];
+    for (size_t k = 0; k < lanes; ++k) {
+        lane_of[k] = rc6_kernels::laneOf(backend, k);
+    }
+
+    alignas(rc6_kernels::LANE_KEY_ALIGNMENT) uint32_t lane_keys[MAX_ROUND_KEYS * rc6_kernels::MAX_LANES];
+    const RC6 *current[rc6_kernels::MAX_LANES] = {};
+    size_t keys_used = 0;
+    size_t n = 0;
+    size_t vectorized = 0;
+
+    while (n + lanes <= nblocks) {
+        const uint8_t rounds = ciphers[n]->rounds_;
+        bool uniform = true;
+        for (size_t k = 1; k < lanes; ++k) {
+            uniform = uniform && ciphers[n + k]->rounds_ == rounds;
+        }
+
+        if (!uniform) {
+            for (size_t k = 0; k < lanes; ++k, ++n) {
+                ciphers[n]->encryptBlock(src + 16 * n, dst + 16 * n);
+            }
+            continue;
+        }
+
+        const size_t key_size = 2 * rounds + 4;
+        for (size_t k = 0; k < lanes; ++k) {
+            const RC6 *cipher = ciphers[n + k];
+            if (cipher != current[k]) {
+                current[k] = cipher;
+                for (size_t j = 0; j < key_size; ++j) {
+                    lane_keys[j * lanes + lane_of[k]] = cipher->round_keys_[j];
+                }
+            }
+        }
+        keys_used = std::max(keys_used, key_size * lanes);
+
+        size_t run = lanes;
+        while (n + run + lanes <= nblocks && std::equal(current, current + lanes, ciphers + n + run)) {
+            run += lanes;
+        }
+
+        backend->encryptLanes(lane_keys, rounds, src + 16 * n, dst + 16 * n, run);
+        n += run;
+        vectorized += run;
+    }
+
+    for (; n < nblocks; ++n) {
+        ciphers[n]->encryptBlock(src + 16 * n, dst + 16 * n);
+    }
 
-        const auto u = rotl32(d * (2 * d + 1), LG_W);
-        const auto t = rotl32(b * (2 * b + 1), LG_W);
-        c = rotr32(c - round_keys_[2 * i + 1], t) ^ u;
-        a = rotr32(a - round_keys_[2 * i], u) ^ t;
+    rc6_util::secureZero(lane_keys, keys_used * sizeof(uint32_t));
+    rc6_trace::backendBlocks(backend->id, vectorized);
+    rc6_trace::backendBlocks(rc6_kernels::BACKEND_COUNT, nblocks - vectorized);
+    rc6_trace::encryptReturn(nblocks);
+}
+
+/**
+ * @brief Get the number of blocks the bulk kernels process side by side.
+ * @return Lane count of the widest kernel in use.
+ */
+size_t RC6::bulkLanes() noexcept {
+    return rc6_kernels::activeBackend()->lanes;
+}
+
+/**
+ * @brief Encrypt multiple consecutive blocks without throwing.
+ * @param in Pointer to nblocks * 16 bytes of input.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks.
+ * @return RC6Status::Ok, RC6Status::NotInitialized or RC6Status::NullPointer.
+ */
+RC6Status RC6::tryEncryptBlocks(const void *in, void *out, const size_t nblocks) const noexcept {
+    if (!initialized_) {
+        return RC6Status::NotInitialized;
+    }
+
+    if (nblocks != 0 && (in == nullptr || out == nullptr)) {
+        return RC6Status::NullPointer;
+    }
+
+    encryptBlocksUnchecked(in, out, nblocks);
+    return RC6Status::Ok;
+}
+
+/**
+ * @brief Decrypt multiple consecutive blocks in place.
+ *
+ * Validates the cipher state once and then decrypts every block in a
+ * tight loop.
+ *
+ * @param blocks Pointer to nblocks * 16 bytes of data.
+ * @param nblocks Number of 16-byte blocks to decrypt.
+ * @throws std::runtime_error if the cipher is not initialized.
+ * @throws std::invalid_argument if blocks is null and nblocks is non-zero.
+ */
+void RC6::decryptBlocks(void *blocks, const size_t nblocks) const {
+    decryptBlocks(blocks, blocks, nblocks);
+}
+
+/**
+ * @brief Decrypt multiple consecutive blocks out of place.
+ *
+ * Validates the cipher state once, hands as many blocks as possible to
+ * the vectorized kernels selected for this CPU and decrypts the remaining
+ * tail with the scalar transform.
+ *
+ * @param in Pointer to nblocks * 16 bytes of ciphertext.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks to decrypt.
+ * @throws std::runtime_error if the cipher is not initialized.
+ * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+ */
+void RC6::decryptBlocks(const void *in, void *out, const size_t nblocks) const {
+    if (!isInitialized()) {
+        throw std::runtime_error("RC6 not initialized");
     }
 
-    d -= round_keys_[1];
-    b -= round_keys_[0];
+    if (nblocks == 0) {
+        return;
+    }
+
+    if (in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    decryptBlocksUnchecked(in, out, nblocks);
+}
+
+/**
+ * @brief Decrypt multiple consecutive blocks without any checks.
+ *
+ * Runs the vectorized kernels selected for this CPU and finishes the tail
+ * with the scalar transform. Debug builds assert the preconditions.
+ *
+ * @param in Pointer to nblocks * 16 bytes of input.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks.
+ */
+void RC6::decryptBlocksUnchecked(const void *in, void *out, const size_t nblocks) const noexcept {
+    assert(initialized_ && (nblocks == 0 || (in != nullptr && out != nullptr)));
+
+    rc6_trace::decryptEntry(nblocks);
+
+    // Vectorized kernels take as many blocks as they can, the scalar path finishes the tail
+    const size_t done = rc6_kernels::decryptBlocks(round_keys_, rounds_, in, out, nblocks);
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    for (size_t n = done; n < nblocks; ++n) {
+        decryptBlock(src + 16 * n, dst + 16 * n);
+    }
+    rc6_trace::backendBlocks(rc6_kernels::BACKEND_COUNT, nblocks - done);
+    rc6_trace::decryptReturn(nblocks);
+}
+
+/**
+ * @brief Decrypt multiple consecutive blocks without throwing.
+ * @param in Pointer to nblocks * 16 bytes of input.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks.
+ * @return RC6Status::Ok, RC6Status::NotInitialized or RC6Status::NullPointer.
+ */
+RC6Status RC6::tryDecryptBlocks(const void *in, void *out, const size_t nblocks) const noexcept {
+    if (!initialized_) {
+        return RC6Status::NotInitialized;
+    }
 
-    // Store the result back to the block
-    data[0] = a;
-    data[1] = b;
-    data[2] = c;
-    data[3] = d;
+    if (nblocks != 0 && (in == nullptr || out == nullptr)) {
+        return RC6Status::NullPointer;
+    }
+
+    decryptBlocksUnchecked(in, out, nblocks);
+    return RC6Status::Ok;
+}
+
+/**
+ * @brief Wipe the round keys and return to the uninitialized state.
+ *
+ * The object keeps its number of rounds and can be initialized again.
+ */
+void RC6::clear() noexcept {
+    rc6_util::secureZero(round_keys_, sizeof(uint32_t) * (2 * rounds_ + 4));
+    initialized_ = false;
 }
 
 /**
@@ -244,5 +735,5 @@ void RC6::decrypt(void *block) const {
  * @return True if the cipher has been initialized with a key, false otherwise.
  */
 bool RC6::isInitialized() const {
-    return !round_keys_.empty();
+    return initialized_;
 }
@@ -0,0 +1,264 @@
+/**
+ * @file rc6_async.cpp
+ * @brief Implementation file for asynchronous submission of RC6 jobs.
+ *
+ * This file provides the implementation of the asynchronous front end as
+ * defined in the rc6_async.hpp header file.
+ */
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "rc6_async.hpp"
+#include "rc6_batch.hpp"
+#include "rc6_ctr.hpp"
+
+constexpr size_t RC6Async::BLOCK_SIZE;
+constexpr size_t RC6Async::DEFAULT_BATCH_BYTES;
+
+/**
+ * @brief Constructor.
+ * @param engine Parallel engine used for large jobs.
+ * @param batch_bytes CTR jobs of at most this many bytes are coalesced
+ *                    (default: 4096); 0 disables coalescing.
+ */
+RC6Async::RC6Async(RC6Parallel &engine, const size_t batch_bytes)
+    : engine_(engine), batch_bytes_(batch_bytes), stopping_(false), dispatcher_(&RC6Async::dispatchLoop, this) {
+}
+
+/**
+ * @brief Destructor.
+ *
+ * The dispatcher only exits once the queue is empty, so every submitted
+ * job completes and every future becomes ready.
+ */
+RC6Async::~RC6Async() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_one();
+    dispatcher_.join();
+}
+
+/**
+ * @brief Queue a job and call a handler when it completes.
+ *
+ * The job is validated here so that the caller sees argument errors
+ * immediately and the dispatcher never has to.
+ *
+ * @param request The job; it is copied.
+ * @param done Handler run on the dispatcher thread; must not throw.
+ * @throws std::invalid_argument if done is empty, the operation is
+ *         unknown, cipher is null, in or out is null and len is
+ *         non-zero, or an ECB or CBC length is not a multiple of 16.
+ * @throws std::runtime_error if the cipher is not initialized.
+ */
+void RC6Async::submit(const Request &request, Callback done) {
+    if (!done) {
+        throw std::invalid_argument("Callback cannot be empty");
+    }
+
+    validate(request);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(Pending{request, std::move(done)});
+    }
+    work_cv_.notify_one();
+}
+
+/**
+ * @brief Check a job's arguments.
+ *
+ * Called by submit() and again by the dispatcher, since the cipher may
+ * have been cleared or moved from while the job was queued.
+ *
+ * @param request The job.
+ * @throws std::invalid_argument if the operation is unknown, cipher is
+ *         null, in or out is null and len is non-zero, or an ECB or CBC
+ *         length is not a multiple of 16.
+ * @throws std::runtime_error if the cipher is not initialized.
+ */
+void RC6Async::validate(const Request &request) {
+    switch (request.operation) {
+        case Operation::EncryptECB:
+        case Operation::DecryptECB:
+        case Operation::DecryptCBC:
+            if (request.len % BLOCK_SIZE != 0) {
+                throw std::invalid_argument("Length must be a multiple of 16 bytes");
+            }
+            break;
+        case Operation::ProcessCTR:
+            break;
+        default:
+            throw std::invalid_argument("Unknown operation");
+    }
+
+    if (request.cipher == nullptr) {
+        throw std::invalid_argument("Cipher cannot be null");
+    }
+
+    if (!request.cipher->isInitialized()) {
+        throw std::runtime_error("RC6 not initialized");
+    }
+
+    if (request.len != 0 && (request.in == nullptr || request.out == nullptr)) {
+        throw std::invalid_argument("Data cannot be null");
+    }
+}
+
+/**
+ * @brief Queue a job and get a future for its completion.
+ * @param request The job; it is copied.
+ * @return Future that becomes ready when the job completes.
+ * @throws std::invalid_argument if the request is invalid (see above).
+ * @throws std::runtime_error if the cipher is not initialized.
+ */
+std::future<void> RC6Async::submit(const Request &request) {
+    // std::function needs a copyable handler, so the promise is shared
+    const auto promise = std::make_shared<std::promise<void> >();
+    std::future<void> result = promise->get_future();
+
+    submit(request, [promise](const std::exception_ptr error) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value();
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Dispatcher thread main loop.
+ *
+ * Takes the whole queue under one lock, so jobs submitted while a pass is
+ * running are handled together in the next one.
+ */
+void RC6Async::dispatchLoop() {
+    for (;;) {
+        std::deque<Pending> jobs;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            jobs.swap(queue_);
+        }
+        runJobs(jobs);
+    }
+}
+
+/**
+ * @brief Run and complete every job taken from the queue in one pass.
+ *
+ * Jobs run in submission order. Each run of consecutive small CTR jobs is
+ * handed to runBatch(), so a burst of short messages becomes one kernel
+ * call without overtaking a larger job submitted before it.
+ *
+ * @param jobs The jobs.
+ */
+void RC6Async::runJobs(std::deque<Pending> &jobs) {
+    size_t i = 0;
+    while (i < jobs.size()) {
+        size_t end = i;
+        while (end < jobs.size() && jobs[end].request.operation == Operation::ProcessCTR &&
+               jobs[end].request.len <= batch_bytes_) {
+            ++end;
+        }
+        if (end != i) {
+            runBatch(jobs, i, end);
+            i = end;
+            continue;
+        }
+
+        Pending &pending = jobs[i++];
+        std::exception_ptr error;
+        try {
+            validate(pending.request);
+            run(pending.request);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        pending.done(error);
+    }
+}
+
+/**
+ * @brief Run a run of small CTR jobs as one batch and complete them.
+ *
+ * Every job is validated on its own first, so a job whose cipher was
+ * cleared after submission fails alone and is left out of the batch. The
+ * rest are grouped by schedule, which lets RC6Batch pack adjacent jobs
+ * into one kernel call, and completed in submission order.
+ *
+ * @param jobs The jobs taken from the queue.
+ * @param first Index of the first job of the run.
+ * @param last Index one past the last job of the run.
+ */
+void RC6Async::runBatch(std::deque<Pending> &jobs, const size_t first, const size_t last) {
+    std::vector<std::exception_ptr> errors(last - first);
+    std::vector<size_t> valid;
+    for (size_t i = first; i < last; ++i) {
+        try {
+            validate(jobs[i].request);
+            valid.push_back(i);
+        } catch (...) {
+            errors[i - first] = std::current_exception();
+        }
+    }
+
+    if (!valid.empty()) {
+        std::stable_sort(valid.begin(), valid.end(), [&jobs](const size_t a, const size_t b) {
+            return std::less<const RC6 *>()(jobs[a].request.cipher, jobs[b].request.cipher);
+        });
+
+        try {
+            std::vector<RC6Batch::Job> batch(valid.size());
+            for (size_t k = 0; k < valid.size(); ++k) {
+                const Request &request = jobs[valid[k]].request;
+                RC6Batch::Job &job = batch[k];
+                job.cipher = request.cipher;
+                std::copy(request.iv, request.iv + BLOCK_SIZE, job.iv);
+                job.in = request.in;
+                job.out = request.out;
+                job.len = request.len;
+            }
+            RC6Batch::processCTR(batch.data(), batch.size());
+        } catch (...) {
+            // Only an allocation failure is left once every job has been checked
+            const std::exception_ptr error = std::current_exception();
+            for (const size_t i: valid) {
+                errors[i - first] = error;
+            }
+        }
+    }
+
+    for (size_t i = first; i < last; ++i) {
+        jobs[i].done(errors[i - first]);
+    }
+}
+
+/**
+ * @brief Run one job on the engine.
+ * @param request The job.
+ */
+void RC6Async::run(const Request &request) {
+    switch (request.operation) {
+        case Operation::EncryptECB:
+            engine_.encryptECB(*request.cipher, request.in, request.out, request.len / BLOCK_SIZE);
+            break;
+        case Operation::DecryptECB:
+            engine_.decryptECB(*request.cipher, request.in, request.out, request.len / BLOCK_SIZE);
+            break;
+        case Operation::ProcessCTR:
+            engine_.processCTR(RC6CTR(*request.cipher, request.iv), 0, request.in, request.out, request.len);
+            break;
+        case Operation::DecryptCBC:
+            engine_.decryptCBC(*request.cipher, request.iv, request.in, request.out, request.len / BLOCK_SIZE);
+            break;
+    }
+}
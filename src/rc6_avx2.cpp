@@ -0,0 +1,241 @@
+/**
+ * @file rc6_avx2.cpp
+ * @brief AVX2 implementation of the RC6 bulk kernels.
+ *
+ * Each 256-bit vector holds one word of eight blocks. Variable rotates use
+ * the per-lane shifts _mm256_sllv_epi32/_mm256_srlv_epi32. This file is
+ * compiled with AVX2 enabled and is only called after a runtime CPU check.
+ */
+#include "rc6_kernels.hpp"
+
+#if defined(__AVX2__)
+#define RC6_KERNEL_AVX2 1
+#endif
+
+#ifdef RC6_KERNEL_AVX2
+
+#include <immintrin.h>
+
+namespace {
+    constexpr size_t LANES = 8;
+
+    inline __m256i rotlv(const __m256i x, const __m256i n) {
+        const __m256i count = _mm256_and_si256(n, _mm256_set1_epi32(0x1f));
+        return _mm256_or_si256(_mm256_sllv_epi32(x, count),
+                               _mm256_srlv_epi32(x, _mm256_sub_epi32(_mm256_set1_epi32(32), count)));
+    }
+
+    inline __m256i rotrv(const __m256i x, const __m256i n) {
+        const __m256i count = _mm256_and_si256(n, _mm256_set1_epi32(0x1f));
+        return _mm256_or_si256(_mm256_srlv_epi32(x, count),
+                               _mm256_sllv_epi32(x, _mm256_sub_epi32(_mm256_set1_epi32(32), count)));
+    }
+
+    // f(x) = (x * (2x + 1)) <<< 5
+    inline __m256i mix(const __m256i x) {
+        const __m256i p = _mm256_mullo_epi32(x, _mm256_add_epi32(_mm256_add_epi32(x, x), _mm256_set1_epi32(1)));
+        return _mm256_or_si256(_mm256_slli_epi32(p, 5), _mm256_srli_epi32(p, 27));
+    }
+
+    // 4x4 transpose within each 128-bit lane between block order and A/B/C/D words
+    inline void transpose(__m256i &r0, __m256i &r1, __m256i &r2, __m256i &r3) {
+        const __m256i t0 = _mm256_unpacklo_epi32(r0, r1);
+        const __m256i t1 = _mm256_unpackhi_epi32(r0, r1);
+        const __m256i t2 = _mm256_unpacklo_epi32(r2, r3);
+        const __m256i t3 = _mm256_unpackhi_epi32(r2, r3);
+        r0 = _mm256_unpacklo_epi64(t0, t2);
+        r1 = _mm256_unpackhi_epi64(t0, t2);
+        r2 = _mm256_unpacklo_epi64(t1, t3);
+        r3 = _mm256_unpackhi_epi64(t1, t3);
+    }
+
+    inline void load(const uint8_t *in, __m256i &a, __m256i &b, __m256i &c, __m256i &d) {
+        a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+        b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 32));
+        c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 64));
+        d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 96));
+        transpose(a, b, c, d);
+    }
+
+    inline void store(uint8_t *out, __m256i a, __m256i b, __m256i c, __m256i d) {
+        transpose(a, b, c, d);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 32), b);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 64), c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 96), d);
+    }
+
+    // Round key j of every lane: one schedule broadcast to all lanes
+    struct SharedKeys {
+        const uint32_t *rk;
+
+        __m256i operator[](const size_t j) const {
+            return _mm256_set1_epi32(static_cast<int>(rk[j]));
+        }
+    };
+
+    // Round key j of every lane: one schedule per lane, stored word-major in aligned rows
+    struct LaneKeys {
+        const uint32_t *lk;
+
+        __m256i operator[](const size_t j) const {
+            return _mm256_load_si256(reinterpret_cast<const __m256i *>(lk + LANES * j));
+        }
+    };
+
+    // Encrypt N vectors of LANES blocks each, interleaved to hide multiply latency
+    template<size_t N, typename Keys>
+    inline void encryptGroup(const Keys &rk, const uint8_t rounds, const uint8_t *in, uint8_t *out) {
+        __m256i a[N], b[N], c[N], d[N];
+        for (size_t g = 0; g < N; ++g) {
+            load(in + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+            b[g] = _mm256_add_epi32(b[g], rk[0]);
+            d[g] = _mm256_add_epi32(d[g], rk[1]);
+        }
+
+        for (size_t i = 1; i <= rounds; ++i) {
+            const __m256i ka = rk[2 * i];
+            const __m256i kc = rk[2 * i + 1];
+            for (size_t g = 0; g < N; ++g) {
+                const __m256i t = mix(b[g]);
+                const __m256i u = mix(d[g]);
+                const __m256i na = _mm256_add_epi32(rotlv(_mm256_xor_si256(a[g], t), u), ka);
+                const __m256i nc = _mm256_add_epi32(rotlv(_mm256_xor_si256(c[g], u), t), kc);
+                a[g] = b[g];
+                b[g] = nc;
+                c[g] = d[g];
+                d[g] = na;
+            }
+        }
+
+        for (size_t g = 0; g < N; ++g) {
+            a[g] = _mm256_add_epi32(a[g], rk[2 * rounds + 2]);
+            c[g] = _mm256_add_epi32(c[g], rk[2 * rounds + 3]);
+            store(out + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+        }
+    }
+
+    // Decrypt N vectors of LANES blocks each, interleaved to hide multiply latency
+    template<size_t N, typename Keys>
+    inline void decryptGroup(const Keys &rk, const uint8_t rounds, const uint8_t *in, uint8_t *out) {
+        __m256i a[N], b[N], c[N], d[N];
+        for (size_t g = 0; g < N; ++g) {
+            load(in + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+            c[g] = _mm256_sub_epi32(c[g], rk[2 * rounds + 3]);
+            a[g] = _mm256_sub_epi32(a[g], rk[2 * rounds + 2]);
+        }
+
+        for (size_t i = rounds; i > 0; --i) {
+            const __m256i ka = rk[2 * i];
+            const __m256i kc = rk[2 * i + 1];
+            for (size_t g = 0; g < N; ++g) {
+                const __m256i pa = d[g];
+                const __m256i pc = b[g];
+                b[g] = a[g];
+                d[g] = c[g];
+                const __m256i u = mix(d[g]);
+                const __m256i t = mix(b[g]);
+                c[g] = _mm256_xor_si256(rotrv(_mm256_sub_epi32(pc, kc), t), u);
+                a[g] = _mm256_xor_si256(rotrv(_mm256_sub_epi32(pa, ka), u), t);
+            }
+        }
+
+        for (size_t g = 0; g < N; ++g) {
+            d[g] = _mm256_sub_epi32(d[g], rk[1]);
+            b[g] = _mm256_sub_epi32(b[g], rk[0]);
+            store(out + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+        }
+    }
+
+    template<typename Keys>
+    size_t encryptBlocksWith(const Keys &keys, const uint8_t rounds, const void *in, void *out, const size_t nblocks) {
+        const auto *src = static_cast<const uint8_t *>(in);
+        auto *dst = static_cast<uint8_t *>(out);
+        size_t n = 0;
+        for (; n + 2 * LANES <= nblocks; n += 2 * LANES) {
+            encryptGroup<2>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        for (; n + LANES <= nblocks; n += LANES) {
+            encryptGroup<1>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        return n;
+    }
+
+    size_t encryptBlocksAVX2(const uint32_t *round_keys, const uint8_t rounds,
+                             const void *in, void *out, const size_t nblocks) {
+        return encryptBlocksWith(SharedKeys{round_keys}, rounds, in, out, nblocks);
+    }
+
+    size_t encryptLanesAVX2(const uint32_t *lane_keys, const uint8_t rounds,
+                            const void *in, void *out, const size_t nblocks) {
+        return encryptBlocksWith(LaneKeys{lane_keys}, rounds, in, out, nblocks);
+    }
+
+    template<typename Keys>
+    size_t decryptBlocksWith(const Keys &keys, const uint8_t rounds, const void *in, void *out, const size_t nblocks) {
+        const auto *src = static_cast<const uint8_t *>(in);
+        auto *dst = static_cast<uint8_t *>(out);
+        size_t n = 0;
+        for (; n + 2 * LANES <= nblocks; n += 2 * LANES) {
+            decryptGroup<2>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        for (; n + LANES <= nblocks; n += LANES) {
+            decryptGroup<1>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        return n;
+    }
+
+    size_t decryptBlocksAVX2(const uint32_t *round_keys, const uint8_t rounds,
+                             const void *in, void *out, const size_t nblocks) {
+        return decryptBlocksWith(SharedKeys{round_keys}, rounds, in, out, nblocks);
+    }
+
+    size_t decryptLanesAVX2(const uint32_t *lane_keys, const uint8_t rounds,
+                            const void *in, void *out, const size_t nblocks) {
+        return decryptBlocksWith(LaneKeys{lane_keys}, rounds, in, out, nblocks);
+    }
+
+    void mixKeysAVX2(uint32_t *s, uint32_t *l, const uint16_t key_size, const uint16_t c) {
+        __m256i a = _mm256_setzero_si256();
+        __m256i b = _mm256_setzero_si256();
+        uint16_t i = 0, j = 0;
+        const uint32_t steps = 3u * (c > key_size ? c : key_size);
+
+        for (uint32_t p = 0; p < steps; ++p) {
+            const __m256i x = _mm256_add_epi32(_mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + LANES * i)), a), b);
+            a = _mm256_or_si256(_mm256_slli_epi32(x, 3), _mm256_srli_epi32(x, 29));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(s + LANES * i), a);
+
+            const __m256i ab = _mm256_add_epi32(a, b);
+            b = rotlv(_mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(l + LANES * j)), ab), ab);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(l + LANES * j), b);
+
+            if (++i == key_size) {
+                i = 0;
+            }
+            if (++j == c) {
+                j = 0;
+            }
+        }
+    }
+
+    // The in-lane transpose puts block 2m + L of a group in element 4L + m
+    const uint8_t LANE_ORDER[LANES] = {0, 4, 1, 5, 2, 6, 3, 7};
+
+    const rc6_kernels::Backend AVX2_BACKEND = {
+        "avx2", rc6_kernels::BACKEND_AVX2, LANES, encryptBlocksAVX2, decryptBlocksAVX2, mixKeysAVX2,
+        encryptLanesAVX2, decryptLanesAVX2, LANE_ORDER
+    };
+}
+
+const rc6_kernels::Backend *rc6_kernels::avx2Backend() {
+    return &AVX2_BACKEND;
+}
+
+#else
+
+const rc6_kernels::Backend *rc6_kernels::avx2Backend() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,250 @@
+/**
+ * @file rc6_avx512.cpp
+ * @brief AVX-512F implementation of the RC6 bulk kernels.
+ *
+ * Each 512-bit vector holds one word of sixteen blocks. AVX-512F provides
+ * native variable rotates (vprolvd/vprorvd), so the round function maps
+ * almost one to one onto instructions. This file is compiled with AVX-512F
+ * enabled and is only called after a runtime CPU check.
+ */
+#include "rc6_kernels.hpp"
+
+#if defined(__AVX512F__)
+#define RC6_KERNEL_AVX512 1
+#endif
+
+#ifdef RC6_KERNEL_AVX512
+
+// GCC's AVX-512 headers build the unpack intrinsics on _mm512_undefined_epi32(),
+// which -Wall reports as uninitialized wherever they are inlined
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <immintrin.h>
+
+namespace {
+    constexpr size_t LANES = 16;
+
+    // f(x) = (x * (2x + 1)) <<< 5
+    inline __m512i mix(const __m512i x) {
+        const __m512i p = _mm512_mullo_epi32(x, _mm512_add_epi32(_mm512_add_epi32(x, x), _mm512_set1_epi32(1)));
+        return _mm512_rol_epi32(p, 5);
+    }
+
+    inline __m512i rotlv(const __m512i x, const __m512i n) {
+        return _mm512_rolv_epi32(x, n);
+    }
+
+    inline __m512i rotrv(const __m512i x, const __m512i n) {
+        return _mm512_rorv_epi32(x, n);
+    }
+
+    // 4x4 transpose within each 128-bit lane between block order and A/B/C/D words
+    inline void transpose(__m512i &r0, __m512i &r1, __m512i &r2, __m512i &r3) {
+        const __m512i t0 = _mm512_unpacklo_epi32(r0, r1);
+        const __m512i t1 = _mm512_unpackhi_epi32(r0, r1);
+        const __m512i t2 = _mm512_unpacklo_epi32(r2, r3);
+        const __m512i t3 = _mm512_unpackhi_epi32(r2, r3);
+        r0 = _mm512_unpacklo_epi64(t0, t2);
+        r1 = _mm512_unpackhi_epi64(t0, t2);
+        r2 = _mm512_unpacklo_epi64(t1, t3);
+        r3 = _mm512_unpackhi_epi64(t1, t3);
+    }
+
+    inline void load(const uint8_t *in, __m512i &a, __m512i &b, __m512i &c, __m512i &d) {
+        a = _mm512_loadu_si512(in);
+        b = _mm512_loadu_si512(in + 64);
+        c = _mm512_loadu_si512(in + 128);
+        d = _mm512_loadu_si512(in + 192);
+        transpose(a, b, c, d);
+    }
+
+    inline void store(uint8_t *out, __m512i a, __m512i b, __m512i c, __m512i d) {
+        transpose(a, b, c, d);
+        _mm512_storeu_si512(out, a);
+        _mm512_storeu_si512(out + 64, b);
+        _mm512_storeu_si512(out + 128, c);
+        _mm512_storeu_si512(out + 192, d);
+    }
+
+    // Round key j of every lane: one schedule broadcast to all lanes
+    struct SharedKeys {
+        const uint32_t *rk;
+
+        __m512i operator[](const size_t j) const {
+            return _mm512_set1_epi32(static_cast<int>(rk[j]));
+        }
+    };
+
+    // Round key j of every lane: one schedule per lane, stored word-major in aligned rows
+    struct LaneKeys {
+        const uint32_t *lk;
+
+        __m512i operator[](const size_t j) const {
+            return _mm512_load_si512(lk + LANES * j);
+        }
+    };
+
+    // Encrypt N vectors of LANES blocks each, interleaved to hide multiply latency
+    template<size_t N, typename Keys>
+    inline void encryptGroup(const Keys &rk, const uint8_t rounds, const uint8_t *in, uint8_t *out) {
+        __m512i a[N], b[N], c[N], d[N];
+        for (size_t g = 0; g < N; ++g) {
+            load(in + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+            b[g] = _mm512_add_epi32(b[g], rk[0]);
+            d[g] = _mm512_add_epi32(d[g], rk[1]);
+        }
+
+        for (size_t i = 1; i <= rounds; ++i) {
+            const __m512i ka = rk[2 * i];
+            const __m512i kc = rk[2 * i + 1];
+            for (size_t g = 0; g < N; ++g) {
+                const __m512i t = mix(b[g]);
+                const __m512i u = mix(d[g]);
+                const __m512i na = _mm512_add_epi32(rotlv(_mm512_xor_si512(a[g], t), u), ka);
+                const __m512i nc = _mm512_add_epi32(rotlv(_mm512_xor_si512(c[g], u), t), kc);
+                a[g] = b[g];
+                b[g] = nc;
+                c[g] = d[g];
+                d[g] = na;
+            }
+        }
+
+        for (size_t g = 0; g < N; ++g) {
+            a[g] = _mm512_add_epi32(a[g], rk[2 * rounds + 2]);
+            c[g] = _mm512_add_epi32(c[g], rk[2 * rounds + 3]);
+            store(out + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+        }
+    }
+
+    // Decrypt N vectors of LANES blocks each, interleaved to hide multiply latency
+    template<size_t N, typename Keys>
+    inline void decryptGroup(const Keys &rk, const uint8_t rounds, const uint8_t *in, uint8_t *out) {
+        __m512i a[N], b[N], c[N], d[N];
+        for (size_t g = 0; g < N; ++g) {
+            load(in + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+            c[g] = _mm512_sub_epi32(c[g], rk[2 * rounds + 3]);
+            a[g] = _mm512_sub_epi32(a[g], rk[2 * rounds + 2]);
+        }
+
+        for (size_t i = rounds; i > 0; --i) {
+            const __m512i ka = rk[2 * i];
+            const __m512i kc = rk[2 * i + 1];
+            for (size_t g = 0; g < N; ++g) {
+                const __m512i pa = d[g];
+                const __m512i pc = b[g];
+                b[g] = a[g];
+                d[g] = c[g];
+                const __m512i u = mix(d[g]);
+                const __m512i t = mix(b[g]);
+                c[g] = _mm512_xor_si512(rotrv(_mm512_sub_epi32(pc, kc), t), u);
+                a[g] = _mm512_xor_si512(rotrv(_mm512_sub_epi32(pa, ka), u), t);
+            }
+        }
+
+        for (size_t g = 0; g < N; ++g) {
+            d[g] = _mm512_sub_epi32(d[g], rk[1]);
+            b[g] = _mm512_sub_epi32(b[g], rk[0]);
+            store(out + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+        }
+    }
+
+    template<typename Keys>
+    size_t encryptBlocksWith(const Keys &keys, const uint8_t rounds, const void *in, void *out, const size_t nblocks) {
+        const auto *src = static_cast<const uint8_t *>(in);
+        auto *dst = static_cast<uint8_t *>(out);
+        size_t n = 0;
+        for (; n + 2 * LANES <= nblocks; n += 2 * LANES) {
+            encryptGroup<2>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        for (; n + LANES <= nblocks; n += LANES) {
+            encryptGroup<1>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        return n;
+    }
+
+    size_t encryptBlocksAVX512(const uint32_t *round_keys, const uint8_t rounds,
+                               const void *in, void *out, const size_t nblocks) {
+        return encryptBlocksWith(SharedKeys{round_keys}, rounds, in, out, nblocks);
+    }
+
+    size_t encryptLanesAVX512(const uint32_t *lane_keys, const uint8_t rounds,
+                              const void *in, void *out, const size_t nblocks) {
+        return encryptBlocksWith(LaneKeys{lane_keys}, rounds, in, out, nblocks);
+    }
+
+    template<typename Keys>
+    size_t decryptBlocksWith(const Keys &keys, const uint8_t rounds, const void *in, void *out, const size_t nblocks) {
+        const auto *src = static_cast<const uint8_t *>(in);
+        auto *dst = static_cast<uint8_t *>(out);
+        size_t n = 0;
+        for (; n + 2 * LANES <= nblocks; n += 2 * LANES) {
+            decryptGroup<2>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        for (; n + LANES <= nblocks; n += LANES) {
+            decryptGroup<1>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        return n;
+    }
+
+    size_t decryptBlocksAVX512(const uint32_t *round_keys, const uint8_t rounds,
+                               const void *in, void *out, const size_t nblocks) {
+        return decryptBlocksWith(SharedKeys{round_keys}, rounds, in, out, nblocks);
+    }
+
+    size_t decryptLanesAVX512(const uint32_t *lane_keys, const uint8_t rounds,
+                              const void *in, void *out, const size_t nblocks) {
+        return decryptBlocksWith(LaneKeys{lane_keys}, rounds, in, out, nblocks);
+    }
+
+    void mixKeysAVX512(uint32_t *s, uint32_t *l, const uint16_t key_size, const uint16_t c) {
+        __m512i a = _mm512_setzero_si512();
+        __m512i b = _mm512_setzero_si512();
+        uint16_t i = 0, j = 0;
+        const uint32_t steps = 3u * (c > key_size ? c : key_size);
+
+        for (uint32_t p = 0; p < steps; ++p) {
+            const __m512i x = _mm512_add_epi32(_mm512_add_epi32(_mm512_loadu_si512(s + LANES * i), a), b);
+            a = _mm512_rol_epi32(x, 3);
+            _mm512_storeu_si512(s + LANES * i, a);
+
+            const __m512i ab = _mm512_add_epi32(a, b);
+            b = rotlv(_mm512_add_epi32(_mm512_loadu_si512(l + LANES * j), ab), ab);
+            _mm512_storeu_si512(l + LANES * j, b);
+
+            if (++i == key_size) {
+                i = 0;
+            }
+            if (++j == c) {
+                j = 0;
+            }
+        }
+    }
+
+    // The in-lane transpose puts block 4m + L of a group in element 4L + m
+    const uint8_t LANE_ORDER[LANES] = {0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15};
+
+    const rc6_kernels::Backend AVX512_BACKEND = {
+        "avx512", rc6_kernels::BACKEND_AVX512, LANES, encryptBlocksAVX512, decryptBlocksAVX512, mixKeysAVX512,
+        encryptLanesAVX512, decryptLanesAVX512, LANE_ORDER
+    };
+}
+
+const rc6_kernels::Backend *rc6_kernels::avx512Backend() {
+    return &AVX512_BACKEND;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#else
+
+const rc6_kernels::Backend *rc6_kernels::avx512Backend() {
+    return nullptr;
+}
+
+#endif
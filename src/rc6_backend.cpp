@@ -0,0 +1,58 @@
+/**
+ * @file rc6_backend.cpp
+ * @brief Implementation file for inspecting and selecting the RC6 bulk kernel backends.
+ *
+ * This file provides the implementation of the backend interface as
+ * defined in the rc6_backend.hpp header file, on top of the dispatcher in
+ * rc6_dispatch.cpp.
+ */
+#include <stdexcept>
+
+#include "rc6_backend.hpp"
+#include "rc6_kernels.hpp"
+
+/**
+ * @brief Get the backends supported by this CPU.
+ * @return Backend names, from the widest to the narrowest.
+ */
+std::vector<std::string> RC6Backend::available() {
+    std::vector<std::string> names;
+    for (size_t i = 0; rc6_kernels::supportedBackend(i) != nullptr; ++i) {
+        names.push_back(rc6_kernels::supportedBackend(i)->name);
+    }
+    return names;
+}
+
+/**
+ * @brief Get the widest backend used by bulk operations.
+ * @return The forced backend, or the first one of the automatic selection.
+ */
+std::string RC6Backend::active() {
+    return rc6_kernels::activeBackend()->name;
+}
+
+/**
+ * @brief Check whether a backend has been forced.
+ * @return True if bulk operations are pinned to one backend.
+ */
+bool RC6Backend::isForced() {
+    return rc6_kernels::isBackendForced();
+}
+
+/**
+ * @brief Pin all bulk operations to one backend.
+ * @param name Name of an available backend, or "auto".
+ * @throws std::invalid_argument if the backend is unknown or not supported by this CPU.
+ */
+void RC6Backend::force(const std::string &name) {
+    if (!rc6_kernels::forceBackend(name.c_str())) {
+        throw std::invalid_argument("Unknown or unsupported backend: " + name);
+    }
+}
+
+/**
+ * @brief Restore the automatic selection.
+ */
+void RC6Backend::reset() {
+    rc6_kernels::forceBackend(nullptr);
+}
@@ -0,0 +1,135 @@
+/**
+ * @file rc6_batch.cpp
+ * @brief Implementation file for batched processing of many small RC6 messages.
+ *
+ * This file provides the implementation of the batch interface as defined
+ * in the rc6_batch.hpp header file.
+ */
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "rc6_batch.hpp"
+#include "rc6_util.hpp"
+
+constexpr size_t RC6Batch::BLOCK_SIZE;
+constexpr size_t RC6Batch::BATCH_BLOCKS;
+constexpr size_t RC6Batch::MAX_LANES;
+
+namespace {
+    void increment(uint8_t *block) {
+        for (size_t i = RC6Batch::BLOCK_SIZE; i-- > 0;) {
+            if (++block[i] != 0) {
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Job currently assigned to a kernel lane.
+     */
+    struct Lane {
+        const RC6Batch::Job *job; //!< The job, or null once the batch is exhausted
+        size_t offset; //!< Byte offset of the lane's next block within the job
+        uint8_t counter[RC6Batch::BLOCK_SIZE]; //!< Counter block at offset
+    };
+
+    /**
+     * @brief Origin of one keystream block.
+     */
+    struct Slot {
+        const RC6Batch::Job *job; //!< The job
+        size_t offset; //!< Byte offset within the job, a multiple of 16
+    };
+}
+
+/**
+ * @brief Encrypt or decrypt an array of CTR messages.
+ *
+ * Each kernel lane works through its own job: the next block of every lane
+ * is appended in turn, so block i and block i + lanes of the buffer belong
+ * to the same job and the lane keeps its schedule across groups. A lane
+ * whose job is done takes the next one. Each full buffer of up to
+ * BATCH_BLOCKS counter blocks is encrypted with one many-keys bulk call
+ * before the keystream is applied.
+ *
+ * @param jobs Array of count jobs.
+ * @param count Number of jobs.
+ * @throws std::invalid_argument if jobs is null and count is non-zero, or
+ *         if a non-empty job has a null cipher, in or out pointer.
+ * @throws std::runtime_error if a non-empty job's cipher is not initialized.
+ */
+void RC6Batch::processCTR(const Job *jobs, const size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    if (jobs == nullptr) {
+        throw std::invalid_argument("Jobs cannot be null");
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (jobs[i].len == 0) {
+            continue;
+        }
+        if (jobs[i].cipher == nullptr || jobs[i].in == nullptr || jobs[i].out == nullptr) {
+            throw std::invalid_argument("Data cannot be null");
+        }
+        if (!jobs[i].cipher->isInitialized()) {
+            throw std::runtime_error("RC6 not initialized");
+        }
+    }
+
+    // BATCH_BLOCKS is a multiple of every lane count, so lanes stay aligned across buffers
+    const size_t lane_count = std::min(RC6::bulkLanes(), MAX_LANES);
+    Lane lanes[MAX_LANES] = {};
+    uint8_t keystream[BATCH_BLOCKS * BLOCK_SIZE];
+    const RC6 *ciphers[BATCH_BLOCKS];
+    Slot slots[BATCH_BLOCKS];
+    size_t next = 0;
+
+    for (;;) {
+        size_t filled = 0;
+        for (bool active = true; active && filled < BATCH_BLOCKS;) {
+            active = false;
+            for (size_t k = 0; k < lane_count && filled < BATCH_BLOCKS; ++k) {
+                Lane &lane = lanes[k];
+                if (lane.job == nullptr || lane.offset >= lane.job->len) {
+                    while (next < count && jobs[next].len == 0) {
+                        ++next;
+                    }
+                    if (next == count) {
+                        lane.job = nullptr;
+                        continue;
+                    }
+                    lane.job = &jobs[next++];
+                    lane.offset = 0;
+                    std::memcpy(lane.counter, lane.job->iv, BLOCK_SIZE);
+                }
+
+                std::memcpy(keystream + BLOCK_SIZE * filled, lane.counter, BLOCK_SIZE);
+                ciphers[filled] = lane.job->cipher;
+                slots[filled] = Slot{lane.job, lane.offset};
+                increment(lane.counter);
+                lane.offset += BLOCK_SIZE;
+                ++filled;
+                active = true;
+            }
+        }
+
+        if (filled == 0) {
+            break;
+        }
+
+        RC6::encryptBlocksManyUnchecked(ciphers, keystream, keystream, filled);
+
+        for (size_t n = 0; n < filled; ++n) {
+            const Slot &slot = slots[n];
+            rc6_util::xorBytes(static_cast<uint8_t *>(slot.job->out) + slot.offset,
+                               static_cast<const uint8_t *>(slot.job->in) + slot.offset,
+                               keystream + BLOCK_SIZE * n, std::min(BLOCK_SIZE, slot.job->len - slot.offset));
+        }
+    }
+
+    rc6_util::secureZero(keystream, sizeof(keystream));
+}
@@ -0,0 +1,695 @@
+/**
+ * @file rc6_c.cpp
+ * @brief Implementation file for the C interface of the RC6 library.
+ *
+ * Each function checks its arguments, maps them to the C++ classes and
+ * catches every exception at the boundary, so no C++ exception reaches a
+ * C or foreign caller. The checks mirror those of the C++ API, which still
+ * runs its own and is the fallback for anything missed here.
+ */
+#include <new>
+#include <stdexcept>
+
+#include "rc6.h"
+#include "rc6.hpp"
+#include "rc6_cbc.hpp"
+#include "rc6_ctr.hpp"
+#include "rc6_kernels.hpp"
+#include "rc6_ocb.hpp"
+#include "rc6_stream.hpp"
+#include "rc6_xts.hpp"
+
+/**
+ * @brief Keyed cipher behind an rc6_ctx handle.
+ *
+ * The OCB object for full-length tags is built once here, since it holds
+ * the encrypted L table; shorter tags build a temporary one per call.
+ */
+struct rc6_ctx {
+    RC6 cipher; //!< Expanded key schedule
+    RC6CBC cbc; //!< CBC mode over cipher
+    RC6OCB ocb; //!< OCB mode over cipher with 16-byte tags
+
+    rc6_ctx(const void *key, const uint16_t key_bits, const uint8_t rounds)
+        : cipher(keyedCipher(key, key_bits, rounds)), cbc(cipher), ocb(cipher) {
+    }
+
+    /**
+     * @brief Expand a key into a new cipher.
+     * @param key Pointer to the key.
+     * @param key_bits Key length in bits.
+     * @param rounds Number of rounds.
+     * @return The keyed cipher.
+     */
+    static RC6 keyedCipher(const void *key, const uint16_t key_bits, const uint8_t rounds) {
+        RC6 cipher(rounds);
+        cipher.init(key, key_bits);
+        return cipher;
+    }
+};
+
+/**
+ * @brief XTS cipher pair behind an rc6_xts handle.
+ */
+struct rc6_xts {
+    RC6XTS xts; //!< Data and tweak schedules
+
+    rc6_xts(const void *key, const uint16_t key_bits, const uint8_t rounds) : xts(key, key_bits, rounds) {
+    }
+};
+
+/**
+ * @brief Stream state behind an rc6_stream handle.
+ */
+struct rc6_stream {
+    RC6Stream stream; //!< Incremental mode state
+    bool finished; //!< Set once rc6_stream_final() has been called
+
+    rc6_stream(const RC6 &cipher, const RC6Stream::Mode mode, const RC6Stream::Direction direction,
+               const void *iv, const bool padding)
+        : stream(cipher, mode, direction, iv, padding), finished(false) {
+    }
+};
+
+namespace {
+    /**
+     * @brief Run a call and translate any exception into a status code.
+     *
+     * Arguments are checked before the call, so an invalid_argument that
+     * still escapes means the C++ layer rejected a length and a runtime_error
+     * means a state the checks did not cover.
+     *
+     * @param body Callable returning the status of a call that completed.
+     * @return Status of the call.
+     */
+    template<typename Body>
+    rc6_status guarded(const Body &body) noexcept {
+        try {
+            return body();
+        } catch (const std::bad_alloc &) {
+            return RC6_ERROR_OUT_OF_MEMORY;
+        } catch (const std::invalid_argument &) {
+            return RC6_ERROR_INVALID_LENGTH;
+        } catch (...) {
+            return RC6_ERROR_INTERNAL;
+        }
+    }
+
+    /**
+     * @brief Check a data buffer pair.
+     * @param in Input pointer.
+     * @param out Output pointer.
+     * @param len Buffer length in bytes.
+     * @return True if both pointers are set or len is zero.
+     */
+    bool buffersValid(const void *in, const void *out, const size_t len) {
+        return len == 0 || (in != nullptr && out != nullptr);
+    }
+
+    /**
+     * @brief Check the arguments shared by both OCB directions.
+     * @return RC6_OK or the status to return.
+     */
+    rc6_status checkOCB(const rc6_ctx *ctx, const void *nonce, const size_t nonce_len, const void *ad,
+                        const size_t ad_len, const void *in, const size_t len, const void *out,
+                        const void *tag, const size_t tag_len) {
+        if (ctx == nullptr || nonce == nullptr || tag == nullptr || (ad_len != 0 && ad == nullptr) ||
+            !buffersValid(in, out, len)) {
+            return RC6_ERROR_NULL_POINTER;
+        }
+
+        if (nonce_len == 0 || nonce_len > RC6OCB::MAX_NONCE_SIZE ||
+            tag_len == 0 || tag_len > RC6OCB::MAX_TAG_SIZE) {
+            return RC6_ERROR_INVALID_LENGTH;
+        }
+
+        return RC6_OK;
+    }
+
+    /**
+     * @brief Check the key arguments shared by rc6_ctx_new() and rc6_xts_new().
+     * @return RC6_OK or the status to return.
+     */
+    rc6_status checkKey(const void *handle, const void *key, const size_t key_bits, const size_t max_bits,
+                        const unsigned rounds) {
+        if (handle == nullptr || key == nullptr) {
+            return RC6_ERROR_NULL_POINTER;
+        }
+
+        if (key_bits == 0 || key_bits > max_bits) {
+            return RC6_ERROR_INVALID_KEY;
+        }
+
+        if (rounds > RC6::MAX_ROUNDS) {
+            return RC6_ERROR_INVALID_ROUNDS;
+        }
+
+        return RC6_OK;
+    }
+}
+
+/**
+ * @brief Get the version of the interface the library implements.
+ * @return RC6_ABI_VERSION of the library at build time.
+ */
+unsigned rc6_abi_version(void) {
+    return RC6_ABI_VERSION;
+}
+
+/**
+ * @brief Describe a status code.
+ * @param status Status returned by any rc6_* function.
+ * @return Static, NUL-terminated English description; "Unknown status" for
+ *         values outside rc6_status.
+ */
+const char *rc6_status_string(const rc6_status status) {
+    switch (status) {
+        case RC6_OK:
+            return "Success";
+        case RC6_ERROR_NULL_POINTER:
+            return "A required pointer is null";
+        case RC6_ERROR_INVALID_KEY:
+            return "Invalid key";
+        case RC6_ERROR_INVALID_ROUNDS:
+            return "Number of rounds must be between 0 and 125";
+        case RC6_ERROR_INVALID_LENGTH:
+            return "Invalid length";
+        case RC6_ERROR_AUTHENTICATION:
+            return "Authentication failed";
+        case RC6_ERROR_BAD_PADDING:
+            return "Incomplete input or invalid padding";
+        case RC6_ERROR_STATE:
+            return "Stream already finished";
+        case RC6_ERROR_INVALID_ARGUMENT:
+            return "Invalid argument";
+        case RC6_ERROR_OUT_OF_MEMORY:
+            return "Out of memory";
+        case RC6_ERROR_INTERNAL:
+            return "Internal error";
+    }
+    return "Unknown status";
+}
+
+/**
+ * @brief Get the name of the bulk kernel backend in use.
+ *
+ * Reflects the backend active at the time of the call, which can change
+ * through RC6Backend::force() or the RC6_BACKEND environment variable.
+ *
+ * @return Static, NUL-terminated backend name, such as "avx2" or "scalar".
+ */
+const char *rc6_backend_name(void) {
+    return rc6_kernels::activeBackend()->name;
+}
+
+/**
+ * @brief Create a keyed context.
+ * @param ctx Receives the new context, or null on failure.
+ * @param key Pointer to key_bits / 8 bytes of key.
+ * @param key_bits Key length in bits (1 to RC6_MAX_KEY_BITS).
+ * @param rounds Number of rounds (0 to RC6_MAX_ROUNDS, normally RC6_DEFAULT_ROUNDS).
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER, RC6_ERROR_INVALID_KEY,
+ *         RC6_ERROR_INVALID_ROUNDS or RC6_ERROR_OUT_OF_MEMORY.
+ */
+rc6_status rc6_ctx_new(rc6_ctx **ctx, const void *key, const size_t key_bits, const unsigned rounds) {
+    if (ctx != nullptr) {
+        *ctx = nullptr;
+    }
+
+    const rc6_status status = checkKey(ctx, key, key_bits, RC6::MAX_KEY_BITS, rounds);
+    if (status != RC6_OK) {
+        return status;
+    }
+
+    return guarded([&] {
+        *ctx = new rc6_ctx(key, static_cast<uint16_t>(key_bits), static_cast<uint8_t>(rounds));
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Wipe and free a context.
+ * @param ctx Context, or null.
+ */
+void rc6_ctx_free(rc6_ctx *ctx) {
+    delete ctx;
+}
+
+/**
+ * @brief Encrypt consecutive blocks independently (ECB).
+ * @param ctx Context.
+ * @param in Pointer to len bytes of plaintext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes; a multiple of RC6_BLOCK_SIZE.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+rc6_status rc6_ecb_encrypt(const rc6_ctx *ctx, const void *in, void *out, const size_t len) {
+    if (ctx == nullptr || !buffersValid(in, out, len)) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    if (len % RC6_BLOCK_SIZE != 0) {
+        return RC6_ERROR_INVALID_LENGTH;
+    }
+
+    ctx->cipher.encryptBlocksUnchecked(in, out, len / RC6_BLOCK_SIZE);
+    return RC6_OK;
+}
+
+/**
+ * @brief Decrypt consecutive blocks independently (ECB).
+ * @param ctx Context.
+ * @param in Pointer to len bytes of ciphertext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes; a multiple of RC6_BLOCK_SIZE.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+rc6_status rc6_ecb_decrypt(const rc6_ctx *ctx, const void *in, void *out, const size_t len) {
+    if (ctx == nullptr || !buffersValid(in, out, len)) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    if (len % RC6_BLOCK_SIZE != 0) {
+        return RC6_ERROR_INVALID_LENGTH;
+    }
+
+    ctx->cipher.decryptBlocksUnchecked(in, out, len / RC6_BLOCK_SIZE);
+    return RC6_OK;
+}
+
+/**
+ * @brief Encrypt or decrypt in counter mode at a byte offset of the keystream.
+ *
+ * The counter is the whole 16-byte block, incremented big-endian. The call
+ * keeps no state, so a message may be processed in pieces, in any order or
+ * from several threads, by passing the offset of each piece.
+ *
+ * @param ctx Context.
+ * @param iv Pointer to the 16-byte initial counter block.
+ * @param offset Position of in within the message, in bytes.
+ * @param in Pointer to len bytes of input.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes.
+ * @return RC6_OK or RC6_ERROR_NULL_POINTER.
+ */
+rc6_status rc6_ctr_crypt(const rc6_ctx *ctx, const void *iv, const uint64_t offset,
+                         const void *in, void *out, const size_t len) {
+    if (ctx == nullptr || iv == nullptr || !buffersValid(in, out, len)) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    return guarded([&] {
+        RC6CTR(ctx->cipher, iv).processAt(offset, in, out, len);
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Encrypt blocks of one CBC message.
+ * @param ctx Context.
+ * @param iv Pointer to the 16-byte chaining value; updated on return, so a
+ *           message may be encrypted in pieces.
+ * @param in Pointer to len bytes of plaintext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes; a multiple of RC6_BLOCK_SIZE.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+rc6_status rc6_cbc_encrypt(const rc6_ctx *ctx, void *iv, const void *in, void *out, const size_t len) {
+    if (ctx == nullptr || iv == nullptr || !buffersValid(in, out, len)) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    if (len % RC6_BLOCK_SIZE != 0) {
+        return RC6_ERROR_INVALID_LENGTH;
+    }
+
+    return guarded([&] {
+        ctx->cbc.encrypt(iv, in, out, len / RC6_BLOCK_SIZE);
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Decrypt blocks of one CBC message.
+ * @param ctx Context.
+ * @param iv Pointer to the 16-byte chaining value; updated on return.
+ * @param in Pointer to len bytes of ciphertext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes; a multiple of RC6_BLOCK_SIZE.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+rc6_status rc6_cbc_decrypt(const rc6_ctx *ctx, void *iv, const void *in, void *out, const size_t len) {
+    if (ctx == nullptr || iv == nullptr || !buffersValid(in, out, len)) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    if (len % RC6_BLOCK_SIZE != 0) {
+        return RC6_ERROR_INVALID_LENGTH;
+    }
+
+    return guarded([&] {
+        ctx->cbc.decrypt(iv, in, out, len / RC6_BLOCK_SIZE);
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Encrypt and authenticate a message with OCB (RFC 7253).
+ * @param ctx Context.
+ * @param nonce Pointer to the nonce; never reuse one with the same key.
+ * @param nonce_len Nonce length in bytes (1 to RC6_MAX_NONCE_SIZE).
+ * @param ad Pointer to the associated data; may be null if ad_len is zero.
+ * @param ad_len Associated data length in bytes.
+ * @param in Pointer to len bytes of plaintext.
+ * @param len Message length in bytes.
+ * @param out Pointer to len bytes of ciphertext. Must either equal in or not overlap it.
+ * @param tag Pointer to tag_len bytes receiving the tag.
+ * @param tag_len Tag length in bytes (1 to RC6_MAX_TAG_SIZE).
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+rc6_status rc6_ocb_encrypt(const rc6_ctx *ctx, const void *nonce, const size_t nonce_len,
+                           const void *ad, const size_t ad_len, const void *in, const size_t len,
+                           void *out, void *tag, const size_t tag_len) {
+    const rc6_status status = checkOCB(ctx, nonce, nonce_len, ad, ad_len, in, len, out, tag, tag_len);
+    if (status != RC6_OK) {
+        return status;
+    }
+
+    return guarded([&] {
+        if (tag_len == RC6OCB::MAX_TAG_SIZE) {
+            ctx->ocb.encrypt(nonce, nonce_len, ad, ad_len, in, len, out, tag);
+        } else {
+            RC6OCB(ctx->cipher, tag_len).encrypt(nonce, nonce_len, ad, ad_len, in, len, out, tag);
+        }
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Verify and decrypt a message with OCB (RFC 7253).
+ * @param ctx Context.
+ * @param nonce Pointer to the nonce used for encryption.
+ * @param nonce_len Nonce length in bytes (1 to RC6_MAX_NONCE_SIZE).
+ * @param ad Pointer to the associated data; may be null if ad_len is zero.
+ * @param ad_len Associated data length in bytes.
+ * @param in Pointer to len bytes of ciphertext.
+ * @param len Message length in bytes.
+ * @param out Pointer to len bytes of plaintext. Must either equal in or not overlap it.
+ * @param tag Pointer to the tag_len-byte tag to check.
+ * @param tag_len Tag length in bytes (1 to RC6_MAX_TAG_SIZE).
+ * @return RC6_OK, RC6_ERROR_AUTHENTICATION, RC6_ERROR_NULL_POINTER or
+ *         RC6_ERROR_INVALID_LENGTH.
+ */
+rc6_status rc6_ocb_decrypt(const rc6_ctx *ctx, const void *nonce, const size_t nonce_len,
+                           const void *ad, const size_t ad_len, const void *in, const size_t len,
+                           void *out, const void *tag, const size_t tag_len) {
+    const rc6_status status = checkOCB(ctx, nonce, nonce_len, ad, ad_len, in, len, out, tag, tag_len);
+    if (status != RC6_OK) {
+        return status;
+    }
+
+    return guarded([&] {
+        const bool valid = tag_len == RC6OCB::MAX_TAG_SIZE
+                               ? ctx->ocb.decrypt(nonce, nonce_len, ad, ad_len, in, len, out, tag)
+                               : RC6OCB(ctx->cipher, tag_len).decrypt(nonce, nonce_len, ad, ad_len,
+                                                                      in, len, out, tag);
+        return valid ? RC6_OK : RC6_ERROR_AUTHENTICATION;
+    });
+}
+
+/**
+ * @brief Create a keyed XTS context.
+ * @param xts Receives the new context, or null on failure.
+ * @param key Pointer to the XTS key: the data key followed by the tweak key.
+ * @param key_bits Total key length in bits; a multiple of 16 up to
+ *                 2 * RC6_MAX_KEY_BITS, with two different halves.
+ * @param rounds Number of rounds (0 to RC6_MAX_ROUNDS, normally RC6_DEFAULT_ROUNDS).
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER, RC6_ERROR_INVALID_KEY,
+ *         RC6_ERROR_INVALID_ROUNDS or RC6_ERROR_OUT_OF_MEMORY.
+ */
+rc6_status rc6_xts_new(rc6_xts **xts, const void *key, const size_t key_bits, const unsigned rounds) {
+    if (xts != nullptr) {
+        *xts = nullptr;
+    }
+
+    const rc6_status status = checkKey(xts, key, key_bits, 2 * RC6::MAX_KEY_BITS, rounds);
+    if (status != RC6_OK) {
+        return status;
+    }
+
+    // The remaining key checks (odd halves, equal halves) are left to RC6XTS
+    try {
+        *xts = new rc6_xts(key, static_cast<uint16_t>(key_bits), static_cast<uint8_t>(rounds));
+        return RC6_OK;
+    } catch (const std::bad_alloc &) {
+        return RC6_ERROR_OUT_OF_MEMORY;
+    } catch (const std::invalid_argument &) {
+        return RC6_ERROR_INVALID_KEY;
+    } catch (...) {
+        return RC6_ERROR_INTERNAL;
+    }
+}
+
+/**
+ * @brief Wipe and free an XTS context.
+ * @param xts Context, or null.
+ */
+void rc6_xts_free(rc6_xts *xts) {
+    delete xts;
+}
+
+/**
+ * @brief Encrypt one data unit in XTS mode.
+ * @param xts Context.
+ * @param tweak Pointer to the 16-byte tweak of the data unit.
+ * @param in Pointer to len bytes of plaintext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes (at least RC6_BLOCK_SIZE).
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+rc6_status rc6_xts_encrypt(const rc6_xts *xts, const void *tweak, const void *in, void *out, const size_t len) {
+    if (xts == nullptr || tweak == nullptr || in == nullptr || out == nullptr) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    if (len < RC6_BLOCK_SIZE) {
+        return RC6_ERROR_INVALID_LENGTH;
+    }
+
+    return guarded([&] {
+        xts->xts.encrypt(tweak, in, out, len);
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Decrypt one data unit in XTS mode.
+ * @param xts Context.
+ * @param tweak Pointer to the 16-byte tweak of the data unit.
+ * @param in Pointer to len bytes of ciphertext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Length in bytes (at least RC6_BLOCK_SIZE).
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+rc6_status rc6_xts_decrypt(const rc6_xts *xts, const void *tweak, const void *in, void *out, const size_t len) {
+    if (xts == nullptr || tweak == nullptr || in == nullptr || out == nullptr) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    if (len < RC6_BLOCK_SIZE) {
+        return RC6_ERROR_INVALID_LENGTH;
+    }
+
+    return guarded([&] {
+        xts->xts.decrypt(tweak, in, out, len);
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Encrypt consecutive sectors in XTS mode.
+ *
+ * The tweak of sector first_sector + i is its number as a 16-byte
+ * little-endian value.
+ *
+ * @param xts Context.
+ * @param first_sector Number of the first sector.
+ * @param in Pointer to count * sector_size bytes of plaintext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param sector_size Sector size in bytes (at least RC6_BLOCK_SIZE).
+ * @param count Number of sectors.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+rc6_status rc6_xts_encrypt_sectors(const rc6_xts *xts, const uint64_t first_sector, const void *in,
+                                   void *out, const size_t sector_size, const size_t count) {
+    if (xts == nullptr || !buffersValid(in, out, count)) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    if (sector_size < RC6_BLOCK_SIZE) {
+        return RC6_ERROR_INVALID_LENGTH;
+    }
+
+    return guarded([&] {
+        xts->xts.encryptSectors(first_sector, in, out, sector_size, count);
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Decrypt consecutive sectors in XTS mode.
+ * @param xts Context.
+ * @param first_sector Number of the first sector.
+ * @param in Pointer to count * sector_size bytes of ciphertext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param sector_size Sector size in bytes (at least RC6_BLOCK_SIZE).
+ * @param count Number of sectors.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_INVALID_LENGTH.
+ */
+rc6_status rc6_xts_decrypt_sectors(const rc6_xts *xts, const uint64_t first_sector, const void *in,
+                                   void *out, const size_t sector_size, const size_t count) {
+    if (xts == nullptr || !buffersValid(in, out, count)) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    if (sector_size < RC6_BLOCK_SIZE) {
+        return RC6_ERROR_INVALID_LENGTH;
+    }
+
+    return guarded([&] {
+        xts->xts.decryptSectors(first_sector, in, out, sector_size, count);
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Create a stream context for incremental processing.
+ *
+ * The key context must stay alive until the stream is freed.
+ *
+ * @param stream Receives the new stream, or null on failure.
+ * @param ctx Key context.
+ * @param mode Mode of operation.
+ * @param direction Whether the stream encrypts or decrypts.
+ * @param iv Pointer to the 16-byte IV or initial counter block.
+ * @param padding Non-zero for PKCS#7 padding in CBC mode; ignored otherwise.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER, RC6_ERROR_INVALID_ARGUMENT or
+ *         RC6_ERROR_OUT_OF_MEMORY.
+ */
+rc6_status rc6_stream_new(rc6_stream **stream, const rc6_ctx *ctx, const rc6_stream_mode mode,
+                          const rc6_direction direction, const void *iv, const int padding) {
+    if (stream != nullptr) {
+        *stream = nullptr;
+    }
+
+    if (stream == nullptr || ctx == nullptr || iv == nullptr) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    RC6Stream::Mode stream_mode;
+    switch (mode) {
+        case RC6_STREAM_CBC:
+            stream_mode = RC6Stream::Mode::CBC;
+            break;
+        case RC6_STREAM_CTR:
+            stream_mode = RC6Stream::Mode::CTR;
+            break;
+        case RC6_STREAM_CFB:
+            stream_mode = RC6Stream::Mode::CFB;
+            break;
+        case RC6_STREAM_OFB:
+            stream_mode = RC6Stream::Mode::OFB;
+            break;
+        default:
+            return RC6_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (direction != RC6_ENCRYPT && direction != RC6_DECRYPT) {
+        return RC6_ERROR_INVALID_ARGUMENT;
+    }
+
+    const RC6Stream::Direction stream_direction =
+            direction == RC6_ENCRYPT ? RC6Stream::Direction::Encrypt : RC6Stream::Direction::Decrypt;
+
+    return guarded([&] {
+        *stream = new rc6_stream(ctx->cipher, stream_mode, stream_direction, iv, padding != 0);
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Wipe and free a stream context.
+ * @param stream Stream, or null.
+ */
+void rc6_stream_free(rc6_stream *stream) {
+    delete stream;
+}
+
+/**
+ * @brief Process a chunk of input.
+ *
+ * In CTR, CFB and OFB modes out may equal in and exactly len bytes are
+ * written. In CBC mode out must not overlap in, must have room for
+ * len + 15 bytes, and only complete blocks are written.
+ *
+ * @param stream Stream.
+ * @param in Pointer to len bytes of input.
+ * @param len Number of input bytes.
+ * @param out Pointer to the output buffer.
+ * @param written Receives the number of bytes written to out.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER or RC6_ERROR_STATE.
+ */
+rc6_status rc6_stream_update(rc6_stream *stream, const void *in, const size_t len, void *out, size_t *written) {
+    if (written != nullptr) {
+        *written = 0;
+    }
+
+    if (stream == nullptr || written == nullptr || !buffersValid(in, out, len)) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    if (stream->finished) {
+        return RC6_ERROR_STATE;
+    }
+
+    return guarded([&] {
+        *written = stream->stream.update(in, len, out);
+        return RC6_OK;
+    });
+}
+
+/**
+ * @brief Finish a stream.
+ *
+ * In CBC mode this adds or checks and removes the padding; out must have
+ * room for 16 bytes. No further calls but rc6_stream_free() are allowed.
+ *
+ * @param stream Stream.
+ * @param out Pointer to the output buffer.
+ * @param written Receives the number of bytes written to out.
+ * @return RC6_OK, RC6_ERROR_NULL_POINTER, RC6_ERROR_BAD_PADDING or RC6_ERROR_STATE.
+ */
+rc6_status rc6_stream_final(rc6_stream *stream, void *out, size_t *written) {
+    if (written != nullptr) {
+        *written = 0;
+    }
+
+    if (stream == nullptr || out == nullptr || written == nullptr) {
+        return RC6_ERROR_NULL_POINTER;
+    }
+
+    if (stream->finished) {
+        return RC6_ERROR_STATE;
+    }
+
+    // With the state checked above, a runtime_error can only be the padding
+    stream->finished = true;
+    try {
+        *written = stream->stream.final(out);
+        return RC6_OK;
+    } catch (const std::runtime_error &) {
+        return RC6_ERROR_BAD_PADDING;
+    } catch (...) {
+        return RC6_ERROR_INTERNAL;
+    }
+}
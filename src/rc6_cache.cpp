@@ -0,0 +1,214 @@
+/**
+ * @file rc6_cache.cpp
+ * @brief Implementation file for the RC6 key schedule cache.
+ *
+ * This file provides the implementation of the key schedule cache as
+ * defined in the rc6_cache.hpp header file.
+ */
+#include <stdexcept>
+#include <utility>
+
+#include "rc6_cache.hpp"
+
+constexpr size_t RC6KeyCache::MAX_SHARDS;
+constexpr size_t RC6KeyCache::MIN_SHARD_CAPACITY;
+
+/**
+ * @brief Constructor.
+ *
+ * Small caches use a single shard and therefore a single LRU order; larger
+ * ones are split into up to MAX_SHARDS shards sharing the capacity.
+ *
+ * @param capacity Maximum number of cached schedules.
+ * @param rounds Number of rounds of the cached ciphers.
+ * @throws std::invalid_argument if capacity is zero or rounds is greater than 125.
+ */
+RC6KeyCache::RC6KeyCache(const size_t capacity, const uint8_t rounds)
+    : rounds_(rounds), capacity_(capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("Cache capacity cannot be zero");
+    }
+
+    if (rounds > RC6::MAX_ROUNDS) {
+        throw std::invalid_argument("Number of rounds must be between 0 and 125");
+    }
+
+    size_t count = 1;
+    while (count < MAX_SHARDS && capacity / (2 * count) >= MIN_SHARD_CAPACITY) {
+        count *= 2;
+    }
+
+    std::vector<Shard> shards(count);
+    for (size_t i = 0; i < count; ++i) {
+        shards[i].table = std::make_shared<const Table>();
+        shards[i].clock.store(0, std::memory_order_relaxed);
+        shards[i].capacity = capacity / count + (i < capacity % count ? 1 : 0);
+    }
+    shards_.swap(shards);
+}
+
+/**
+ * @brief Select the shard responsible for a key ID.
+ *
+ * Key IDs are often sequential, so they are scrambled before the shard
+ * index is taken.
+ *
+ * @param key_id The key ID.
+ * @return Reference to the shard.
+ */
+RC6KeyCache::Shard &RC6KeyCache::shardFor(const uint64_t key_id) {
+    const uint64_t hash = key_id * 0x9E3779B97F4A7C15ull;
+    return shards_[static_cast<size_t>(hash >> 32) & (shards_.size() - 1)];
+}
+
+/**
+ * @brief Mark an entry as used now.
+ *
+ * The clock only moves on insertion, so a hot entry is written once per
+ * insertion rather than once per hit and its cache line stays shared.
+ *
+ * @param shard The entry's shard.
+ * @param entry The entry.
+ */
+void RC6KeyCache::touch(const Shard &shard, Entry &entry) {
+    const uint64_t now = shard.clock.load(std::memory_order_relaxed);
+    if (entry.last_used.load(std::memory_order_relaxed) != now) {
+        entry.last_used.store(now, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Look up a cached schedule.
+ *
+ * Loads the shard's published table without locking and stamps a hit
+ * with the shard clock.
+ *
+ * @param key_id The key ID.
+ * @return Handle to the keyed cipher, or an empty handle if not cached.
+ */
+RC6KeyCache::Handle RC6KeyCache::find(const uint64_t key_id) {
+    Shard &shard = shardFor(key_id);
+    const std::shared_ptr<const Table> table = std::atomic_load(&shard.table);
+
+    const auto it = table->find(key_id);
+    if (it == table->end()) {
+        return Handle();
+    }
+    touch(shard, *it->second);
+    return it->second->cipher;
+}
+
+/**
+ * @brief Look up a schedule, expanding and caching the key on a miss.
+ *
+ * The key is expanded without holding the shard lock. If another thread
+ * inserted the same key ID in the meantime, its schedule wins and is
+ * returned. Otherwise the table is copied with the new entry, evicting the
+ * least recently used one from a full shard, and the copy is published.
+ *
+ * @param key_id The key ID.
+ * @param key Pointer to the key data, used only on a miss.
+ * @param keylength_bits Length of the key in bits.
+ * @return Handle to the keyed cipher.
+ * @throws std::invalid_argument if the key is needed and invalid (see RC6::init).
+ */
+RC6KeyCache::Handle RC6KeyCache::get(const uint64_t key_id, const void *key, const uint16_t keylength_bits) {
+    Handle cached = find(key_id);
+    if (cached) {
+        return cached;
+    }
+
+    std::shared_ptr<RC6> expanded = std::make_shared<RC6>(rounds_);
+    expanded->init(key, keylength_bits);
+
+    Shard &shard = shardFor(key_id);
+    // Keep the replaced table, and any evicted entry, alive until the lock is released
+    std::shared_ptr<const Table> current;
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    current = shard.table;
+
+    const auto it = current->find(key_id);
+    if (it != current->end()) {
+        touch(shard, *it->second);
+        return it->second->cipher;
+    }
+
+    std::shared_ptr<Table> next = std::make_shared<Table>(*current);
+    if (next->size() >= shard.capacity) {
+        auto oldest = next->begin();
+        for (auto candidate = next->begin(); candidate != next->end(); ++candidate) {
+            if (candidate->second->last_used.load(std::memory_order_relaxed) <
+                oldest->second->last_used.load(std::memory_order_relaxed)) {
+                oldest = candidate;
+            }
+        }
+        next->erase(oldest);
+    }
+
+    // The new entry is stamped between the previous hits and the following ones
+    const uint64_t now = shard.clock.load(std::memory_order_relaxed) + 1;
+    const std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+    entry->cipher = std::move(expanded);
+    entry->last_used.store(now, std::memory_order_relaxed);
+    (*next)[key_id] = entry;
+
+    std::atomic_store(&shard.table, std::shared_ptr<const Table>(std::move(next)));
+    shard.clock.store(now + 1, std::memory_order_relaxed);
+    return entry->cipher;
+}
+
+/**
+ * @brief Remove a schedule from the cache.
+ * @param key_id The key ID.
+ * @return True if an entry was removed.
+ */
+bool RC6KeyCache::erase(const uint64_t key_id) {
+    Shard &shard = shardFor(key_id);
+    std::shared_ptr<const Table> current;
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    current = shard.table;
+
+    if (current->find(key_id) == current->end()) {
+        return false;
+    }
+    std::shared_ptr<Table> next = std::make_shared<Table>(*current);
+    next->erase(key_id);
+    std::atomic_store(&shard.table, std::shared_ptr<const Table>(std::move(next)));
+    return true;
+}
+
+/**
+ * @brief Remove all schedules from the cache.
+ */
+void RC6KeyCache::clear() {
+    for (auto &shard: shards_) {
+        std::shared_ptr<const Table> removed = std::make_shared<const Table>();
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            removed = std::atomic_exchange(&shard.table, std::move(removed));
+        }
+    }
+}
+
+/**
+ * @brief Get the number of cached schedules.
+ *
+ * Concurrent inserts and evictions may make the result stale immediately.
+ *
+ * @return Entry count.
+ */
+size_t RC6KeyCache::size() const {
+    size_t total = 0;
+    for (const auto &shard: shards_) {
+        total += std::atomic_load(&shard.table)->size();
+    }
+    return total;
+}
+
+/**
+ * @brief Get the maximum number of cached schedules.
+ * @return Capacity.
+ */
+size_t RC6KeyCache::capacity() const {
+    return capacity_;
+}
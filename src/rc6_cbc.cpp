@@ -0,0 +1,175 @@
+/**
+ * @file rc6_cbc.cpp
+ * @brief Implementation file for the RC6 cipher block chaining (CBC) mode.
+ *
+ * This file provides the implementation of CBC mode as defined in the
+ * rc6_cbc.hpp header file.
+ */
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "rc6_cbc.hpp"
+#include "rc6_util.hpp"
+
+constexpr size_t RC6CBC::BLOCK_SIZE;
+constexpr size_t RC6CBC::BATCH_BLOCKS;
+
+/**
+ * @brief Constructor.
+ * @param cipher Initialized RC6 object.
+ * @throws std::runtime_error if the cipher is not initialized.
+ */
+RC6CBC::RC6CBC(const RC6 &cipher) : cipher_(cipher) {
+    if (!cipher.isInitialized()) {
+        throw std::runtime_error("RC6 not initialized");
+    }
+}
+
+/**
+ * @brief Encrypt blocks of one message.
+ *
+ * Each block depends on the previous ciphertext, so this runs one block
+ * at a time; use encryptMany() to encrypt independent messages in parallel.
+ *
+ * @param iv Pointer to the 16-byte chaining value; updated on return.
+ * @param in Pointer to nblocks * 16 bytes of plaintext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param nblocks Number of blocks.
+ * @throws std::invalid_argument if iv, in or out is null and nblocks is non-zero.
+ */
+void RC6CBC::encrypt(void *iv, const void *in, void *out, const size_t nblocks) const {
+    if (nblocks == 0) {
+        return;
+    }
+
+    if (iv == nullptr || in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    auto *chain = static_cast<uint8_t *>(iv);
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    for (size_t n = 0; n < nblocks; ++n) {
+        rc6_util::xorBytes(chain, chain, src + BLOCK_SIZE * n, BLOCK_SIZE);
+        cipher_.encryptUnchecked(chain);
+        std::memcpy(dst + BLOCK_SIZE * n, chain, BLOCK_SIZE);
+    }
+}
+
+/**
+ * @brief Decrypt blocks of one message.
+ *
+ * Runs batches of blocks through the bulk kernels and applies the chaining
+ * XOR afterwards. In-place batches keep a copy of their ciphertext, which
+ * is still needed for the XOR.
+ *
+ * @param iv Pointer to the 16-byte chaining value; updated on return.
+ * @param in Pointer to nblocks * 16 bytes of ciphertext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param nblocks Number of blocks.
+ * @throws std::invalid_argument if iv, in or out is null and nblocks is non-zero.
+ */
+void RC6CBC::decrypt(void *iv, const void *in, void *out, const size_t nblocks) const {
+    if (nblocks == 0) {
+        return;
+    }
+
+    if (iv == nullptr || in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    auto *chain = static_cast<uint8_t *>(iv);
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    uint8_t saved[BATCH_BLOCKS * BLOCK_SIZE];
+
+    for (size_t done = 0; done < nblocks;) {
+        const size_t batch = std::min(nblocks - done, BATCH_BLOCKS);
+        const uint8_t *ciphertext = src + BLOCK_SIZE * done;
+        uint8_t *plaintext = dst + BLOCK_SIZE * done;
+
+        if (ciphertext == plaintext) {
+            std::memcpy(saved, ciphertext, BLOCK_SIZE * batch);
+            ciphertext = saved;
+        }
+
+        cipher_.decryptBlocksUnchecked(ciphertext, plaintext, batch);
+        rc6_util::xorBytes(plaintext, plaintext, chain, BLOCK_SIZE);
+        rc6_util::xorBytes(plaintext + BLOCK_SIZE, plaintext + BLOCK_SIZE, ciphertext, BLOCK_SIZE * (batch - 1));
+        std::memcpy(chain, ciphertext + BLOCK_SIZE * (batch - 1), BLOCK_SIZE);
+
+        done += batch;
+    }
+}
+
+/**
+ * @brief Encrypt several independent messages at once.
+ *
+ * Messages are taken in groups of up to BATCH_BLOCKS. For each block
+ * position, the chained input block of every message still running is
+ * gathered into one buffer, encrypted with a single bulk call and scattered
+ * back, so the vector lanes work on different messages. Messages drop out
+ * of the group as they end.
+ *
+ * @param messages Array of count messages; their iv fields are updated.
+ * @param count Number of messages.
+ * @throws std::invalid_argument if messages is null and count is non-zero,
+ *         or if a message with blocks has a null in or out pointer.
+ */
+void RC6CBC::encryptMany(Message *messages, const size_t count) const {
+    if (count == 0) {
+        return;
+    }
+
+    if (messages == nullptr) {
+        throw std::invalid_argument("Messages cannot be null");
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (messages[i].nblocks != 0 && (messages[i].in == nullptr || messages[i].out == nullptr)) {
+            throw std::invalid_argument("Block cannot be null");
+        }
+    }
+
+    uint8_t lanes[BATCH_BLOCKS * BLOCK_SIZE];
+    Message *active[BATCH_BLOCKS];
+
+    for (size_t first = 0; first < count; first += BATCH_BLOCKS) {
+        const size_t group = std::min(count - first, BATCH_BLOCKS);
+        size_t running = 0;
+        for (size_t i = 0; i < group; ++i) {
+            if (messages[first + i].nblocks != 0) {
+                std::memcpy(lanes + BLOCK_SIZE * running, messages[first + i].iv, BLOCK_SIZE);
+                active[running++] = &messages[first + i];
+            }
+        }
+
+        // Each lane holds the chaining value of its message between steps
+        for (size_t block = 0; running > 0; ++block) {
+            const size_t offset = BLOCK_SIZE * block;
+            for (size_t k = 0; k < running; ++k) {
+                const auto *src = static_cast<const uint8_t *>(active[k]->in) + offset;
+                rc6_util::xorBytes(lanes + BLOCK_SIZE * k, lanes + BLOCK_SIZE * k, src, BLOCK_SIZE);
+            }
+
+            cipher_.encryptBlocksUnchecked(lanes, lanes, running);
+
+            size_t kept = 0;
+            for (size_t k = 0; k < running; ++k) {
+                Message *message = active[k];
+                uint8_t *lane = lanes + BLOCK_SIZE * k;
+                std::memcpy(static_cast<uint8_t *>(message->out) + offset, lane, BLOCK_SIZE);
+                if (block + 1 == message->nblocks) {
+                    std::memcpy(message->iv, lane, BLOCK_SIZE);
+                    continue;
+                }
+                if (kept != k) {
+                    std::memcpy(lanes + BLOCK_SIZE * kept, lane, BLOCK_SIZE);
+                }
+                active[kept++] = message;
+            }
+            running = kept;
+        }
+    }
+}
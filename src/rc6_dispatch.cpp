@@ -0,0 +1,247 @@
+/**
+ * @file rc6_dispatch.cpp
+ * @brief Runtime selection of the vectorized RC6 bulk kernels.
+ *
+ * The CPU is probed once, on first use, and the backends to use are
+ * stored from the widest to the narrowest, ending with the interleaved
+ * scalar backend that every target has. Bulk calls then walk that list
+ * without repeating any feature checks. A single backend can be forced
+ * instead, through RC6Backend or the RC6_BACKEND environment variable.
+ */
+#include "rc6_kernels.hpp"
+#include "rc6_trace.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RC6_DISPATCH_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+#define RC6_DISPATCH_AUXV 1
+#include <sys/auxv.h>
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD (1 << 1)
+#endif
+#endif
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+#ifdef RC6_DISPATCH_X86
+    void cpuid(const uint32_t leaf, const uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (int i = 0; i < 4; ++i) {
+            regs[i] = static_cast<uint32_t>(info[i]);
+        }
+#else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+
+    uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+
+    /**
+     * @brief Probe AVX2 and AVX-512F support, including OS register state.
+     */
+    void probeX86(bool &avx2, bool &avx512) {
+        avx2 = false;
+        avx512 = false;
+
+        uint32_t regs[4];
+        cpuid(0, 0, regs);
+        const uint32_t max_leaf = regs[0];
+        if (max_leaf < 7) {
+            return;
+        }
+
+        cpuid(1, 0, regs);
+        const bool osxsave = (regs[2] & (1u << 27)) != 0;
+        const bool avx = (regs[2] & (1u << 28)) != 0;
+        if (!osxsave || !avx) {
+            return;
+        }
+
+        const uint64_t xcr0 = xgetbv0();
+        const bool ymm_state = (xcr0 & 0x06) == 0x06;
+        const bool zmm_state = (xcr0 & 0xe6) == 0xe6;
+
+        cpuid(7, 0, regs);
+        avx2 = ymm_state && (regs[1] & (1u << 5)) != 0;
+        avx512 = zmm_state && (regs[1] & (1u << 16)) != 0;
+    }
+#endif
+
+    /**
+     * @brief Probe Advanced SIMD support.
+     *
+     * NEON is part of the AArch64 baseline, but the kernel's hardware
+     * capability bits are still honoured where they are available.
+     */
+    bool probeNeon() {
+#ifdef RC6_DISPATCH_AUXV
+        return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#else
+        return true;
+#endif
+    }
+
+    const size_t MAX_BACKENDS = 5;
+
+    /**
+     * @brief An ordered list of backends, walked from the first entry.
+     */
+    struct BackendList {
+        const rc6_kernels::Backend *entries[MAX_BACKENDS];
+        size_t count;
+
+        BackendList() : entries(), count(0) {
+        }
+
+        void add(const rc6_kernels::Backend *backend) {
+            if (backend != nullptr) {
+                entries[count++] = backend;
+            }
+        }
+    };
+
+    /**
+     * @brief Probe results and the dispatch table in use.
+     *
+     * Built once, on first use. Forcing a backend points the active table at
+     * a prebuilt single-entry list, so bulk calls still do one load and no
+     * feature checks. The lists never change after construction.
+     */
+    struct Registry {
+        BackendList supported; //!< Every supported backend, widest first
+        BackendList automatic; //!< Backends used when none is forced
+        BackendList single[MAX_BACKENDS]; //!< supported.entries[i] on its own
+        std::atomic<const BackendList *> active; //!< Table used by bulk calls
+
+        Registry() : active(&automatic) {
+#ifdef RC6_DISPATCH_X86
+            bool avx2 = false, avx512 = false;
+            probeX86(avx2, avx512);
+            if (avx512) {
+                supported.add(rc6_kernels::avx512Backend());
+                automatic.add(rc6_kernels::avx512Backend());
+            }
+            if (avx2) {
+                supported.add(rc6_kernels::avx2Backend());
+                automatic.add(rc6_kernels::avx2Backend());
+            }
+            // SSE2 emulates the 32-bit multiply and variable rotates, which makes
+            // it slower than the interleaved scalar kernel; it only runs when forced
+            supported.add(rc6_kernels::sse2Backend());
+#endif
+            if (probeNeon()) {
+                supported.add(rc6_kernels::neonBackend());
+                automatic.add(rc6_kernels::neonBackend());
+            }
+            supported.add(rc6_kernels::scalarBackend());
+            automatic.add(rc6_kernels::scalarBackend());
+
+            for (size_t i = 0; i < supported.count; ++i) {
+                single[i].add(supported.entries[i]);
+            }
+
+            // Deployment-time pinning; unknown names keep the automatic choice
+            const char *name = std::getenv("RC6_BACKEND");
+            if (name != nullptr) {
+                select(name);
+            }
+        }
+
+        /**
+         * @brief Switch the active table.
+         * @param name Backend name, or nullptr or "auto" for the automatic table.
+         * @return False if no supported backend has that name.
+         */
+        bool select(const char *name) {
+            if (name == nullptr || std::strcmp(name, "auto") == 0) {
+                active.store(&automatic, std::memory_order_release);
+                return true;
+            }
+            for (size_t i = 0; i < supported.count; ++i) {
+                if (std::strcmp(name, supported.entries[i]->name) == 0) {
+                    active.store(&single[i], std::memory_order_release);
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    const BackendList &backends() {
+        return *registry().active.load(std::memory_order_acquire);
+    }
+}
+
+const rc6_kernels::Backend *rc6_kernels::supportedBackend(const size_t index) {
+    const BackendList &list = registry().supported;
+    return index < list.count ? list.entries[index] : nullptr;
+}
+
+const rc6_kernels::Backend *rc6_kernels::activeBackend() {
+    return backends().entries[0];
+}
+
+bool rc6_kernels::isBackendForced() {
+    return &backends() != &registry().automatic;
+}
+
+bool rc6_kernels::forceBackend(const char *name) {
+    return registry().select(name);
+}
+
+const rc6_kernels::Backend *rc6_kernels::keyScheduleBackend() {
+    return activeBackend();
+}
+
+size_t rc6_kernels::encryptBlocks(const uint32_t *round_keys, const uint8_t rounds,
+                                  const void *in, void *out, const size_t nblocks) {
+    const BackendList &list = backends();
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    size_t done = 0;
+    for (size_t i = 0; i < list.count && done < nblocks; ++i) {
+        const size_t n = list.entries[i]->encrypt(round_keys, rounds, src + 16 * done, dst + 16 * done, nblocks - done);
+        rc6_trace::backendBlocks(list.entries[i]->id, n);
+        done += n;
+    }
+    return done;
+}
+
+size_t rc6_kernels::decryptBlocks(const uint32_t *round_keys, const uint8_t rounds,
+                                  const void *in, void *out, const size_t nblocks) {
+    const BackendList &list = backends();
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    size_t done = 0;
+    for (size_t i = 0; i < list.count && done < nblocks; ++i) {
+        const size_t n = list.entries[i]->decrypt(round_keys, rounds, src + 16 * done, dst + 16 * done, nblocks - done);
+        rc6_trace::backendBlocks(list.entries[i]->id, n);
+        done += n;
+    }
+    return done;
+}
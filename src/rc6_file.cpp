@@ -0,0 +1,325 @@
+/**
+ * @file rc6_file.cpp
+ * @brief Implementation file for RC6 CTR encryption of whole files.
+ *
+ * This file provides the implementation of file encryption as defined in
+ * the rc6_file.hpp header file.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#define RC6_FILE_HAVE_MMAP 1
+#endif
+
+#include "rc6_file.hpp"
+
+constexpr size_t RC6File::DEFAULT_WINDOW_BYTES;
+
+namespace {
+#ifdef _WIN32
+    typedef struct _stat64 FileStat;
+    const int READ_FLAGS = _O_RDONLY | _O_BINARY;
+    const int INPLACE_FLAGS = _O_RDWR | _O_BINARY;
+    const int CREATE_FLAGS = _O_RDWR | _O_CREAT | _O_TRUNC | _O_BINARY;
+
+    int openFile(const char *path, const int flags) { return _open(path, flags, _S_IREAD | _S_IWRITE); }
+    int closeFile(const int fd) { return _close(fd); }
+    int statFile(const int fd, FileStat *st) { return _fstat64(fd, st); }
+    bool isRegular(const FileStat &st) { return (st.st_mode & _S_IFMT) == _S_IFREG; }
+    long long readFile(const int fd, void *buf, const size_t len) {
+        return _read(fd, buf, static_cast<unsigned>(std::min<size_t>(len, 1u << 30)));
+    }
+    long long writeFile(const int fd, const void *buf, const size_t len) {
+        return _write(fd, buf, static_cast<unsigned>(std::min<size_t>(len, 1u << 30)));
+    }
+    bool seekFile(const int fd, const uint64_t offset) {
+        return _lseeki64(fd, static_cast<long long>(offset), SEEK_SET) >= 0;
+    }
+#else
+    typedef struct stat FileStat;
+    const int READ_FLAGS = O_RDONLY;
+    const int INPLACE_FLAGS = O_RDWR;
+    // Shared writable mappings need the output opened for reading too
+    const int CREATE_FLAGS = O_RDWR | O_CREAT | O_TRUNC;
+
+    int openFile(const char *path, const int flags) { return ::open(path, flags, 0666); }
+    int closeFile(const int fd) { return ::close(fd); }
+    int statFile(const int fd, FileStat *st) { return ::fstat(fd, st); }
+    bool isRegular(const FileStat &st) { return S_ISREG(st.st_mode); }
+    long long readFile(const int fd, void *buf, const size_t len) { return ::read(fd, buf, len); }
+    long long writeFile(const int fd, const void *buf, const size_t len) { return ::write(fd, buf, len); }
+    bool seekFile(const int fd, const uint64_t offset) {
+        return ::lseek(fd, static_cast<off_t>(offset), SEEK_SET) >= 0;
+    }
+#endif
+
+    const size_t BUFFER_ALIGNMENT = 4096; //!< Alignment of the fallback buffer
+
+    std::runtime_error ioError(const std::string &what, const std::string &path) {
+        return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+    }
+
+    /**
+     * @brief Owns a file descriptor; standard streams are never closed.
+     */
+    class FileHandle {
+        int fd_;
+
+    public:
+        FileHandle(const std::string &path, const int flags, const int standard_fd) : fd_(standard_fd) {
+            if (path != "-") {
+                fd_ = openFile(path.c_str(), flags);
+                if (fd_ < 0) {
+                    throw ioError("Cannot open", path);
+                }
+            }
+        }
+
+        ~FileHandle() {
+            if (fd_ > 2) {
+                closeFile(fd_);
+            }
+        }
+
+        FileHandle(const FileHandle &) = delete;
+
+        FileHandle &operator=(const FileHandle &) = delete;
+
+        int get() const { return fd_; }
+    };
+
+#ifdef RC6_FILE_HAVE_MMAP
+    /**
+     * @brief One mapped window of a file.
+     */
+    class Mapping {
+        void *data_;
+        size_t len_;
+
+    public:
+        Mapping(const int fd, const uint64_t offset, const size_t len, const int prot) : len_(len) {
+            data_ = ::mmap(nullptr, len, prot, MAP_SHARED, fd, static_cast<off_t>(offset));
+            if (data_ == MAP_FAILED) {
+                throw std::runtime_error(std::string("Cannot map file: ") + std::strerror(errno));
+            }
+            ::madvise(data_, len, MADV_SEQUENTIAL);
+        }
+
+        ~Mapping() {
+            ::munmap(data_, len_);
+        }
+
+        Mapping(const Mapping &) = delete;
+
+        Mapping &operator=(const Mapping &) = delete;
+
+        uint8_t *data() const { return static_cast<uint8_t *>(data_); }
+    };
+#endif
+
+    /**
+     * @brief Read until len bytes are read or the input ends.
+     * @return Number of bytes read.
+     */
+    size_t readFull(const int fd, uint8_t *buf, const size_t len) {
+        size_t done = 0;
+        while (done < len) {
+            const long long n = readFile(fd, buf + done, len - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                throw std::runtime_error(std::string("Read failed: ") + std::strerror(errno));
+            }
+            if (n == 0) {
+                break;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return done;
+    }
+
+    void writeFull(const int fd, const uint8_t *buf, const size_t len) {
+        size_t done = 0;
+        while (done < len) {
+            const long long n = writeFile(fd, buf + done, len - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                throw std::runtime_error(std::string("Write failed: ") + std::strerror(errno));
+            }
+            done += static_cast<size_t>(n);
+        }
+    }
+}
+
+/**
+ * @brief Constructor.
+ *
+ * On POSIX systems the window is rounded up to a multiple of the page size,
+ * as required for mapping offsets.
+ *
+ * @param engine Parallel engine used for the keystream.
+ * @param window_bytes Bytes mapped or buffered at once (default: 64 MiB).
+ * @throws std::invalid_argument if window_bytes is zero.
+ */
+RC6File::RC6File(RC6Parallel &engine, const size_t window_bytes) : engine_(engine), window_bytes_(window_bytes) {
+    if (window_bytes == 0) {
+        throw std::invalid_argument("Window size cannot be zero");
+    }
+
+#ifdef RC6_FILE_HAVE_MMAP
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    window_bytes_ = (window_bytes + page - 1) / page * page;
+#endif
+}
+
+/**
+ * @brief Get the window size.
+ * @return Bytes mapped or buffered at once.
+ */
+size_t RC6File::windowBytes() const {
+    return window_bytes_;
+}
+
+/**
+ * @brief Process a file through read and write calls on a buffer.
+ *
+ * Each window is read into an aligned buffer, processed there in place and
+ * written back. When in_fd equals out_fd the descriptor is rewound before
+ * each write, so the file is processed in place.
+ *
+ * @param ctr Counter mode context.
+ * @param in_fd Input descriptor.
+ * @param out_fd Output descriptor (may equal in_fd for in-place use).
+ * @return Number of bytes processed.
+ * @throws std::runtime_error on I/O errors.
+ */
+uint64_t RC6File::processBuffered(const RC6CTR &ctr, const int in_fd, const int out_fd) const {
+    std::unique_ptr<uint8_t[]> storage(new uint8_t[window_bytes_ + BUFFER_ALIGNMENT]);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(storage.get());
+    auto *buffer = reinterpret_cast<uint8_t *>((address + BUFFER_ALIGNMENT - 1) & ~(BUFFER_ALIGNMENT - 1));
+
+    uint64_t offset = 0;
+    for (;;) {
+        const size_t len = readFull(in_fd, buffer, window_bytes_);
+        if (len == 0) {
+            break;
+        }
+
+        engine_.processCTR(ctr, offset, buffer, buffer, len);
+
+        if (in_fd == out_fd && !seekFile(out_fd, offset)) {
+            throw std::runtime_error(std::string("Seek failed: ") + std::strerror(errno));
+        }
+        writeFull(out_fd, buffer, len);
+        offset += len;
+    }
+    return offset;
+}
+
+/**
+ * @brief Encrypt or decrypt a file in place.
+ *
+ * Regular files are mapped one window at a time and transformed directly
+ * in the page cache.
+ *
+ * @param ctr Counter mode context; its stream position is not used.
+ * @param path Path of the file.
+ * @return Number of bytes processed.
+ * @throws std::runtime_error on I/O errors.
+ */
+uint64_t RC6File::processInPlace(const RC6CTR &ctr, const std::string &path) const {
+    const FileHandle file(path, INPLACE_FLAGS, -1);
+
+    FileStat st;
+    if (statFile(file.get(), &st) != 0) {
+        throw ioError("Cannot stat", path);
+    }
+
+#ifdef RC6_FILE_HAVE_MMAP
+    if (isRegular(st)) {
+        const uint64_t size = static_cast<uint64_t>(st.st_size);
+        for (uint64_t offset = 0; offset < size; offset += window_bytes_) {
+            const size_t len = static_cast<size_t>(std::min<uint64_t>(window_bytes_, size - offset));
+            const Mapping map(file.get(), offset, len, PROT_READ | PROT_WRITE);
+            engine_.processCTR(ctr, offset, map.data(), map.data(), len);
+        }
+        return size;
+    }
+#endif
+
+    return processBuffered(ctr, file.get(), file.get());
+}
+
+/**
+ * @brief Encrypt or decrypt a file into another file.
+ *
+ * When both ends are regular files, the output is sized up front and each
+ * window of the input mapping is transformed straight into the output
+ * mapping. If both paths name the same file, it is processed in place
+ * rather than truncated.
+ *
+ * @param ctr Counter mode context; its stream position is not used.
+ * @param in_path Path of the input; "-" reads standard input.
+ * @param out_path Path of the output, created or truncated; "-" writes standard output.
+ * @return Number of bytes processed.
+ * @throws std::runtime_error on I/O errors.
+ */
+uint64_t RC6File::process(const RC6CTR &ctr, const std::string &in_path, const std::string &out_path) const {
+    if (in_path == out_path && in_path != "-") {
+        return processInPlace(ctr, in_path);
+    }
+
+    const FileHandle in(in_path, READ_FLAGS, 0);
+
+    FileStat in_st;
+    if (statFile(in.get(), &in_st) != 0) {
+        throw ioError("Cannot stat", in_path);
+    }
+
+#ifndef _WIN32
+    struct stat out_existing;
+    if (out_path != "-" && ::stat(out_path.c_str(), &out_existing) == 0 &&
+        out_existing.st_dev == in_st.st_dev && out_existing.st_ino == in_st.st_ino) {
+        return processInPlace(ctr, out_path);
+    }
+#endif
+
+    const FileHandle out(out_path, CREATE_FLAGS, 1);
+
+#ifdef RC6_FILE_HAVE_MMAP
+    FileStat out_st;
+    if (statFile(out.get(), &out_st) != 0) {
+        throw ioError("Cannot stat", out_path);
+    }
+
+    if (isRegular(in_st) && isRegular(out_st)) {
+        const uint64_t size = static_cast<uint64_t>(in_st.st_size);
+        if (::ftruncate(out.get(), static_cast<off_t>(size)) != 0) {
+            throw ioError("Cannot resize", out_path);
+        }
+        for (uint64_t offset = 0; offset < size; offset += window_bytes_) {
+            const size_t len = static_cast<size_t>(std::min<uint64_t>(window_bytes_, size - offset));
+            const Mapping src(in.get(), offset, len, PROT_READ);
+            const Mapping dst(out.get(), offset, len, PROT_READ | PROT_WRITE);
+            engine_.processCTR(ctr, offset, src.data(), dst.data(), len);
+        }
+        return size;
+    }
+#endif
+
+    return processBuffered(ctr, in.get(), out.get());
+}
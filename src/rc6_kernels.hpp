@@ -0,0 +1,198 @@
+/**
+ * @file rc6_kernels.hpp
+ * @brief Internal interface of the vectorized RC6 bulk kernels.
+ *
+ * Each backend encrypts or decrypts several independent blocks at once by
+ * transposing them into lane-parallel A/B/C/D vectors, or, for the scalar
+ * backend, by interleaving their rounds in general-purpose registers. Backends live in
+ * their own translation units so that each can be compiled with the
+ * instruction set flags it needs; this header must therefore stay free of
+ * intrinsics and standard library templates.
+ */
+#ifndef RC6_KERNELS_HPP_
+#define RC6_KERNELS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rc6_kernels {
+    /**
+     * @brief Bulk block transform implemented by a backend.
+     *
+     * Processes the largest multiple of the backend lane count that fits in
+     * nblocks. Input and output may be unaligned and may be identical, but
+     * must not partially overlap.
+     *
+     * @param round_keys Expanded key schedule (2 * rounds + 4 words).
+     * @param rounds Number of rounds.
+     * @param in Pointer to nblocks * 16 bytes of input.
+     * @param out Pointer to nblocks * 16 bytes of output.
+     * @param nblocks Number of blocks available.
+     * @return Number of blocks processed.
+     */
+    typedef size_t (*BlockFunction)(const uint32_t *round_keys, uint8_t rounds,
+                                    const void *in, void *out, size_t nblocks);
+
+    /**
+     * @brief Bulk transform with its own key schedule in each lane.
+     *
+     * Block k of every group of lanes blocks uses lane order[k], where
+     * order is the backend's lane_order table (the identity if null): a
+     * kernel whose loads do not keep blocks in element order needs its
+     * schedules permuted the same way. lane_keys is stored word-major like
+     * the arrays of KeyMixFunction: element [j * lanes + lane] is round key
+     * j of that lane, and each row of lanes words starts on a multiple of
+     * its own size so that it is one aligned vector load. Processes the
+     * largest multiple of the lane count that fits in nblocks.
+     *
+     * @param lane_keys Schedules of all lanes, (2 * rounds + 4) * lanes words,
+     *                  aligned to LANE_KEY_ALIGNMENT bytes.
+     * @param rounds Number of rounds, the same for every lane.
+     * @param in Pointer to nblocks * 16 bytes of input.
+     * @param out Pointer to nblocks * 16 bytes of output.
+     * @param nblocks Number of blocks available.
+     * @return Number of blocks processed.
+     */
+    typedef size_t (*LaneKeyFunction)(const uint32_t *lane_keys, uint8_t rounds,
+                                      const void *in, void *out, size_t nblocks);
+
+    /**
+     * @brief Key schedule mixing loop run for one key per lane.
+     *
+     * Arrays are stored word-major: element [i * lanes + k] is word i of the
+     * k-th key. On entry s holds the P32/Q32 initial table and l the key
+     * words; on return s holds the expanded round keys.
+     *
+     * @param s Round key array, key_size * lanes words.
+     * @param l Key word array, c * lanes words.
+     * @param key_size Number of round keys per key (2 * rounds + 4).
+     * @param c Number of key words per key.
+     */
+    typedef void (*KeyMixFunction)(uint32_t *s, uint32_t *l, uint16_t key_size, uint16_t c);
+
+    /**
+     * @brief Stable index of each backend, used by the usage counters.
+     */
+    enum BackendId : uint8_t {
+        BACKEND_SSE2,
+        BACKEND_AVX2,
+        BACKEND_AVX512,
+        BACKEND_NEON,
+        BACKEND_SCALAR,
+        BACKEND_COUNT
+    };
+
+    /**
+     * @brief Description of a vectorized backend.
+     */
+    struct Backend {
+        const char *name; //!< Short backend name, e.g. "avx2"
+        BackendId id; //!< Stable index
+        size_t lanes; //!< Number of blocks processed per vector
+        BlockFunction encrypt; //!< Bulk encryption kernel
+        BlockFunction decrypt; //!< Bulk decryption kernel
+        KeyMixFunction mixKeys; //!< Key schedule for lanes keys at once
+        LaneKeyFunction encryptLanes; //!< Bulk encryption with one schedule per lane
+        LaneKeyFunction decryptLanes; //!< Bulk decryption with one schedule per lane
+        const uint8_t *lane_order; //!< Lane used by block k of a group, or null for lane k
+    };
+
+    const size_t MAX_LANES = 16; //!< Widest lane count of any backend
+    const size_t LANE_KEY_ALIGNMENT = 64; //!< Alignment of lane key tables, the widest row
+
+    /**
+     * @brief Lane of a LaneKeyFunction table used by block k of each group.
+     * @param backend The backend.
+     * @param k Index of the block within its group, below backend->lanes.
+     * @return The lane.
+     */
+    inline size_t laneOf(const Backend *backend, const size_t k) {
+        return backend->lane_order != nullptr ? backend->lane_order[k] : k;
+    }
+
+    /**
+     * @brief SSE2 backend (4 lanes).
+     * @return The backend, or nullptr if it was not compiled in.
+     */
+    const Backend *sse2Backend();
+
+    /**
+     * @brief AVX2 backend (8 lanes).
+     * @return The backend, or nullptr if it was not compiled in.
+     */
+    const Backend *avx2Backend();
+
+    /**
+     * @brief AVX-512F backend (16 lanes).
+     * @return The backend, or nullptr if it was not compiled in.
+     */
+    const Backend *avx512Backend();
+
+    /**
+     * @brief NEON backend (4 lanes).
+     * @return The backend, or nullptr if it was not compiled in.
+     */
+    const Backend *neonBackend();
+
+    /**
+     * @brief Interleaved scalar backend (2 lanes), available on every target.
+     * @return The backend.
+     */
+    const Backend *scalarBackend();
+
+    /**
+     * @brief Backends supported by this CPU, from the widest to the narrowest.
+     * @param index Position in the list.
+     * @return The backend, or nullptr if index is past the end.
+     */
+    const Backend *supportedBackend(size_t index);
+
+    /**
+     * @brief Widest backend used by bulk calls: the forced one, if any.
+     * @return The backend.
+     */
+    const Backend *activeBackend();
+
+    /**
+     * @brief Check whether a single backend has been forced.
+     * @return True if bulk calls are pinned to one backend.
+     */
+    bool isBackendForced();
+
+    /**
+     * @brief Pin bulk calls to one supported backend, or restore the automatic choice.
+     *
+     * Thread-safe; calls already running finish with the previous table.
+     *
+     * @param name Backend name, or nullptr or "auto" for the automatic selection.
+     * @return False, leaving the selection unchanged, if no supported backend has that name.
+     */
+    bool forceBackend(const char *name);
+
+    /**
+     * @brief Widest backend in use, used to expand many keys at once.
+     * @return The backend; the scalar backend if no vectorized one is available.
+     */
+    const Backend *keyScheduleBackend();
+
+    /**
+     * @brief Encrypt blocks with the best backends supported by this CPU.
+     *
+     * Backends are tried from the widest to the narrowest, so only a tail
+     * of fewer blocks than the narrowest lane count is left unprocessed.
+     * With a forced backend, only that backend is used.
+     *
+     * @return Number of blocks processed; the caller handles the rest.
+     */
+    size_t encryptBlocks(const uint32_t *round_keys, uint8_t rounds,
+                         const void *in, void *out, size_t nblocks);
+
+    /**
+     * @brief Decrypt blocks with the best backends supported by this CPU.
+     * @return Number of blocks processed; the caller handles the rest.
+     */
+    size_t decryptBlocks(const uint32_t *round_keys, uint8_t rounds,
+                         const void *in, void *out, size_t nblocks);
+}
+
+#endif /* RC6_KERNELS_HPP_ */
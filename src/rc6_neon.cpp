@@ -0,0 +1,226 @@
+/**
+ * @file rc6_neon.cpp
+ * @brief NEON implementation of the RC6 bulk kernels.
+ *
+ * Each 128-bit vector holds one word of four blocks. vld4q/vst4q transpose
+ * blocks into A/B/C/D vectors as part of the load and store, and variable
+ * rotates use vshlq_u32, which shifts right for negative counts. NEON is
+ * part of the AArch64 baseline, so no runtime check is needed.
+ */
+#include "rc6_kernels.hpp"
+
+#if (defined(__aarch64__) || defined(_M_ARM64)) && !defined(__ARM_BIG_ENDIAN)
+#define RC6_KERNEL_NEON 1
+#endif
+
+#ifdef RC6_KERNEL_NEON
+
+#include <arm_neon.h>
+
+namespace {
+    constexpr size_t LANES = 4;
+
+    inline uint32x4_t rotlv(const uint32x4_t x, const uint32x4_t n) {
+        const int32x4_t count = vreinterpretq_s32_u32(vandq_u32(n, vdupq_n_u32(0x1f)));
+        return vorrq_u32(vshlq_u32(x, count), vshlq_u32(x, vsubq_s32(count, vdupq_n_s32(32))));
+    }
+
+    inline uint32x4_t rotrv(const uint32x4_t x, const uint32x4_t n) {
+        return rotlv(x, vreinterpretq_u32_s32(vnegq_s32(vreinterpretq_s32_u32(n))));
+    }
+
+    // f(x) = (x * (2x + 1)) <<< 5
+    inline uint32x4_t mix(const uint32x4_t x) {
+        const uint32x4_t p = vmulq_u32(x, vaddq_u32(vaddq_u32(x, x), vdupq_n_u32(1)));
+        return vsriq_n_u32(vshlq_n_u32(p, 5), p, 27);
+    }
+
+    // vld4q de-interleaves four blocks so that val[0..3] hold the A/B/C/D words
+    inline void load(const uint8_t *in, uint32x4_t &a, uint32x4_t &b, uint32x4_t &c, uint32x4_t &d) {
+        const uint32x4x4_t v = vld4q_u32(reinterpret_cast<const uint32_t *>(in));
+        a = v.val[0];
+        b = v.val[1];
+        c = v.val[2];
+        d = v.val[3];
+    }
+
+    inline void store(uint8_t *out, const uint32x4_t a, const uint32x4_t b, const uint32x4_t c, const uint32x4_t d) {
+        uint32x4x4_t v;
+        v.val[0] = a;
+        v.val[1] = b;
+        v.val[2] = c;
+        v.val[3] = d;
+        vst4q_u32(reinterpret_cast<uint32_t *>(out), v);
+    }
+
+    // Round key j of every lane: one schedule broadcast to all lanes
+    struct SharedKeys {
+        const uint32_t *rk;
+
+        uint32x4_t operator[](const size_t j) const {
+            return vdupq_n_u32(rk[j]);
+        }
+    };
+
+    // Round key j of every lane: one schedule per lane, stored word-major in aligned rows
+    struct LaneKeys {
+        const uint32_t *lk;
+
+        uint32x4_t operator[](const size_t j) const {
+            return vld1q_u32(lk + LANES * j);
+        }
+    };
+
+    // Encrypt N vectors of LANES blocks each, interleaved to hide multiply latency
+    template<size_t N, typename Keys>
+    inline void encryptGroup(const Keys &rk, const uint8_t rounds, const uint8_t *in, uint8_t *out) {
+        uint32x4_t a[N], b[N], c[N], d[N];
+        for (size_t g = 0; g < N; ++g) {
+            load(in + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+            b[g] = vaddq_u32(b[g], rk[0]);
+            d[g] = vaddq_u32(d[g], rk[1]);
+        }
+
+        for (size_t i = 1; i <= rounds; ++i) {
+            const uint32x4_t ka = rk[2 * i];
+            const uint32x4_t kc = rk[2 * i + 1];
+            for (size_t g = 0; g < N; ++g) {
+                const uint32x4_t t = mix(b[g]);
+                const uint32x4_t u = mix(d[g]);
+                const uint32x4_t na = vaddq_u32(rotlv(veorq_u32(a[g], t), u), ka);
+                const uint32x4_t nc = vaddq_u32(rotlv(veorq_u32(c[g], u), t), kc);
+                a[g] = b[g];
+                b[g] = nc;
+                c[g] = d[g];
+                d[g] = na;
+            }
+        }
+
+        for (size_t g = 0; g < N; ++g) {
+            a[g] = vaddq_u32(a[g], rk[2 * rounds + 2]);
+            c[g] = vaddq_u32(c[g], rk[2 * rounds + 3]);
+            store(out + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+        }
+    }
+
+    // Decrypt N vectors of LANES blocks each, interleaved to hide multiply latency
+    template<size_t N, typename Keys>
+    inline void decryptGroup(const Keys &rk, const uint8_t rounds, const uint8_t *in, uint8_t *out) {
+        uint32x4_t a[N], b[N], c[N], d[N];
+        for (size_t g = 0; g < N; ++g) {
+            load(in + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+            c[g] = vsubq_u32(c[g], rk[2 * rounds + 3]);
+            a[g] = vsubq_u32(a[g], rk[2 * rounds + 2]);
+        }
+
+        for (size_t i = rounds; i > 0; --i) {
+            const uint32x4_t ka = rk[2 * i];
+            const uint32x4_t kc = rk[2 * i + 1];
+            for (size_t g = 0; g < N; ++g) {
+                const uint32x4_t pa = d[g];
+                const uint32x4_t pc = b[g];
+                b[g] = a[g];
+                d[g] = c[g];
+                const uint32x4_t u = mix(d[g]);
+                const uint32x4_t t = mix(b[g]);
+                c[g] = veorq_u32(rotrv(vsubq_u32(pc, kc), t), u);
+                a[g] = veorq_u32(rotrv(vsubq_u32(pa, ka), u), t);
+            }
+        }
+
+        for (size_t g = 0; g < N; ++g) {
+            d[g] = vsubq_u32(d[g], rk[1]);
+            b[g] = vsubq_u32(b[g], rk[0]);
+            store(out + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+        }
+    }
+
+    template<typename Keys>
+    size_t encryptBlocksWith(const Keys &keys, const uint8_t rounds, const void *in, void *out, const size_t nblocks) {
+        const auto *src = static_cast<const uint8_t *>(in);
+        auto *dst = static_cast<uint8_t *>(out);
+        size_t n = 0;
+        for (; n + 2 * LANES <= nblocks; n += 2 * LANES) {
+            encryptGroup<2>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        for (; n + LANES <= nblocks; n += LANES) {
+            encryptGroup<1>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        return n;
+    }
+
+    size_t encryptBlocksNEON(const uint32_t *round_keys, const uint8_t rounds,
+                             const void *in, void *out, const size_t nblocks) {
+        return encryptBlocksWith(SharedKeys{round_keys}, rounds, in, out, nblocks);
+    }
+
+    size_t encryptLanesNEON(const uint32_t *lane_keys, const uint8_t rounds,
+                            const void *in, void *out, const size_t nblocks) {
+        return encryptBlocksWith(LaneKeys{lane_keys}, rounds, in, out, nblocks);
+    }
+
+    template<typename Keys>
+    size_t decryptBlocksWith(const Keys &keys, const uint8_t rounds, const void *in, void *out, const size_t nblocks) {
+        const auto *src = static_cast<const uint8_t *>(in);
+        auto *dst = static_cast<uint8_t *>(out);
+        size_t n = 0;
+        for (; n + 2 * LANES <= nblocks; n += 2 * LANES) {
+            decryptGroup<2>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        for (; n + LANES <= nblocks; n += LANES) {
+            decryptGroup<1>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        return n;
+    }
+
+    size_t decryptBlocksNEON(const uint32_t *round_keys, const uint8_t rounds,
+                             const void *in, void *out, const size_t nblocks) {
+        return decryptBlocksWith(SharedKeys{round_keys}, rounds, in, out, nblocks);
+    }
+
+    size_t decryptLanesNEON(const uint32_t *lane_keys, const uint8_t rounds,
+                            const void *in, void *out, const size_t nblocks) {
+        return decryptBlocksWith(LaneKeys{lane_keys}, rounds, in, out, nblocks);
+    }
+
+    void mixKeysNEON(uint32_t *s, uint32_t *l, const uint16_t key_size, const uint16_t c) {
+        uint32x4_t a = vdupq_n_u32(0);
+        uint32x4_t b = vdupq_n_u32(0);
+        uint16_t i = 0, j = 0;
+        const uint32_t steps = 3u * (c > key_size ? c : key_size);
+
+        for (uint32_t p = 0; p < steps; ++p) {
+            const uint32x4_t x = vaddq_u32(vaddq_u32(vld1q_u32(s + LANES * i), a), b);
+            a = vsriq_n_u32(vshlq_n_u32(x, 3), x, 29);
+            vst1q_u32(s + LANES * i, a);
+
+            const uint32x4_t ab = vaddq_u32(a, b);
+            b = rotlv(vaddq_u32(vld1q_u32(l + LANES * j), ab), ab);
+            vst1q_u32(l + LANES * j, b);
+
+            if (++i == key_size) {
+                i = 0;
+            }
+            if (++j == c) {
+                j = 0;
+            }
+        }
+    }
+
+    const rc6_kernels::Backend NEON_BACKEND = {
+        "neon", rc6_kernels::BACKEND_NEON, LANES, encryptBlocksNEON, decryptBlocksNEON, mixKeysNEON,
+        encryptLanesNEON, decryptLanesNEON, nullptr
+    };
+}
+
+const rc6_kernels::Backend *rc6_kernels::neonBackend() {
+    return &NEON_BACKEND;
+}
+
+#else
+
+const rc6_kernels::Backend *rc6_kernels::neonBackend() {
+    return nullptr;
+}
+
+#endif
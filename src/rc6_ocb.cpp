@@ -0,0 +1,346 @@
+/**
+ * @file rc6_ocb.cpp
+ * @brief Implementation file for RC6 in OCB authenticated encryption mode.
+ *
+ * This file provides the implementation of OCB3 as defined in the
+ * rc6_ocb.hpp header file.
+ */
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "rc6_ocb.hpp"
+#include "rc6_util.hpp"
+
+constexpr size_t RC6OCB::BLOCK_SIZE;
+constexpr size_t RC6OCB::MAX_NONCE_SIZE;
+constexpr size_t RC6OCB::MAX_TAG_SIZE;
+constexpr size_t RC6OCB::BATCH_BLOCKS;
+constexpr size_t RC6OCB::L_COUNT;
+
+namespace {
+    /**
+     * @brief Multiply a block by x in GF(2^128), as double() in RFC 7253.
+     */
+    void doubleBlock(const uint8_t *in, uint8_t *out) {
+        const uint8_t carry = static_cast<uint8_t>(in[0] >> 7);
+        for (size_t i = 0; i < 15; ++i) {
+            out[i] = static_cast<uint8_t>((in[i] << 1) | (in[i + 1] >> 7));
+        }
+        out[15] = static_cast<uint8_t>((in[15] << 1) ^ (0x87 & (0 - carry)));
+    }
+
+    /**
+     * @brief Number of trailing zero bits of a non-zero index.
+     */
+    unsigned trailingZeros(uint64_t index) {
+        unsigned count = 0;
+        while ((index & 1) == 0) {
+            index >>= 1;
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief XOR count consecutive 16-byte blocks into a 16-byte sum.
+     */
+    void foldBlocks(uint8_t *sum, const uint8_t *blocks, const size_t count) {
+        for (size_t n = 0; n < count; ++n) {
+            rc6_util::xorBytes(sum, sum, blocks + 16 * n, 16);
+        }
+    }
+}
+
+/**
+ * @brief Constructor.
+ *
+ * Precomputes L_*, L_$ and L_0 .. L_63, which covers messages of up to
+ * 2^64 blocks.
+ *
+ * @param cipher Initialized RC6 object.
+ * @param tag_size Tag length in bytes (1 to 16).
+ * @throws std::runtime_error if the cipher is not initialized.
+ * @throws std::invalid_argument if tag_size is out of range.
+ */
+RC6OCB::RC6OCB(const RC6 &cipher, const size_t tag_size)
+    : cipher_(cipher), tag_size_(tag_size), l_star_(), l_dollar_(), l_() {
+    if (!cipher.isInitialized()) {
+        throw std::runtime_error("RC6 not initialized");
+    }
+
+    if (tag_size == 0 || tag_size > MAX_TAG_SIZE) {
+        throw std::invalid_argument("Tag size must be between 1 and 16 bytes");
+    }
+
+    cipher_.encryptUnchecked(l_star_);
+    doubleBlock(l_star_, l_dollar_);
+    doubleBlock(l_dollar_, l_[0]);
+    for (size_t i = 1; i < L_COUNT; ++i) {
+        doubleBlock(l_[i - 1], l_[i]);
+    }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * L_* is the encryption of the zero block, so the L values are as secret
+ * as the key and are wiped.
+ */
+RC6OCB::~RC6OCB() {
+    rc6_util::secureZero(l_star_, sizeof(l_star_));
+    rc6_util::secureZero(l_dollar_, sizeof(l_dollar_));
+    rc6_util::secureZero(l_, sizeof(l_));
+}
+
+/**
+ * @brief Derive Offset_0 from the nonce.
+ *
+ * Builds the formatted nonce block, encrypts it with its low six bits
+ * cleared to get Ktop, and extracts 128 bits of Stretch starting at bit
+ * bottom.
+ *
+ * @param nonce Pointer to the nonce.
+ * @param nonce_len Nonce length in bytes.
+ * @param offset Pointer to the 16-byte output.
+ */
+void RC6OCB::initialOffset(const uint8_t *nonce, const size_t nonce_len, uint8_t *offset) const {
+    uint8_t block[BLOCK_SIZE] = {};
+    block[0] = static_cast<uint8_t>(((tag_size_ * 8) % 128) << 1);
+    block[BLOCK_SIZE - 1 - nonce_len] |= 0x01;
+    std::memcpy(block + BLOCK_SIZE - nonce_len, nonce, nonce_len);
+
+    const unsigned bottom = block[BLOCK_SIZE - 1] & 0x3f;
+    block[BLOCK_SIZE - 1] &= 0xc0;
+
+    uint8_t stretch[BLOCK_SIZE + 8];
+    cipher_.encryptUnchecked(block);
+    std::memcpy(stretch, block, BLOCK_SIZE);
+    for (size_t i = 0; i < 8; ++i) {
+        stretch[BLOCK_SIZE + i] = static_cast<uint8_t>(block[i] ^ block[i + 1]);
+    }
+
+    const unsigned byte_shift = bottom / 8;
+    const unsigned bit_shift = bottom % 8;
+    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+        // Reads at most stretch[23]; a zero bit_shift shifts the second byte out entirely
+        offset[i] = static_cast<uint8_t>((stretch[i + byte_shift] << bit_shift) |
+                                         (stretch[i + byte_shift + 1] >> (8 - bit_shift)));
+    }
+}
+
+/**
+ * @brief Compute the offsets of the next blocks.
+ * @param offset Current offset, advanced to the last block's offset.
+ * @param index Index of the last block done, advanced by count.
+ * @param offsets Output, count * 16 bytes.
+ * @param count Number of blocks.
+ */
+void RC6OCB::nextOffsets(uint8_t *offset, uint64_t &index, uint8_t *offsets, const size_t count) const {
+    for (size_t n = 0; n < count; ++n) {
+        rc6_util::xorBytes(offset, offset, l_[trailingZeros(++index)], BLOCK_SIZE);
+        std::memcpy(offsets + BLOCK_SIZE * n, offset, BLOCK_SIZE);
+    }
+}
+
+/**
+ * @brief Compute the associated data hash HASH(K, A).
+ * @param ad Pointer to the associated data.
+ * @param ad_len Associated data length in bytes.
+ * @param sum Pointer to the 16-byte output.
+ */
+void RC6OCB::hash(const uint8_t *ad, const size_t ad_len, uint8_t *sum) const {
+    uint8_t offset[BLOCK_SIZE] = {};
+    uint8_t offsets[BATCH_BLOCKS * BLOCK_SIZE];
+    uint8_t blocks[BATCH_BLOCKS * BLOCK_SIZE];
+    uint64_t index = 0;
+    std::memset(sum, 0, BLOCK_SIZE);
+
+    const size_t full = ad_len / BLOCK_SIZE;
+    for (size_t done = 0; done < full;) {
+        const size_t batch = std::min(full - done, BATCH_BLOCKS);
+        nextOffsets(offset, index, offsets, batch);
+        rc6_util::xorBytes(blocks, ad + BLOCK_SIZE * done, offsets, BLOCK_SIZE * batch);
+        cipher_.encryptBlocksUnchecked(blocks, blocks, batch);
+        foldBlocks(sum, blocks, batch);
+        done += batch;
+    }
+
+    const size_t rest = ad_len % BLOCK_SIZE;
+    if (rest != 0) {
+        uint8_t block[BLOCK_SIZE] = {};
+        std::memcpy(block, ad + BLOCK_SIZE * full, rest);
+        block[rest] = 0x80;
+        rc6_util::xorBytes(block, block, offset, BLOCK_SIZE);
+        rc6_util::xorBytes(block, block, l_star_, BLOCK_SIZE);
+        cipher_.encryptUnchecked(block);
+        rc6_util::xorBytes(sum, sum, block, BLOCK_SIZE);
+    }
+}
+
+/**
+ * @brief Encrypt or decrypt the message and compute the final tag block.
+ *
+ * Full blocks are handled in batches: the offsets are computed, the batch
+ * is whitened into out, run through the bulk kernels, whitened again and
+ * folded into the checksum, so the data is read from memory only once.
+ *
+ * @param encrypting True to encrypt, false to decrypt.
+ * @param nonce Pointer to the nonce.
+ * @param nonce_len Nonce length in bytes.
+ * @param ad Pointer to the associated data.
+ * @param ad_len Associated data length in bytes.
+ * @param in Pointer to the input.
+ * @param len Message length in bytes.
+ * @param out Pointer to the output.
+ * @param tag Pointer to the 16-byte full tag output.
+ * @throws std::invalid_argument if a required pointer is null or nonce_len is out of range.
+ */
+void RC6OCB::crypt(const bool encrypting, const void *nonce, const size_t nonce_len, const void *ad,
+                   const size_t ad_len, const void *in, const size_t len, void *out, uint8_t *tag) const {
+    if (nonce == nullptr) {
+        throw std::invalid_argument("Nonce cannot be null");
+    }
+
+    if (nonce_len == 0 || nonce_len > MAX_NONCE_SIZE) {
+        throw std::invalid_argument("Nonce size must be between 1 and 15 bytes");
+    }
+
+    if (ad_len != 0 && ad == nullptr) {
+        throw std::invalid_argument("Associated data cannot be null");
+    }
+
+    if (len != 0 && (in == nullptr || out == nullptr)) {
+        throw std::invalid_argument("Data cannot be null");
+    }
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    uint8_t offset[BLOCK_SIZE];
+    uint8_t checksum[BLOCK_SIZE] = {};
+    uint8_t offsets[BATCH_BLOCKS * BLOCK_SIZE];
+    uint64_t index = 0;
+    initialOffset(static_cast<const uint8_t *>(nonce), nonce_len, offset);
+
+    const size_t full = len / BLOCK_SIZE;
+    for (size_t done = 0; done < full;) {
+        const size_t batch = std::min(full - done, BATCH_BLOCKS);
+        const uint8_t *batch_in = src + BLOCK_SIZE * done;
+        uint8_t *batch_out = dst + BLOCK_SIZE * done;
+
+        nextOffsets(offset, index, offsets, batch);
+        if (encrypting) {
+            // The checksum covers the plaintext, which may be overwritten in place
+            foldBlocks(checksum, batch_in, batch);
+            rc6_util::xorBytes(batch_out, batch_in, offsets, BLOCK_SIZE * batch);
+            cipher_.encryptBlocksUnchecked(batch_out, batch_out, batch);
+            rc6_util::xorBytes(batch_out, batch_out, offsets, BLOCK_SIZE * batch);
+        } else {
+            rc6_util::xorBytes(batch_out, batch_in, offsets, BLOCK_SIZE * batch);
+            cipher_.decryptBlocksUnchecked(batch_out, batch_out, batch);
+            rc6_util::xorBytes(batch_out, batch_out, offsets, BLOCK_SIZE * batch);
+            foldBlocks(checksum, batch_out, batch);
+        }
+        done += batch;
+    }
+
+    const size_t rest = len % BLOCK_SIZE;
+    if (rest != 0) {
+        uint8_t pad[BLOCK_SIZE];
+        rc6_util::xorBytes(offset, offset, l_star_, BLOCK_SIZE);
+        std::memcpy(pad, offset, BLOCK_SIZE);
+        cipher_.encryptUnchecked(pad);
+
+        uint8_t last[BLOCK_SIZE] = {};
+        if (encrypting) {
+            std::memcpy(last, src + BLOCK_SIZE * full, rest);
+        }
+        rc6_util::xorBytes(dst + BLOCK_SIZE * full, src + BLOCK_SIZE * full, pad, rest);
+        if (!encrypting) {
+            std::memcpy(last, dst + BLOCK_SIZE * full, rest);
+        }
+        last[rest] = 0x80;
+        rc6_util::xorBytes(checksum, checksum, last, BLOCK_SIZE);
+    }
+
+    // Tag = E(Checksum ^ Offset ^ L_$) ^ HASH(K, A)
+    uint8_t ad_sum[BLOCK_SIZE];
+    hash(static_cast<const uint8_t *>(ad), ad_len, ad_sum);
+    rc6_util::xorBytes(tag, checksum, offset, BLOCK_SIZE);
+    rc6_util::xorBytes(tag, tag, l_dollar_, BLOCK_SIZE);
+    cipher_.encryptUnchecked(tag);
+    rc6_util::xorBytes(tag, tag, ad_sum, BLOCK_SIZE);
+}
+
+/**
+ * @brief Encrypt and authenticate a message.
+ * @param nonce Pointer to the nonce.
+ * @param nonce_len Nonce length in bytes (1 to 15).
+ * @param ad Pointer to the associated data (may be null if ad_len is zero).
+ * @param ad_len Associated data length in bytes.
+ * @param in Pointer to the plaintext (may be null if len is zero).
+ * @param len Message length in bytes.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param tag Pointer to the tag output (tagSize() bytes).
+ * @throws std::invalid_argument if a required pointer is null or nonce_len is out of range.
+ */
+void RC6OCB::encrypt(const void *nonce, const size_t nonce_len, const void *ad, const size_t ad_len,
+                     const void *in, const size_t len, void *out, void *tag) const {
+    if (tag == nullptr) {
+        throw std::invalid_argument("Tag cannot be null");
+    }
+
+    uint8_t full_tag[BLOCK_SIZE];
+    crypt(true, nonce, nonce_len, ad, ad_len, in, len, out, full_tag);
+    std::memcpy(tag, full_tag, tag_size_);
+}
+
+/**
+ * @brief Decrypt a message and verify its tag.
+ *
+ * The tag comparison takes the same time wherever the tags differ. On
+ * failure the output is cleared so unauthenticated plaintext is never
+ * released.
+ *
+ * @param nonce Pointer to the nonce.
+ * @param nonce_len Nonce length in bytes (1 to 15).
+ * @param ad Pointer to the associated data (may be null if ad_len is zero).
+ * @param ad_len Associated data length in bytes.
+ * @param in Pointer to the ciphertext (may be null if len is zero).
+ * @param len Message length in bytes.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param tag Pointer to the tag to verify (tagSize() bytes).
+ * @return True if the tag is valid; otherwise out is zeroed and false is returned.
+ * @throws std::invalid_argument if a required pointer is null or nonce_len is out of range.
+ */
+bool RC6OCB::decrypt(const void *nonce, const size_t nonce_len, const void *ad, const size_t ad_len,
+                     const void *in, const size_t len, void *out, const void *tag) const {
+    if (tag == nullptr) {
+        throw std::invalid_argument("Tag cannot be null");
+    }
+
+    uint8_t full_tag[BLOCK_SIZE];
+    crypt(false, nonce, nonce_len, ad, ad_len, in, len, out, full_tag);
+
+    const auto *expected = static_cast<const uint8_t *>(tag);
+    uint8_t diff = 0;
+    for (size_t i = 0; i < tag_size_; ++i) {
+        diff |= static_cast<uint8_t>(full_tag[i] ^ expected[i]);
+    }
+
+    if (diff != 0) {
+        if (len != 0) {
+            std::memset(out, 0, len);
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Get the tag length.
+ * @return Tag length in bytes.
+ */
+size_t RC6OCB::tagSize() const {
+    return tag_size_;
+}
@@ -0,0 +1,489 @@
+/**
+ * @file rc6_parallel.cpp
+ * @brief Implementation file for the multithreaded RC6 bulk engine.
+ *
+ * This file provides the implementation of the worker pool as defined in
+ * the rc6_parallel.hpp header file.
+ */
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "rc6_cbc.hpp"
+#include "rc6_parallel.hpp"
+
+constexpr size_t RC6Parallel::BLOCK_SIZE;
+constexpr size_t RC6Parallel::DEFAULT_CHUNK_BYTES;
+constexpr size_t RC6Parallel::RING_SIZE;
+constexpr size_t RC6Parallel::SPIN_LIMIT;
+constexpr size_t RC6Parallel::CACHE_LINE;
+
+namespace {
+    /**
+     * @brief Hint to the CPU that the thread is busy-waiting.
+     */
+    inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    /**
+     * @brief Pin the calling thread to the index-th CPU it is allowed to run on.
+     */
+    void pinThread(const size_t index) {
+#ifdef __linux__
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+            return;
+        }
+
+        const size_t count = static_cast<size_t>(CPU_COUNT(&allowed));
+        size_t wanted = index % count;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed) && wanted-- == 0) {
+                cpu_set_t one;
+                CPU_ZERO(&one);
+                CPU_SET(cpu, &one);
+                pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+                return;
+            }
+        }
+#else
+        (void) index;
+#endif
+    }
+}
+
+/**
+ * @brief Constructor.
+ *
+ * Starts threads - 1 workers; the calling thread is the remaining one.
+ *
+ * @param threads Total number of threads including the caller; 0 uses
+ *                the number of hardware threads.
+ * @param chunk_bytes Amount of data per task; rounded up to a multiple of
+ *                    16 (default: 16 KiB).
+ * @param pin_threads Pin worker i to the i-th CPU the process may run on
+ *                    (Linux only; ignored elsewhere).
+ * @throws std::invalid_argument if chunk_bytes is zero or too large to round up.
+ * @throws std::system_error if a worker thread cannot be started; workers
+ *         already running are stopped and joined first.
+ */
+RC6Parallel::RC6Parallel(size_t threads, const size_t chunk_bytes, const bool pin_threads)
+    : chunk_bytes_((chunk_bytes + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE), spin_limit_(0),
+      ring_(new Cell[RING_SIZE]), enqueue_pos_(0), pad0_(), dequeue_pos_(0), pad1_(), sleepers_(0),
+      stopping_(false) {
+    if (chunk_bytes == 0) {
+        throw std::invalid_argument("Chunk size cannot be zero");
+    }
+
+    // Rounding up must not wrap chunk_bytes_ around to zero
+    if (chunk_bytes > std::numeric_limits<size_t>::max() - (BLOCK_SIZE - 1)) {
+        throw std::invalid_argument("Chunk size is too large");
+    }
+
+    for (size_t i = 0; i < RING_SIZE; ++i) {
+        ring_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    if (threads == 0) {
+        threads = hardware;
+    }
+
+    // Spinning only pays off when every thread has a CPU of its own
+    spin_limit_ = threads <= hardware ? SPIN_LIMIT : 0;
+
+    workers_.reserve(threads - 1);
+    try {
+        for (size_t i = 1; i < threads; ++i) {
+            workers_.emplace_back(&RC6Parallel::workerLoop, this, i, pin_threads);
+        }
+    } catch (...) {
+        // Joinable threads left in workers_ would call std::terminate
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_.store(true, std::memory_order_seq_cst);
+        }
+        work_cv_.notify_all();
+        for (auto &worker: workers_) {
+            worker.join();
+        }
+        throw;
+    }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Signals the workers to stop and joins them, then releases tickets of
+ * finished calls that no worker picked up.
+ */
+RC6Parallel::~RC6Parallel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_.store(true, std::memory_order_seq_cst);
+    }
+    work_cv_.notify_all();
+
+    for (auto &worker: workers_) {
+        worker.join();
+    }
+
+    while (Call *call = pop()) {
+        release(call);
+    }
+}
+
+/**
+ * @brief Get the number of threads used, including the caller.
+ * @return Thread count.
+ */
+size_t RC6Parallel::threadCount() const {
+    return workers_.size() + 1;
+}
+
+/**
+ * @brief Get the chunk size.
+ * @return Bytes per task.
+ */
+size_t RC6Parallel::chunkBytes() const {
+    return chunk_bytes_;
+}
+
+/**
+ * @brief Add a ticket to the ring.
+ *
+ * Bounded MPMC queue: each slot's sequence tells producers and consumers
+ * whose turn it is, so a position is claimed with one compare-and-swap.
+ *
+ * @param call The call.
+ * @return False if the ring is full.
+ */
+bool RC6Parallel::push(Call *call) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell &cell = ring_[pos & (RING_SIZE - 1)];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence == pos) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.call = call;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (sequence < pos) {
+            return false;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Take a ticket from the ring.
+ * @return The ticket's call, or null if the ring is empty.
+ */
+RC6Parallel::Call *RC6Parallel::pop() {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell &cell = ring_[pos & (RING_SIZE - 1)];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence == pos + 1) {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                Call *call = cell.call;
+                cell.sequence.store(pos + RING_SIZE, std::memory_order_release);
+                return call;
+            }
+        } else if (sequence < pos + 1) {
+            return nullptr;
+        } else {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Claim and run chunks of a call until none are left.
+ *
+ * The thread finishing the last chunk wakes the caller if it has parked.
+ *
+ * @param call The call.
+ */
+void RC6Parallel::help(Call *call) {
+    for (size_t index; (index = call->next.fetch_add(1, std::memory_order_relaxed)) < call->count;) {
+        (*call->body)(index);
+
+        if (call->remaining.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+            call->parked.load(std::memory_order_seq_cst)) {
+            // Take the lock so the caller cannot miss the notification
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_cv_.notify_all();
+        }
+    }
+}
+
+/**
+ * @brief Drop one reference to a call, freeing it with the last one.
+ *
+ * Tickets can outlive their call's chunks, since a worker may only take
+ * one after the caller has returned; the reference count keeps the call
+ * valid until then.
+ *
+ * @param call The call.
+ */
+void RC6Parallel::release(Call *call) {
+    if (call->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete call;
+    }
+}
+
+/**
+ * @brief Worker thread main loop.
+ *
+ * Polls the ring, spinning for up to spin_limit_ empty polls before
+ * parking on work_cv_ until work is published or the pool shuts down.
+ *
+ * @param index Worker number, used for pinning.
+ * @param pin Pin the worker to one CPU.
+ */
+void RC6Parallel::workerLoop(const size_t index, const bool pin) {
+    if (pin) {
+        pinThread(index);
+    }
+
+    size_t idle = 0;
+    for (;;) {
+        if (Call *call = pop()) {
+            help(call);
+            release(call);
+            idle = 0;
+            continue;
+        }
+
+        if (stopping_.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        if (++idle < spin_limit_) {
+            cpuRelax();
+            continue;
+        }
+
+        // Announce the sleep before the final check; pairs with the fence in parallelFor
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        while (!stopping_.load(std::memory_order_seq_cst) &&
+               enqueue_pos_.load(std::memory_order_seq_cst) == dequeue_pos_.load(std::memory_order_seq_cst)) {
+            work_cv_.wait(lock);
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+}
+
+/**
+ * @brief Run body(0) .. body(count - 1) on the pool and wait for completion.
+ *
+ * The caller claims chunks like any helper, then spins and finally parks
+ * until chunks still running elsewhere have finished. It never waits for
+ * an unclaimed chunk, so nested calls from a worker cannot deadlock.
+ *
+ * @param count Number of chunks.
+ * @param body Chunk function.
+ */
+void RC6Parallel::parallelFor(const size_t count, const std::function<void(size_t)> &body) {
+    if (count == 0) {
+        return;
+    }
+
+    if (count == 1 || workers_.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    const size_t wanted = std::min(count - 1, workers_.size());
+    Call *call = new Call;
+    call->body = &body;
+    call->count = count;
+    call->next.store(0, std::memory_order_relaxed);
+    call->remaining.store(count, std::memory_order_relaxed);
+    call->refs.store(1 + wanted, std::memory_order_relaxed);
+    call->parked.store(false, std::memory_order_relaxed);
+
+    // A full ring only means fewer helpers; the caller covers the rest
+    size_t published = 0;
+    while (published < wanted && push(call)) {
+        ++published;
+    }
+    call->refs.fetch_sub(wanted - published, std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (published != 0 && sleepers_.load(std::memory_order_relaxed) != 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        work_cv_.notify_all();
+    }
+
+    help(call);
+
+    for (size_t spin = 0; call->remaining.load(std::memory_order_acquire) != 0; ++spin) {
+        if (spin < spin_limit_) {
+            cpuRelax();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        call->parked.store(true, std::memory_order_seq_cst);
+        while (call->remaining.load(std::memory_order_seq_cst) != 0) {
+            done_cv_.wait(lock);
+        }
+        break;
+    }
+
+    release(call);
+}
+
+/**
+ * @brief Encrypt consecutive blocks independently (ECB).
+ * @param cipher Initialized RC6 object.
+ * @param in Pointer to nblocks * 16 bytes of plaintext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param nblocks Number of blocks.
+ * @throws std::runtime_error if the cipher is not initialized.
+ * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+ */
+void RC6Parallel::encryptECB(const RC6 &cipher, const void *in, void *out, const size_t nblocks) {
+    // Validate once up front so that tasks cannot throw
+    if (!cipher.isInitialized()) {
+        throw std::runtime_error("RC6 not initialized");
+    }
+
+    if (nblocks != 0 && (in == nullptr || out == nullptr)) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    const size_t chunk_blocks = chunk_bytes_ / BLOCK_SIZE;
+
+    parallelFor((nblocks + chunk_blocks - 1) / chunk_blocks, [&](const size_t chunk) {
+        const size_t first = chunk * chunk_blocks;
+        const size_t count = std::min(chunk_blocks, nblocks - first);
+        cipher.encryptBlocks(src + BLOCK_SIZE * first, dst + BLOCK_SIZE * first, count);
+    });
+}
+
+/**
+ * @brief Decrypt consecutive blocks independently (ECB).
+ * @param cipher Initialized RC6 object.
+ * @param in Pointer to nblocks * 16 bytes of ciphertext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param nblocks Number of blocks.
+ * @throws std::runtime_error if the cipher is not initialized.
+ * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+ */
+void RC6Parallel::decryptECB(const RC6 &cipher, const void *in, void *out, const size_t nblocks) {
+    if (!cipher.isInitialized()) {
+        throw std::runtime_error("RC6 not initialized");
+    }
+
+    if (nblocks != 0 && (in == nullptr || out == nullptr)) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    const size_t chunk_blocks = chunk_bytes_ / BLOCK_SIZE;
+
+    parallelFor((nblocks + chunk_blocks - 1) / chunk_blocks, [&](const size_t chunk) {
+        const size_t first = chunk * chunk_blocks;
+        const size_t count = std::min(chunk_blocks, nblocks - first);
+        cipher.decryptBlocks(src + BLOCK_SIZE * first, dst + BLOCK_SIZE * first, count);
+    });
+}
+
+/**
+ * @brief Encrypt or decrypt data in counter mode.
+ *
+ * Each chunk generates its own keystream from its byte offset.
+ *
+ * @param ctr Counter mode context; its position is not used or changed.
+ * @param offset Byte offset of the data within the message.
+ * @param in Pointer to the input data.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param len Number of bytes.
+ * @throws std::invalid_argument if in or out is null and len is non-zero.
+ */
+void RC6Parallel::processCTR(const RC6CTR &ctr, const uint64_t offset, const void *in, void *out,
+                             const size_t len) {
+    if (len != 0 && (in == nullptr || out == nullptr)) {
+        throw std::invalid_argument("Data cannot be null");
+    }
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+
+    parallelFor((len + chunk_bytes_ - 1) / chunk_bytes_, [&](const size_t chunk) {
+        const size_t first = chunk * chunk_bytes_;
+        const size_t count = std::min(chunk_bytes_, len - first);
+        ctr.processAt(offset + first, src + first, dst + first, count);
+    });
+}
+
+/**
+ * @brief Decrypt a CBC message.
+ *
+ * The ciphertext block preceding each chunk is saved before any task runs,
+ * so chunks can be decrypted independently even in place.
+ *
+ * @param cipher Initialized RC6 object.
+ * @param iv Pointer to the 16-byte IV.
+ * @param in Pointer to nblocks * 16 bytes of ciphertext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param nblocks Number of blocks.
+ * @throws std::runtime_error if the cipher is not initialized.
+ * @throws std::invalid_argument if iv, in or out is null and nblocks is non-zero.
+ */
+void RC6Parallel::decryptCBC(const RC6 &cipher, const void *iv, const void *in, void *out,
+                             const size_t nblocks) {
+    if (!cipher.isInitialized()) {
+        throw std::runtime_error("RC6 not initialized");
+    }
+
+    if (nblocks != 0 && (iv == nullptr || in == nullptr || out == nullptr)) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    const RC6CBC cbc(cipher);
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    const size_t chunk_blocks = chunk_bytes_ / BLOCK_SIZE;
+    const size_t chunks = (nblocks + chunk_blocks - 1) / chunk_blocks;
+
+    std::vector<uint8_t> chain(BLOCK_SIZE * chunks);
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        const uint8_t *prev = chunk == 0 ? static_cast<const uint8_t *>(iv)
+                                         : src + BLOCK_SIZE * (chunk * chunk_blocks - 1);
+        std::memcpy(&chain[BLOCK_SIZE * chunk], prev, BLOCK_SIZE);
+    }
+
+    parallelFor(chunks, [&](const size_t chunk) {
+        const size_t first = chunk * chunk_blocks;
+        const size_t count = std::min(chunk_blocks, nblocks - first);
+        cbc.decrypt(&chain[BLOCK_SIZE * chunk], src + BLOCK_SIZE * first, dst + BLOCK_SIZE * first, count);
+    });
+}
@@ -0,0 +1,231 @@
+/**
+ * @file rc6_scalar.cpp
+ * @brief Interleaved scalar implementation of the RC6 bulk kernels.
+ *
+ * A single block is one long dependency chain: each round waits for two
+ * multiplies and two rotates of the previous one. This backend runs the
+ * rounds of several independent blocks side by side in general-purpose
+ * registers, so an in-order or narrow core can issue the multiplies of one
+ * block while those of another are still in flight. It needs no
+ * instruction set extension and is the bulk path on targets without
+ * AVX2 or NEON, such as ARMv7 or SSE2-only x86, and for short tails
+ * elsewhere.
+ *
+ * Rounds are unrolled by four, after which the A/B/C/D roles are back in
+ * place, so no register moves are needed between rounds.
+ */
+#include "rc6_kernels.hpp"
+#include "rc6_detail.hpp"
+
+namespace {
+    constexpr size_t LANES = 2; //!< Smallest group, the backend's lane count
+
+    // Wider groups hide more latency but need four registers per block
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__powerpc64__) || defined(__riscv)
+    constexpr size_t WIDE_GROUP = 4;
+#else
+    constexpr size_t WIDE_GROUP = 2;
+#endif
+
+    using rc6_detail::loadWord;
+    using rc6_detail::rotateLeft;
+    using rc6_detail::rotateRight;
+    using rc6_detail::storeWord;
+
+    RC6_ALWAYS_INLINE uint32_t mix(const uint32_t x) {
+        return rotateLeft(x * (2 * x + 1), 5);
+    }
+
+    // Round key j of block g: one schedule shared by every block
+    struct SharedKeys {
+        const uint32_t *rk;
+
+        RC6_ALWAYS_INLINE uint32_t operator()(size_t, const size_t j) const {
+            return rk[j];
+        }
+    };
+
+    // Round key j of block g: block g uses lane g % LANES of a word-major table
+    struct LaneKeys {
+        const uint32_t *lk;
+
+        RC6_ALWAYS_INLINE uint32_t operator()(const size_t g, const size_t j) const {
+            return lk[LANES * j + g % LANES];
+        }
+    };
+
+    // One encryption round in place: A and C are updated, the caller rotates the roles
+    template<size_t N, typename Keys>
+    RC6_ALWAYS_INLINE void encryptStep(uint32_t (&a)[N], const uint32_t (&b)[N], uint32_t (&c)[N],
+                                       const uint32_t (&d)[N], const Keys &keys, const size_t j) {
+        for (size_t g = 0; g < N; ++g) {
+            const uint32_t t = mix(b[g]);
+            const uint32_t u = mix(d[g]);
+            a[g] = rotateLeft(a[g] ^ t, u) + keys(g, j);
+            c[g] = rotateLeft(c[g] ^ u, t) + keys(g, j + 1);
+        }
+    }
+
+    // One decryption round in place: B and D are updated, the caller rotates the roles
+    template<size_t N, typename Keys>
+    RC6_ALWAYS_INLINE void decryptStep(const uint32_t (&a)[N], uint32_t (&b)[N], const uint32_t (&c)[N],
+                                       uint32_t (&d)[N], const Keys &keys, const size_t j) {
+        for (size_t g = 0; g < N; ++g) {
+            const uint32_t u = mix(c[g]);
+            const uint32_t t = mix(a[g]);
+            b[g] = rotateRight(b[g] - keys(g, j + 1), t) ^ u;
+            d[g] = rotateRight(d[g] - keys(g, j), u) ^ t;
+        }
+    }
+
+    template<size_t N, typename Keys>
+    RC6_ALWAYS_INLINE void encryptGroup(const Keys &keys, const uint8_t rounds, const uint8_t *in, uint8_t *out) {
+        uint32_t a[N], b[N], c[N], d[N];
+        for (size_t g = 0; g < N; ++g) {
+            a[g] = loadWord(in + 16 * g);
+            b[g] = loadWord(in + 16 * g + 4) + keys(g, 0);
+            c[g] = loadWord(in + 16 * g + 8);
+            d[g] = loadWord(in + 16 * g + 12) + keys(g, 1);
+        }
+
+        size_t i = 1;
+        for (; i + 3 <= rounds; i += 4) {
+            encryptStep(a, b, c, d, keys, 2 * i);
+            encryptStep(b, c, d, a, keys, 2 * i + 2);
+            encryptStep(c, d, a, b, keys, 2 * i + 4);
+            encryptStep(d, a, b, c, keys, 2 * i + 6);
+        }
+        for (; i <= rounds; ++i) {
+            encryptStep(a, b, c, d, keys, 2 * i);
+            for (size_t g = 0; g < N; ++g) {
+                const uint32_t na = a[g];
+                a[g] = b[g];
+                b[g] = c[g];
+                c[g] = d[g];
+                d[g] = na;
+            }
+        }
+
+        for (size_t g = 0; g < N; ++g) {
+            storeWord(out + 16 * g, a[g] + keys(g, 2 * rounds + 2));
+            storeWord(out + 16 * g + 4, b[g]);
+            storeWord(out + 16 * g + 8, c[g] + keys(g, 2 * rounds + 3));
+            storeWord(out + 16 * g + 12, d[g]);
+        }
+    }
+
+    template<size_t N, typename Keys>
+    RC6_ALWAYS_INLINE void decryptGroup(const Keys &keys, const uint8_t rounds, const uint8_t *in, uint8_t *out) {
+        uint32_t a[N], b[N], c[N], d[N];
+        for (size_t g = 0; g < N; ++g) {
+            a[g] = loadWord(in + 16 * g) - keys(g, 2 * rounds + 2);
+            b[g] = loadWord(in + 16 * g + 4);
+            c[g] = loadWord(in + 16 * g + 8) - keys(g, 2 * rounds + 3);
+            d[g] = loadWord(in + 16 * g + 12);
+        }
+
+        size_t i = rounds;
+        for (; i >= 4; i -= 4) {
+            decryptStep(a, b, c, d, keys, 2 * i);
+            decryptStep(d, a, b, c, keys, 2 * i - 2);
+            decryptStep(c, d, a, b, keys, 2 * i - 4);
+            decryptStep(b, c, d, a, keys, 2 * i - 6);
+        }
+        for (; i > 0; --i) {
+            decryptStep(a, b, c, d, keys, 2 * i);
+            for (size_t g = 0; g < N; ++g) {
+                const uint32_t nd = d[g];
+                d[g] = c[g];
+                c[g] = b[g];
+                b[g] = a[g];
+                a[g] = nd;
+            }
+        }
+
+        for (size_t g = 0; g < N; ++g) {
+            storeWord(out + 16 * g, a[g]);
+            storeWord(out + 16 * g + 4, b[g] - keys(g, 0));
+            storeWord(out + 16 * g + 8, c[g]);
+            storeWord(out + 16 * g + 12, d[g] - keys(g, 1));
+        }
+    }
+
+    // Groups start at multiples of LANES, so group block g is in lane g % LANES
+    template<typename Keys>
+    size_t encryptBlocksWith(const Keys &keys, const uint8_t rounds, const void *in, void *out, const size_t nblocks) {
+        const auto *src = static_cast<const uint8_t *>(in);
+        auto *dst = static_cast<uint8_t *>(out);
+        size_t n = 0;
+        for (; n + WIDE_GROUP <= nblocks; n += WIDE_GROUP) {
+            encryptGroup<WIDE_GROUP>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        for (; n + LANES <= nblocks; n += LANES) {
+            encryptGroup<LANES>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        return n;
+    }
+
+    size_t encryptBlocksScalar(const uint32_t *round_keys, const uint8_t rounds,
+                               const void *in, void *out, const size_t nblocks) {
+        return encryptBlocksWith(SharedKeys{round_keys}, rounds, in, out, nblocks);
+    }
+
+    size_t encryptLanesScalar(const uint32_t *lane_keys, const uint8_t rounds,
+                              const void *in, void *out, const size_t nblocks) {
+        return encryptBlocksWith(LaneKeys{lane_keys}, rounds, in, out, nblocks);
+    }
+
+    template<typename Keys>
+    size_t decryptBlocksWith(const Keys &keys, const uint8_t rounds, const void *in, void *out, const size_t nblocks) {
+        const auto *src = static_cast<const uint8_t *>(in);
+        auto *dst = static_cast<uint8_t *>(out);
+        size_t n = 0;
+        for (; n + WIDE_GROUP <= nblocks; n += WIDE_GROUP) {
+            decryptGroup<WIDE_GROUP>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        for (; n + LANES <= nblocks; n += LANES) {
+            decryptGroup<LANES>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        return n;
+    }
+
+    size_t decryptBlocksScalar(const uint32_t *round_keys, const uint8_t rounds,
+                               const void *in, void *out, const size_t nblocks) {
+        return decryptBlocksWith(SharedKeys{round_keys}, rounds, in, out, nblocks);
+    }
+
+    size_t decryptLanesScalar(const uint32_t *lane_keys, const uint8_t rounds,
+                              const void *in, void *out, const size_t nblocks) {
+        return decryptBlocksWith(LaneKeys{lane_keys}, rounds, in, out, nblocks);
+    }
+
+    void mixKeysScalar(uint32_t *s, uint32_t *l, const uint16_t key_size, const uint16_t c) {
+        uint32_t a[LANES] = {0};
+        uint32_t b[LANES] = {0};
+        uint16_t i = 0, j = 0;
+        const uint32_t steps = 3u * (c > key_size ? c : key_size);
+
+        for (uint32_t p = 0; p < steps; ++p) {
+            for (size_t k = 0; k < LANES; ++k) {
+                a[k] = s[LANES * i + k] = rotateLeft(s[LANES * i + k] + a[k] + b[k], 3);
+                b[k] = l[LANES * j + k] = rotateLeft(l[LANES * j + k] + a[k] + b[k], a[k] + b[k]);
+            }
+
+            if (++i == key_size) {
+                i = 0;
+            }
+            if (++j == c) {
+                j = 0;
+            }
+        }
+    }
+
+    const rc6_kernels::Backend SCALAR_BACKEND = {
+        "scalar", rc6_kernels::BACKEND_SCALAR, LANES, encryptBlocksScalar, decryptBlocksScalar, mixKeysScalar,
+        encryptLanesScalar, decryptLanesScalar, nullptr
+    };
+}
+
+const rc6_kernels::Backend *rc6_kernels::scalarBackend() {
+    return &SCALAR_BACKEND;
+}
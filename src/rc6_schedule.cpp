@@ -0,0 +1,341 @@
+/**
+ * @file rc6_schedule.cpp
+ * @brief Implementation file for key schedules laid out for the vector kernels.
+ *
+ * This file provides the implementation of the transposed schedule as
+ * defined in the rc6_schedule.hpp header file.
+ */
+#include <stdexcept>
+#include <utility>
+
+#include "rc6_schedule.hpp"
+#include "rc6_kernels.hpp"
+#include "rc6_trace.hpp"
+#include "rc6_util.hpp"
+
+/**
+ * @brief Default constructor.
+ *
+ * Creates an uninitialized schedule.
+ */
+RC6Schedule::RC6Schedule() noexcept
+    : backend_(nullptr), rounds_(0), words_(0), storage_(), lane_keys_(nullptr) {
+}
+
+/**
+ * @brief Construct the broadcast layout of one cipher.
+ * @param cipher Initialized cipher.
+ * @throws std::runtime_error if the cipher is not initialized.
+ */
+RC6Schedule::RC6Schedule(const RC6 &cipher) : RC6Schedule() {
+    init(cipher);
+}
+
+/**
+ * @brief Construct a layout with one cipher per lane.
+ * @param ciphers Array of count cipher pointers.
+ * @param count Number of ciphers; must divide lanes().
+ * @throws std::invalid_argument if ciphers or any cipher is null, count
+ *         does not divide the lane count, or the round counts differ.
+ * @throws std::runtime_error if a cipher is not initialized.
+ */
+RC6Schedule::RC6Schedule(const RC6 *const *ciphers, const size_t count) : RC6Schedule() {
+    initMany(ciphers, count);
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Wipes the table.
+ */
+RC6Schedule::~RC6Schedule() {
+    clear();
+}
+
+/**
+ * @brief Move constructor.
+ *
+ * Takes over the table; it is not copied, so nothing is left behind.
+ *
+ * @param other The object to move from.
+ */
+RC6Schedule::RC6Schedule(RC6Schedule &&other) noexcept
+    : backend_(other.backend_), rounds_(other.rounds_), words_(other.words_),
+      storage_(std::move(other.storage_)), lane_keys_(other.lane_keys_) {
+    other.backend_ = nullptr;
+    other.words_ = 0;
+    other.lane_keys_ = nullptr;
+}
+
+/**
+ * @brief Move assignment operator.
+ *
+ * Wipes the current table and takes over the source's.
+ *
+ * @param other The object to move from.
+ * @return Reference to this object.
+ */
+RC6Schedule &RC6Schedule::operator=(RC6Schedule &&other) noexcept {
+    if (this != &other) {
+        clear();
+        backend_ = other.backend_;
+        rounds_ = other.rounds_;
+        words_ = other.words_;
+        storage_ = std::move(other.storage_);
+        lane_keys_ = other.lane_keys_;
+        other.backend_ = nullptr;
+        other.words_ = 0;
+        other.lane_keys_ = nullptr;
+    }
+    return *this;
+}
+
+/**
+ * @brief Build the broadcast layout of one cipher.
+ * @param cipher Initialized cipher.
+ * @throws std::runtime_error if the cipher is not initialized.
+ */
+void RC6Schedule::init(const RC6 &cipher) {
+    const RC6 *ciphers[1] = {&cipher};
+    initMany(ciphers, 1);
+}
+
+/**
+ * @brief Build a layout with one cipher per lane.
+ *
+ * The new table is filled before the old one is wiped, so the schedule is
+ * unchanged if an argument is rejected.
+ *
+ * @param ciphers Array of count cipher pointers.
+ * @param count Number of ciphers; must divide lanes().
+ * @throws std::invalid_argument if ciphers or any cipher is null, count
+ *         does not divide the lane count, or the round counts differ.
+ * @throws std::runtime_error if a cipher is not initialized.
+ */
+void RC6Schedule::initMany(const RC6 *const *ciphers, const size_t count) {
+    const rc6_kernels::Backend *backend = rc6_kernels::activeBackend();
+    const size_t lanes = backend->lanes;
+
+    if (ciphers == nullptr) {
+        throw std::invalid_argument("Cipher cannot be null");
+    }
+
+    if (count == 0 || lanes % count != 0) {
+        throw std::invalid_argument("Cipher count must divide the lane count");
+    }
+
+    for (size_t k = 0; k < count; ++k) {
+        if (ciphers[k] == nullptr) {
+            throw std::invalid_argument("Cipher cannot be null");
+        }
+        if (!ciphers[k]->isInitialized()) {
+            throw std::runtime_error("RC6 not initialized");
+        }
+        if (ciphers[k]->rounds_ != ciphers[0]->rounds_) {
+            throw std::invalid_argument("Ciphers must have the same number of rounds");
+        }
+    }
+
+    const uint8_t rounds = ciphers[0]->rounds_;
+    const size_t key_size = 2 * rounds + 4;
+    const size_t words = key_size * lanes;
+
+    // new[] only guarantees the alignment of uint32_t, so over-allocate and round up
+    const size_t slack = rc6_kernels::LANE_KEY_ALIGNMENT / sizeof(uint32_t);
+    std::unique_ptr<uint32_t[]> storage(new uint32_t[words + slack]);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(storage.get());
+    const uintptr_t mask = rc6_kernels::LANE_KEY_ALIGNMENT - 1;
+    uint32_t *lane_keys = reinterpret_cast<uint32_t *>((address + mask) & ~mask);
+
+    for (size_t k = 0; k < lanes; ++k) {
+        const uint32_t *round_keys = ciphers[k % count]->round_keys_;
+        const size_t lane = rc6_kernels::laneOf(backend, k);
+        for (size_t j = 0; j < key_size; ++j) {
+            lane_keys[j * lanes + lane] = round_keys[j];
+        }
+    }
+
+    clear();
+    backend_ = backend;
+    rounds_ = rounds;
+    words_ = words;
+    storage_ = std::move(storage);
+    lane_keys_ = lane_keys;
+}
+
+/**
+ * @brief Copy the round keys of one lane out of the table.
+ * @param lane Lane index as used by the backend.
+ * @param round_keys Output array of 2 * rounds + 4 words.
+ */
+void RC6Schedule::laneSchedule(const size_t lane, uint32_t *round_keys) const noexcept {
+    const size_t lanes = backend_->lanes;
+    for (size_t j = 0; j < 2 * static_cast<size_t>(rounds_) + 4; ++j) {
+        round_keys[j] = lane_keys_[j * lanes + lane];
+    }
+}
+
+/**
+ * @brief Encrypt multiple consecutive blocks in place.
+ * @param blocks Pointer to nblocks * 16 bytes of data.
+ * @param nblocks Number of 16-byte blocks to encrypt.
+ * @throws std::runtime_error if the schedule is not initialized.
+ * @throws std::invalid_argument if blocks is null and nblocks is non-zero.
+ */
+void RC6Schedule::encryptBlocks(void *blocks, const size_t nblocks) const {
+    encryptBlocks(blocks, blocks, nblocks);
+}
+
+/**
+ * @brief Encrypt multiple consecutive blocks out of place.
+ * @param in Pointer to nblocks * 16 bytes of plaintext.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks to encrypt.
+ * @throws std::runtime_error if the schedule is not initialized.
+ * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+ */
+void RC6Schedule::encryptBlocks(const void *in, void *out, const size_t nblocks) const {
+    if (!isInitialized()) {
+        throw std::runtime_error("RC6Schedule not initialized");
+    }
+
+    if (nblocks == 0) {
+        return;
+    }
+
+    if (in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    encryptBlocksUnchecked(in, out, nblocks);
+}
+
+/**
+ * @brief Decrypt multiple consecutive blocks in place.
+ * @param blocks Pointer to nblocks * 16 bytes of data.
+ * @param nblocks Number of 16-byte blocks to decrypt.
+ * @throws std::runtime_error if the schedule is not initialized.
+ * @throws std::invalid_argument if blocks is null and nblocks is non-zero.
+ */
+void RC6Schedule::decryptBlocks(void *blocks, const size_t nblocks) const {
+    decryptBlocks(blocks, blocks, nblocks);
+}
+
+/**
+ * @brief Decrypt multiple consecutive blocks out of place.
+ * @param in Pointer to nblocks * 16 bytes of ciphertext.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks to decrypt.
+ * @throws std::runtime_error if the schedule is not initialized.
+ * @throws std::invalid_argument if in or out is null and nblocks is non-zero.
+ */
+void RC6Schedule::decryptBlocks(const void *in, void *out, const size_t nblocks) const {
+    if (!isInitialized()) {
+        throw std::runtime_error("RC6Schedule not initialized");
+    }
+
+    if (nblocks == 0) {
+        return;
+    }
+
+    if (in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Block cannot be null");
+    }
+
+    decryptBlocksUnchecked(in, out, nblocks);
+}
+
+/**
+ * @brief Encrypt multiple consecutive blocks without any checks.
+ *
+ * Whole groups go to the backend's lane kernel in one call. Each tail
+ * block takes its lane's keys back out of the table, so the result does
+ * not depend on where a call ends.
+ *
+ * @param in Pointer to nblocks * 16 bytes of plaintext.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks to encrypt.
+ */
+void RC6Schedule::encryptBlocksUnchecked(const void *in, void *out, const size_t nblocks) const noexcept {
+    assert(isInitialized() && (nblocks == 0 || (in != nullptr && out != nullptr)));
+
+    rc6_trace::encryptEntry(nblocks);
+
+    const size_t done = backend_->encryptLanes(lane_keys_, rounds_, in, out, nblocks);
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    if (done < nblocks) {
+        uint32_t round_keys[2 * RC6::MAX_ROUNDS + 4];
+        for (size_t n = done; n < nblocks; ++n) {
+            laneSchedule(rc6_kernels::laneOf(backend_, n - done), round_keys);
+            rc6_detail::encryptBlock(round_keys, rounds_, src + 16 * n, dst + 16 * n);
+        }
+        rc6_util::secureZero(round_keys, sizeof(uint32_t) * (2 * rounds_ + 4));
+    }
+    rc6_trace::backendBlocks(backend_->id, done);
+    rc6_trace::backendBlocks(rc6_kernels::BACKEND_COUNT, nblocks - done);
+    rc6_trace::encryptReturn(nblocks);
+}
+
+/**
+ * @brief Decrypt multiple consecutive blocks without any checks.
+ * @param in Pointer to nblocks * 16 bytes of ciphertext.
+ * @param out Pointer to nblocks * 16 bytes of output. Must either equal in
+ *            or not overlap it.
+ * @param nblocks Number of 16-byte blocks to decrypt.
+ */
+void RC6Schedule::decryptBlocksUnchecked(const void *in, void *out, const size_t nblocks) const noexcept {
+    assert(isInitialized() && (nblocks == 0 || (in != nullptr && out != nullptr)));
+
+    rc6_trace::decryptEntry(nblocks);
+
+    const size_t done = backend_->decryptLanes(lane_keys_, rounds_, in, out, nblocks);
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    if (done < nblocks) {
+        uint32_t round_keys[2 * RC6::MAX_ROUNDS + 4];
+        for (size_t n = done; n < nblocks; ++n) {
+            laneSchedule(rc6_kernels::laneOf(backend_, n - done), round_keys);
+            rc6_detail::decryptBlock(round_keys, rounds_, src + 16 * n, dst + 16 * n);
+        }
+        rc6_util::secureZero(round_keys, sizeof(uint32_t) * (2 * rounds_ + 4));
+    }
+    rc6_trace::backendBlocks(backend_->id, done);
+    rc6_trace::backendBlocks(rc6_kernels::BACKEND_COUNT, nblocks - done);
+    rc6_trace::decryptReturn(nblocks);
+}
+
+/**
+ * @brief Get the number of lanes of the layout.
+ * @return Lane count of the backend the layout was built for, or of the
+ *         backend in use if the schedule is not initialized.
+ */
+size_t RC6Schedule::lanes() const noexcept {
+    return (backend_ != nullptr ? backend_ : rc6_kernels::activeBackend())->lanes;
+}
+
+/**
+ * @brief Wipe the table and return to the uninitialized state.
+ */
+void RC6Schedule::clear() noexcept {
+    if (lane_keys_ != nullptr) {
+        rc6_util::secureZero(lane_keys_, sizeof(uint32_t) * words_);
+    }
+    storage_.reset();
+    backend_ = nullptr;
+    words_ = 0;
+    lane_keys_ = nullptr;
+}
+
+/**
+ * @brief Check if the schedule is initialized.
+ * @return True if a layout has been built.
+ */
+bool RC6Schedule::isInitialized() const noexcept {
+    return lane_keys_ != nullptr;
+}
@@ -0,0 +1,252 @@
+/**
+ * @file rc6_secure_pool.cpp
+ * @brief Implementation file for the locked-memory pool of RC6 objects.
+ *
+ * This file provides the implementation of the pool as defined in the
+ * rc6_secure_pool.hpp header file.
+ */
+#include <cassert>
+#include <new>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "rc6_secure_pool.hpp"
+#include "rc6_util.hpp"
+
+constexpr size_t RC6SecurePool::DEFAULT_SLAB_OBJECTS;
+
+namespace {
+    const size_t CACHE_LINE = 64; //!< Slot alignment, so objects never share a line
+
+    size_t pageSize() {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#else
+        return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    /**
+     * @brief Allocate whole pages, or return null.
+     */
+    void *allocatePages(const size_t bytes) {
+#ifdef _WIN32
+        return VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+        void *memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            return nullptr;
+        }
+#ifdef MADV_DONTDUMP
+        ::madvise(memory, bytes, MADV_DONTDUMP);
+#endif
+        return memory;
+#endif
+    }
+
+    void freePages(void *memory, const size_t bytes) {
+#ifdef _WIN32
+        (void) bytes;
+        VirtualFree(memory, 0, MEM_RELEASE);
+#else
+        ::munmap(memory, bytes);
+#endif
+    }
+
+    bool lockPages(void *memory, const size_t bytes) {
+#ifdef _WIN32
+        return VirtualLock(memory, bytes) != 0;
+#else
+        return ::mlock(memory, bytes) == 0;
+#endif
+    }
+
+    void unlockPages(void *memory, const size_t bytes) {
+#ifdef _WIN32
+        VirtualUnlock(memory, bytes);
+#else
+        ::munlock(memory, bytes);
+#endif
+    }
+}
+
+/**
+ * @brief Constructor.
+ * @param pool Owning pool.
+ */
+RC6SecurePool::Deleter::Deleter(RC6SecurePool *pool) : pool_(pool) {
+}
+
+/**
+ * @brief Destroy an object and return its slot.
+ *
+ * The RC6 destructor wipes the round keys before the slot is reused.
+ *
+ * @param cipher The object.
+ */
+void RC6SecurePool::Deleter::operator()(RC6 *cipher) const {
+    if (cipher == nullptr) {
+        return;
+    }
+    cipher->~RC6();
+    pool_->release(cipher);
+}
+
+/**
+ * @brief Constructor.
+ *
+ * No memory is allocated until the first object is created. The slab size
+ * is rounded up to whole pages.
+ *
+ * @param slab_objects Number of slots allocated and locked at once (default: 256).
+ * @throws std::invalid_argument if slab_objects is zero.
+ */
+RC6SecurePool::RC6SecurePool(const size_t slab_objects)
+    : slot_bytes_((sizeof(RC6) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE), slab_bytes_(0),
+      free_list_(nullptr), live_(0) {
+    if (slab_objects == 0) {
+        throw std::invalid_argument("Slab size cannot be zero");
+    }
+
+    const size_t page = pageSize();
+    slab_bytes_ = (slab_objects * slot_bytes_ + page - 1) / page * page;
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Wipes, unlocks and frees all slabs. Free slots hold only free-list
+ * links, but the whole slab is cleared anyway before the pages are
+ * returned.
+ */
+RC6SecurePool::~RC6SecurePool() {
+    assert(live_ == 0 && "RC6SecurePool destroyed with live handles");
+
+    for (const auto &slab: slabs_) {
+        rc6_util::secureZero(slab.memory, slab.bytes);
+        if (slab.locked) {
+            unlockPages(slab.memory, slab.bytes);
+        }
+        freePages(slab.memory, slab.bytes);
+    }
+}
+
+/**
+ * @brief Take a free slot, adding a slab if none is left.
+ *
+ * A new slab is locked with a single system call and its slots are
+ * threaded onto the free list.
+ *
+ * @return Pointer to the slot.
+ * @throws std::bad_alloc if the pages cannot be allocated.
+ */
+void *RC6SecurePool::acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (free_list_ == nullptr) {
+        slabs_.reserve(slabs_.size() + 1);
+        void *memory = allocatePages(slab_bytes_);
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        slabs_.push_back(Slab{memory, slab_bytes_, lockPages(memory, slab_bytes_)});
+
+        auto *bytes = static_cast<uint8_t *>(memory);
+        for (size_t offset = (slab_bytes_ / slot_bytes_) * slot_bytes_; offset > 0;) {
+            offset -= slot_bytes_;
+            *reinterpret_cast<void **>(bytes + offset) = free_list_;
+            free_list_ = bytes + offset;
+        }
+    }
+
+    void *slot = free_list_;
+    free_list_ = *static_cast<void **>(slot);
+    ++live_;
+    return slot;
+}
+
+/**
+ * @brief Return a slot to the free list.
+ * @param slot Pointer to the slot.
+ */
+void RC6SecurePool::release(void *slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    *static_cast<void **>(slot) = free_list_;
+    free_list_ = slot;
+    --live_;
+}
+
+/**
+ * @brief Create an uninitialized object.
+ * @param rounds The number of rounds to use (1-125, default: 20).
+ * @return Handle to the object.
+ * @throws std::invalid_argument if rounds is greater than 125.
+ * @throws std::bad_alloc if the pages cannot be allocated.
+ */
+RC6SecurePool::Handle RC6SecurePool::create(const uint8_t rounds) {
+    void *slot = acquire();
+    try {
+        return Handle(new(slot) RC6(rounds), Deleter(this));
+    } catch (...) {
+        release(slot);
+        throw;
+    }
+}
+
+/**
+ * @brief Create an object and initialize it with a key.
+ * @param key Pointer to the key data.
+ * @param keylength_bits Length of the key in bits.
+ * @param rounds The number of rounds to use (1-125, default: 20).
+ * @return Handle to the keyed object.
+ * @throws std::invalid_argument if the key or rounds are invalid, as for RC6::init().
+ * @throws std::bad_alloc if the pages cannot be allocated.
+ */
+RC6SecurePool::Handle RC6SecurePool::create(const void *key, const uint16_t keylength_bits, const uint8_t rounds) {
+    Handle cipher = create(rounds);
+    cipher->init(key, keylength_bits);
+    return cipher;
+}
+
+/**
+ * @brief Get the number of objects currently handed out.
+ * @return Live object count.
+ */
+size_t RC6SecurePool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return live_;
+}
+
+/**
+ * @brief Get the number of slots allocated so far.
+ * @return Slot count.
+ */
+size_t RC6SecurePool::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slabs_.size() * (slab_bytes_ / slot_bytes_);
+}
+
+/**
+ * @brief Check whether all allocated slabs are locked in memory.
+ * @return True if every slab is locked (or none is allocated yet).
+ */
+bool RC6SecurePool::isLocked() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &slab: slabs_) {
+        if (!slab.locked) {
+            return false;
+        }
+    }
+    return true;
+}
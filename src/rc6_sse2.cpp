@@ -0,0 +1,257 @@
+/**
+ * @file rc6_sse2.cpp
+ * @brief SSE2 implementation of the RC6 bulk kernels.
+ *
+ * SSE2 has neither a 32-bit low multiply nor per-lane variable shifts, so
+ * both are built from the 32x32->64-bit _mm_mul_epu32. A variable rotate
+ * multiplies by 2^n (obtained by building the float 2^n and converting it
+ * back to an integer) and folds the high half of the product into the low
+ * half.
+ */
+#include "rc6_kernels.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RC6_KERNEL_SSE2 1
+#endif
+
+#ifdef RC6_KERNEL_SSE2
+
+#include <emmintrin.h>
+
+namespace {
+    constexpr size_t LANES = 4;
+
+    inline __m128i mullo32(const __m128i a, const __m128i b) {
+        const __m128i even = _mm_mul_epu32(a, b);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    inline __m128i rotl5(const __m128i x) {
+        return _mm_or_si128(_mm_slli_epi32(x, 5), _mm_srli_epi32(x, 27));
+    }
+
+    // Rotate each lane of x left by the low five bits of the matching lane of n
+    inline __m128i rotlv(const __m128i x, const __m128i n) {
+        const __m128i count = _mm_and_si128(n, _mm_set1_epi32(0x1f));
+        // 2^count as an integer: exponent field of a float, then truncate
+        const __m128i pow = _mm_cvttps_epi32(_mm_castsi128_ps(
+            _mm_add_epi32(_mm_slli_epi32(count, 23), _mm_set1_epi32(0x3f800000))));
+
+        const __m128i even = _mm_mul_epu32(x, pow);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(x, 32), _mm_srli_epi64(pow, 32));
+        const __m128i even_rot = _mm_or_si128(even, _mm_srli_epi64(even, 32));
+        const __m128i odd_rot = _mm_or_si128(odd, _mm_srli_epi64(odd, 32));
+        return _mm_or_si128(_mm_and_si128(even_rot, _mm_set_epi32(0, -1, 0, -1)),
+                            _mm_slli_epi64(odd_rot, 32));
+    }
+
+    inline __m128i rotrv(const __m128i x, const __m128i n) {
+        return rotlv(x, _mm_sub_epi32(_mm_setzero_si128(), n));
+    }
+
+    // f(x) = (x * (2x + 1)) <<< 5
+    inline __m128i mix(const __m128i x) {
+        return rotl5(mullo32(x, _mm_add_epi32(_mm_add_epi32(x, x), _mm_set1_epi32(1))));
+    }
+
+    // 4x4 transpose between block order and A/B/C/D word vectors
+    inline void transpose(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+        const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+        const __m128i t1 = _mm_unpackhi_epi32(r0, r1);
+        const __m128i t2 = _mm_unpacklo_epi32(r2, r3);
+        const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+        r0 = _mm_unpacklo_epi64(t0, t2);
+        r1 = _mm_unpackhi_epi64(t0, t2);
+        r2 = _mm_unpacklo_epi64(t1, t3);
+        r3 = _mm_unpackhi_epi64(t1, t3);
+    }
+
+    inline void load(const uint8_t *in, __m128i &a, __m128i &b, __m128i &c, __m128i &d) {
+        a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+        b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16));
+        c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 32));
+        d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 48));
+        transpose(a, b, c, d);
+    }
+
+    inline void store(uint8_t *out, __m128i a, __m128i b, __m128i c, __m128i d) {
+        transpose(a, b, c, d);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), b);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 32), c);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 48), d);
+    }
+
+    // Round key j of every lane: one schedule broadcast to all lanes
+    struct SharedKeys {
+        const uint32_t *rk;
+
+        __m128i operator[](const size_t j) const {
+            return _mm_set1_epi32(static_cast<int>(rk[j]));
+        }
+    };
+
+    // Round key j of every lane: one schedule per lane, stored word-major in aligned rows
+    struct LaneKeys {
+        const uint32_t *lk;
+
+        __m128i operator[](const size_t j) const {
+            return _mm_load_si128(reinterpret_cast<const __m128i *>(lk + LANES * j));
+        }
+    };
+
+    // Encrypt N vectors of LANES blocks each, interleaved to hide multiply latency
+    template<size_t N, typename Keys>
+    inline void encryptGroup(const Keys &rk, const uint8_t rounds, const uint8_t *in, uint8_t *out) {
+        __m128i a[N], b[N], c[N], d[N];
+        for (size_t g = 0; g < N; ++g) {
+            load(in + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+            b[g] = _mm_add_epi32(b[g], rk[0]);
+            d[g] = _mm_add_epi32(d[g], rk[1]);
+        }
+
+        for (size_t i = 1; i <= rounds; ++i) {
+            const __m128i ka = rk[2 * i];
+            const __m128i kc = rk[2 * i + 1];
+            for (size_t g = 0; g < N; ++g) {
+                const __m128i t = mix(b[g]);
+                const __m128i u = mix(d[g]);
+                const __m128i na = _mm_add_epi32(rotlv(_mm_xor_si128(a[g], t), u), ka);
+                const __m128i nc = _mm_add_epi32(rotlv(_mm_xor_si128(c[g], u), t), kc);
+                a[g] = b[g];
+                b[g] = nc;
+                c[g] = d[g];
+                d[g] = na;
+            }
+        }
+
+        for (size_t g = 0; g < N; ++g) {
+            a[g] = _mm_add_epi32(a[g], rk[2 * rounds + 2]);
+            c[g] = _mm_add_epi32(c[g], rk[2 * rounds + 3]);
+            store(out + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+        }
+    }
+
+    // Decrypt N vectors of LANES blocks each, interleaved to hide multiply latency
+    template<size_t N, typename Keys>
+    inline void decryptGroup(const Keys &rk, const uint8_t rounds, const uint8_t *in, uint8_t *out) {
+        __m128i a[N], b[N], c[N], d[N];
+        for (size_t g = 0; g < N; ++g) {
+            load(in + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+            c[g] = _mm_sub_epi32(c[g], rk[2 * rounds + 3]);
+            a[g] = _mm_sub_epi32(a[g], rk[2 * rounds + 2]);
+        }
+
+        for (size_t i = rounds; i > 0; --i) {
+            const __m128i ka = rk[2 * i];
+            const __m128i kc = rk[2 * i + 1];
+            for (size_t g = 0; g < N; ++g) {
+                const __m128i pa = d[g];
+                const __m128i pc = b[g];
+                b[g] = a[g];
+                d[g] = c[g];
+                const __m128i u = mix(d[g]);
+                const __m128i t = mix(b[g]);
+                c[g] = _mm_xor_si128(rotrv(_mm_sub_epi32(pc, kc), t), u);
+                a[g] = _mm_xor_si128(rotrv(_mm_sub_epi32(pa, ka), u), t);
+            }
+        }
+
+        for (size_t g = 0; g < N; ++g) {
+            d[g] = _mm_sub_epi32(d[g], rk[1]);
+            b[g] = _mm_sub_epi32(b[g], rk[0]);
+            store(out + 16 * LANES * g, a[g], b[g], c[g], d[g]);
+        }
+    }
+
+    template<typename Keys>
+    size_t encryptBlocksWith(const Keys &keys, const uint8_t rounds, const void *in, void *out, const size_t nblocks) {
+        const auto *src = static_cast<const uint8_t *>(in);
+        auto *dst = static_cast<uint8_t *>(out);
+        size_t n = 0;
+        for (; n + 2 * LANES <= nblocks; n += 2 * LANES) {
+            encryptGroup<2>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        for (; n + LANES <= nblocks; n += LANES) {
+            encryptGroup<1>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        return n;
+    }
+
+    size_t encryptBlocksSSE2(const uint32_t *round_keys, const uint8_t rounds,
+                             const void *in, void *out, const size_t nblocks) {
+        return encryptBlocksWith(SharedKeys{round_keys}, rounds, in, out, nblocks);
+    }
+
+    size_t encryptLanesSSE2(const uint32_t *lane_keys, const uint8_t rounds,
+                            const void *in, void *out, const size_t nblocks) {
+        return encryptBlocksWith(LaneKeys{lane_keys}, rounds, in, out, nblocks);
+    }
+
+    template<typename Keys>
+    size_t decryptBlocksWith(const Keys &keys, const uint8_t rounds, const void *in, void *out, const size_t nblocks) {
+        const auto *src = static_cast<const uint8_t *>(in);
+        auto *dst = static_cast<uint8_t *>(out);
+        size_t n = 0;
+        for (; n + 2 * LANES <= nblocks; n += 2 * LANES) {
+            decryptGroup<2>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        for (; n + LANES <= nblocks; n += LANES) {
+            decryptGroup<1>(keys, rounds, src + 16 * n, dst + 16 * n);
+        }
+        return n;
+    }
+
+    size_t decryptBlocksSSE2(const uint32_t *round_keys, const uint8_t rounds,
+                             const void *in, void *out, const size_t nblocks) {
+        return decryptBlocksWith(SharedKeys{round_keys}, rounds, in, out, nblocks);
+    }
+
+    size_t decryptLanesSSE2(const uint32_t *lane_keys, const uint8_t rounds,
+                            const void *in, void *out, const size_t nblocks) {
+        return decryptBlocksWith(LaneKeys{lane_keys}, rounds, in, out, nblocks);
+    }
+
+    void mixKeysSSE2(uint32_t *s, uint32_t *l, const uint16_t key_size, const uint16_t c) {
+        __m128i a = _mm_setzero_si128();
+        __m128i b = _mm_setzero_si128();
+        uint16_t i = 0, j = 0;
+        const uint32_t steps = 3u * (c > key_size ? c : key_size);
+
+        for (uint32_t p = 0; p < steps; ++p) {
+            const __m128i x = _mm_add_epi32(_mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + LANES * i)), a), b);
+            a = _mm_or_si128(_mm_slli_epi32(x, 3), _mm_srli_epi32(x, 29));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(s + LANES * i), a);
+
+            const __m128i ab = _mm_add_epi32(a, b);
+            b = rotlv(_mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(l + LANES * j)), ab), ab);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(l + LANES * j), b);
+
+            if (++i == key_size) {
+                i = 0;
+            }
+            if (++j == c) {
+                j = 0;
+            }
+        }
+    }
+
+    const rc6_kernels::Backend SSE2_BACKEND = {
+        "sse2", rc6_kernels::BACKEND_SSE2, LANES, encryptBlocksSSE2, decryptBlocksSSE2, mixKeysSSE2,
+        encryptLanesSSE2, decryptLanesSSE2, nullptr
+    };
+}
+
+const rc6_kernels::Backend *rc6_kernels::sse2Backend() {
+    return &SSE2_BACKEND;
+}
+
+#else
+
+const rc6_kernels::Backend *rc6_kernels::sse2Backend() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @file rc6_stats.cpp
+ * @brief Implementation file for the RC6 usage counters.
+ *
+ * This file provides the implementation of the counters as defined in the
+ * rc6_stats.hpp header file, and the per-thread registration used by the
+ * hooks in rc6_trace.hpp.
+ */
+#include <mutex>
+#include <vector>
+
+#include "rc6_stats.hpp"
+#include "rc6_trace.hpp"
+
+constexpr size_t RC6Stats::SIZE_BUCKETS;
+
+static_assert(RC6Stats::SIZE_BUCKETS == rc6_trace::SIZE_BUCKETS, "histogram sizes must match");
+
+namespace {
+    typedef uint64_t Totals[rc6_trace::COUNTER_COUNT];
+
+    const char *const BACKEND_NAMES[rc6_kernels::BACKEND_COUNT + 1] = {
+        "sse2", "avx2", "avx512", "neon", "scalar", "single"
+    };
+
+#ifdef RC6_ENABLE_STATS
+    /**
+     * @brief Counters of all live threads, plus the totals of exited ones.
+     *
+     * Allocated once and never freed, so threads that exit during static
+     * destruction can still retire their counters.
+     */
+    struct Registry {
+        std::mutex mutex; //!< Protects the members below
+        std::vector<rc6_trace::ThreadCounters *> threads; //!< Counters of live threads
+        Totals retired; //!< Sums of exited threads
+        Totals baseline; //!< Totals at the last reset()
+
+        Registry() : retired(), baseline() {
+        }
+
+        void sum(Totals &totals) {
+            for (size_t c = 0; c < rc6_trace::COUNTER_COUNT; ++c) {
+                totals[c] = retired[c];
+            }
+            for (const auto *counters: threads) {
+                for (size_t c = 0; c < rc6_trace::COUNTER_COUNT; ++c) {
+                    totals[c] += counters->values[c].load(std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+    Registry &registry() {
+        static Registry *instance = new Registry;
+        return *instance;
+    }
+
+    /**
+     * @brief Retires the owning thread's counters when the thread exits.
+     */
+    struct ThreadGuard {
+        rc6_trace::ThreadCounters *counters;
+
+        ~ThreadGuard() {
+            Registry &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (size_t c = 0; c < rc6_trace::COUNTER_COUNT; ++c) {
+                r.retired[c] += counters->values[c].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < r.threads.size(); ++i) {
+                if (r.threads[i] == counters) {
+                    r.threads[i] = r.threads.back();
+                    r.threads.pop_back();
+                    break;
+                }
+            }
+            rc6_trace::thread_counters = nullptr;
+            delete counters;
+        }
+    };
+#endif
+}
+
+#ifdef RC6_ENABLE_STATS
+thread_local rc6_trace::ThreadCounters *rc6_trace::thread_counters = nullptr;
+
+/**
+ * @brief Allocate and register the calling thread's counters.
+ * @return The counters, also stored in thread_counters.
+ */
+rc6_trace::ThreadCounters *rc6_trace::registerThread() {
+    auto *counters = new ThreadCounters;
+    for (auto &value: counters->values) {
+        value.store(0, std::memory_order_relaxed);
+    }
+
+    Registry &r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.threads.push_back(counters);
+    }
+
+    static thread_local ThreadGuard guard;
+    guard.counters = counters;
+    thread_counters = counters;
+    return counters;
+}
+#endif
+
+/**
+ * @brief Check whether the counters are compiled in.
+ * @return True if the library was built with RC6_ENABLE_STATS.
+ */
+bool RC6Stats::enabled() {
+#ifdef RC6_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Sum the counters of all threads, including exited ones.
+ * @return Counts since the start of the process or the last reset().
+ */
+RC6Stats RC6Stats::snapshot() {
+    Totals totals = {};
+#ifdef RC6_ENABLE_STATS
+    Registry &r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.sum(totals);
+        for (size_t c = 0; c < rc6_trace::COUNTER_COUNT; ++c) {
+            totals[c] -= r.baseline[c];
+        }
+    }
+#endif
+
+    RC6Stats stats = {};
+    stats.keys_expanded = totals[rc6_trace::KEYS_EXPANDED];
+    stats.encrypt_calls = totals[rc6_trace::ENCRYPT_CALLS];
+    stats.encrypt_blocks = totals[rc6_trace::ENCRYPT_BLOCKS];
+    stats.decrypt_calls = totals[rc6_trace::DECRYPT_CALLS];
+    stats.decrypt_blocks = totals[rc6_trace::DECRYPT_BLOCKS];
+    for (size_t b = 0; b < SIZE_BUCKETS; ++b) {
+        stats.calls_by_blocks[b] = totals[rc6_trace::CALLS_BY_BLOCKS + b];
+    }
+    for (size_t k = 0; k <= rc6_kernels::BACKEND_COUNT; ++k) {
+        if (totals[rc6_trace::BACKEND_BLOCKS + k] != 0) {
+            stats.blocks_by_backend[BACKEND_NAMES[k]] = totals[rc6_trace::BACKEND_BLOCKS + k];
+        }
+    }
+    return stats;
+}
+
+/**
+ * @brief Start counting from zero.
+ */
+void RC6Stats::reset() {
+#ifdef RC6_ENABLE_STATS
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.sum(r.baseline);
+#endif
+}
@@ -0,0 +1,445 @@
+/**
+ * @file rc6_stream.cpp
+ * @brief Implementation file for the incremental RC6 stream context.
+ *
+ * This file provides the implementation of the stream context as defined
+ * in the rc6_stream.hpp header file.
+ */
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "rc6_stream.hpp"
+#include "rc6_util.hpp"
+
+constexpr size_t RC6Stream::BLOCK_SIZE;
+constexpr size_t RC6Stream::BATCH_BLOCKS;
+
+/**
+ * @brief Constructor.
+ *
+ * Sets up the chaining state for the selected mode.
+ *
+ * @param cipher Initialized RC6 object.
+ * @param mode Mode of operation.
+ * @param direction Whether to encrypt or decrypt.
+ * @param iv Pointer to the 16-byte IV (initial counter block for CTR).
+ * @param padding Whether CBC mode applies PKCS#7 padding (ignored otherwise).
+ * @throws std::runtime_error if the cipher is not initialized.
+ * @throws std::invalid_argument if iv is null.
+ */
+RC6Stream::RC6Stream(const RC6 &cipher, const Mode mode, const Direction direction,
+                     const void *iv, const bool padding)
+    : cipher_(cipher), mode_(mode), direction_(direction), padding_(padding && mode == Mode::CBC),
+      finished_(false), cbc_(cipher), ctr_(cipher, iv), iv_(), buffer_(), buffered_(0) {
+    std::memcpy(iv_, iv, BLOCK_SIZE);
+
+    // Feedback modes start with the keystream block exhausted
+    if (mode_ == Mode::CFB || mode_ == Mode::OFB) {
+        buffered_ = BLOCK_SIZE;
+    }
+}
+
+/**
+ * @brief Run full blocks through CBC.
+ *
+ * Encryption is inherently serial. Decryption runs batches of blocks
+ * through the bulk kernels and then applies the chaining XOR.
+ *
+ * @param in Pointer to nblocks * 16 bytes of input.
+ * @param out Pointer to nblocks * 16 bytes of output (no overlap with in).
+ * @param nblocks Number of blocks.
+ */
+void RC6Stream::cbcBlocks(const uint8_t *in, uint8_t *out, const size_t nblocks) {
+    if (direction_ == Direction::Encrypt) {
+        cbc_.encrypt(iv_, in, out, nblocks);
+    } else {
+        cbc_.decrypt(iv_, in, out, nblocks);
+    }
+}
+
+/**
+ * @brief Process data in CBC mode.
+ *
+ * Completes a buffered partial block first, then passes all remaining full
+ * blocks directly to cbcBlocks() and buffers the tail. When decrypting with
+ * padding the last full block is held back, since it may be the final one.
+ *
+ * @return Number of bytes written to out.
+ */
+size_t RC6Stream::updateCBC(const uint8_t *in, size_t len, uint8_t *out) {
+    const bool hold_back = direction_ == Direction::Decrypt && padding_;
+    size_t produced = 0;
+
+    if (buffered_ > 0) {
+        const size_t take = std::min(BLOCK_SIZE - buffered_, len);
+        std::memcpy(buffer_ + buffered_, in, take);
+        buffered_ += take;
+        in += take;
+        len -= take;
+
+        if (buffered_ < BLOCK_SIZE || (hold_back && len == 0)) {
+            return 0;
+        }
+
+        cbcBlocks(buffer_, out, 1);
+        produced = BLOCK_SIZE;
+        buffered_ = 0;
+    }
+
+    size_t nblocks = len / BLOCK_SIZE;
+    size_t rest = len % BLOCK_SIZE;
+    if (hold_back && rest == 0 && nblocks > 0) {
+        --nblocks;
+        rest = BLOCK_SIZE;
+    }
+
+    cbcBlocks(in, out + produced, nblocks);
+    produced += BLOCK_SIZE * nblocks;
+
+    std::memcpy(buffer_, in + BLOCK_SIZE * nblocks, rest);
+    buffered_ = rest;
+    return produced;
+}
+
+/**
+ * @brief Process data in CFB mode.
+ *
+ * Uses up any keystream left from a previous partial block. When
+ * decrypting, the keystream for a run of full blocks depends only on the
+ * ciphertext, so it is generated with one bulk call per batch.
+ *
+ * @return Number of bytes written to out.
+ */
+size_t RC6Stream::updateCFB(const uint8_t *in, const size_t len, uint8_t *out) {
+    const bool encrypting = direction_ == Direction::Encrypt;
+    size_t done = 0;
+
+    while (done < len) {
+        if (buffered_ == BLOCK_SIZE && !encrypting && len - done >= BLOCK_SIZE) {
+            // Keystream block n is E(C[n-1]); the first one comes from the IV
+            uint8_t keystream[BATCH_BLOCKS * BLOCK_SIZE];
+            const rc6_util::ScopedWipe wipe(keystream, sizeof(keystream));
+            const size_t batch = std::min((len - done) / BLOCK_SIZE, BATCH_BLOCKS);
+            std::memcpy(keystream, iv_, BLOCK_SIZE);
+            cipher_.encrypt(keystream);
+            cipher_.encryptBlocks(in + done, keystream + BLOCK_SIZE, batch - 1);
+
+            std::memcpy(iv_, in + done + BLOCK_SIZE * (batch - 1), BLOCK_SIZE);
+            rc6_util::xorBytes(out + done, in + done, keystream, BLOCK_SIZE * batch);
+            done += BLOCK_SIZE * batch;
+            continue;
+        }
+
+        if (buffered_ == BLOCK_SIZE) {
+            std::memcpy(buffer_, iv_, BLOCK_SIZE);
+            cipher_.encrypt(buffer_);
+            buffered_ = 0;
+        }
+
+        // Partial block: the feedback register collects the ciphertext bytes
+        const size_t chunk = std::min(BLOCK_SIZE - buffered_, len - done);
+        for (size_t i = 0; i < chunk; ++i) {
+            const uint8_t byte = in[done + i];
+            out[done + i] = byte ^ buffer_[buffered_ + i];
+            iv_[buffered_ + i] = encrypting ? out[done + i] : byte;
+        }
+        buffered_ += chunk;
+        done += chunk;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Process data in OFB mode.
+ *
+ * The keystream is the iterated encryption of the IV and is independent of
+ * the data, so encryption and decryption are the same operation.
+ *
+ * @return Number of bytes written to out.
+ */
+size_t RC6Stream::updateOFB(const uint8_t *in, const size_t len, uint8_t *out) {
+    size_t done = 0;
+
+    while (done < len) {
+        if (buffered_ == BLOCK_SIZE) {
+            cipher_.encrypt(iv_);
+            std::memcpy(buffer_, iv_, BLOCK_SIZE);
+            buffered_ = 0;
+        }
+
+        const size_t chunk = std::min(BLOCK_SIZE - buffered_, len - done);
+        rc6_util::xorBytes(out + done, in + done, buffer_ + buffered_, chunk);
+        buffered_ += chunk;
+        done += chunk;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Process a chunk of input.
+ *
+ * In stream modes out may equal in and exactly len bytes are written. In
+ * CBC mode out must not overlap in, must have room for len + 15 bytes,
+ * and only complete blocks are written.
+ *
+ * @param in Pointer to the input data.
+ * @param len Number of input bytes.
+ * @param out Pointer to the output buffer.
+ * @return Number of bytes written to out.
+ * @throws std::runtime_error if final() has already been called.
+ * @throws std::invalid_argument if in or out is null and len is non-zero.
+ */
+size_t RC6Stream::update(const void *in, const size_t len, void *out) {
+    if (finished_) {
+        throw std::runtime_error("Stream already finalized");
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    if (in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Data cannot be null");
+    }
+
+    return updateChunk(static_cast<const uint8_t *>(in), len, static_cast<uint8_t *>(out));
+}
+
+/**
+ * @brief Process input gathered from several segments into several segments.
+ *
+ * The output segments are filled in order. Each call on the underlying
+ * modes covers as much of the current input segment as fits contiguously
+ * in the current output segment, so long runs reach the bulk kernels in one
+ * piece. In CBC mode, an output segment with less than a block of room is
+ * filled through a small bounce buffer instead.
+ *
+ * @param in Array of in_count input segments.
+ * @param in_count Number of input segments.
+ * @param out Array of out_count output segments.
+ * @param out_count Number of output segments.
+ * @return Number of bytes written across the output segments.
+ * @throws std::runtime_error if final() has already been called.
+ * @throws std::invalid_argument if an array or a non-empty segment is null,
+ *         or if the output segments are too small.
+ */
+size_t RC6Stream::update(const ConstSegment *in, const size_t in_count, const Segment *out,
+                         const size_t out_count) {
+    if (finished_) {
+        throw std::runtime_error("Stream already finalized");
+    }
+
+    if ((in == nullptr && in_count != 0) || (out == nullptr && out_count != 0)) {
+        throw std::invalid_argument("Segments cannot be null");
+    }
+
+    // Check everything up front so that a failed call leaves the state untouched
+    size_t in_total = 0;
+    for (size_t i = 0; i < in_count; ++i) {
+        if (in[i].data == nullptr && in[i].len != 0) {
+            throw std::invalid_argument("Data cannot be null");
+        }
+        in_total += in[i].len;
+    }
+    size_t out_total = 0;
+    for (size_t i = 0; i < out_count; ++i) {
+        if (out[i].data == nullptr && out[i].len != 0) {
+            throw std::invalid_argument("Data cannot be null");
+        }
+        out_total += out[i].len;
+    }
+
+    const size_t slack = mode_ == Mode::CBC ? BLOCK_SIZE - 1 : 0;
+    if (in_total != 0 && out_total < in_total + slack) {
+        throw std::invalid_argument("Output segments too small");
+    }
+
+    size_t produced = 0;
+    size_t segment = 0;
+    size_t used = 0;
+
+    for (size_t i = 0; i < in_count; ++i) {
+        const auto *src = static_cast<const uint8_t *>(in[i].data);
+        size_t remaining = in[i].len;
+
+        while (remaining > 0) {
+            while (out[segment].len == used) {
+                ++segment;
+                used = 0;
+            }
+            auto *dst = static_cast<uint8_t *>(out[segment].data) + used;
+            const size_t room = out[segment].len - used;
+
+            if (room > slack) {
+                // CBC writes at most 15 bytes more than it reads
+                const size_t take = std::min(remaining, room - slack);
+                const size_t written = updateChunk(src, take, dst);
+                used += written;
+                produced += written;
+                src += take;
+                remaining -= take;
+                continue;
+            }
+
+            uint8_t bounce[2 * BLOCK_SIZE];
+            const size_t take = std::min(remaining, BLOCK_SIZE);
+            size_t written = updateChunk(src, take, bounce);
+            src += take;
+            remaining -= take;
+            produced += written;
+
+            for (const uint8_t *from = bounce; written > 0;) {
+                while (out[segment].len == used) {
+                    ++segment;
+                    used = 0;
+                }
+                const size_t chunk = std::min(written, out[segment].len - used);
+                std::memcpy(static_cast<uint8_t *>(out[segment].data) + used, from, chunk);
+                used += chunk;
+                from += chunk;
+                written -= chunk;
+            }
+        }
+    }
+
+    return produced;
+}
+
+/**
+ * @brief Process segments in place (CTR, CFB and OFB only).
+ *
+ * Stream modes keep their keystream position across calls, so each
+ * segment is simply processed in turn.
+ *
+ * @param segments Array of count segments, each overwritten with its output.
+ * @param count Number of segments.
+ * @throws std::runtime_error if final() has already been called or the mode is CBC.
+ * @throws std::invalid_argument if segments or a non-empty segment is null.
+ */
+void RC6Stream::update(const Segment *segments, const size_t count) {
+    if (finished_) {
+        throw std::runtime_error("Stream already finalized");
+    }
+
+    if (mode_ == Mode::CBC) {
+        throw std::runtime_error("CBC mode cannot be processed in place");
+    }
+
+    if (segments == nullptr && count != 0) {
+        throw std::invalid_argument("Segments cannot be null");
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (segments[i].data == nullptr && segments[i].len != 0) {
+            throw std::invalid_argument("Data cannot be null");
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        auto *data = static_cast<uint8_t *>(segments[i].data);
+        updateChunk(data, segments[i].len, data);
+    }
+}
+
+/**
+ * @brief Process data, with no state or argument checks.
+ * @return Number of bytes written to out.
+ */
+size_t RC6Stream::updateChunk(const uint8_t *in, const size_t len, uint8_t *out) {
+    if (len == 0) {
+        return 0;
+    }
+
+    switch (mode_) {
+        case Mode::CBC:
+            return updateCBC(in, len, out);
+        case Mode::CTR:
+            ctr_.process(in, out, len);
+            return len;
+        case Mode::CFB:
+            return updateCFB(in, len, out);
+        case Mode::OFB:
+            return updateOFB(in, len, out);
+    }
+    return 0;
+}
+
+/**
+ * @brief Finish the stream.
+ *
+ * In CBC mode this adds or checks and removes the padding. The output
+ * buffer must have room for 16 bytes.
+ *
+ * @param out Pointer to the output buffer.
+ * @return Number of bytes written to out.
+ * @throws std::runtime_error if final() has already been called.
+ * @throws std::runtime_error if CBC input is incomplete or the padding is invalid.
+ */
+size_t RC6Stream::final(void *out) {
+    if (finished_) {
+        throw std::runtime_error("Stream already finalized");
+    }
+    finished_ = true;
+
+    if (mode_ != Mode::CBC) {
+        return 0;
+    }
+
+    auto *dst = static_cast<uint8_t *>(out);
+
+    if (direction_ == Direction::Encrypt) {
+        if (!padding_) {
+            if (buffered_ != 0) {
+                throw std::runtime_error("Input is not a multiple of the block size");
+            }
+            return 0;
+        }
+
+        if (dst == nullptr) {
+            throw std::invalid_argument("Output cannot be null");
+        }
+
+        const auto pad = static_cast<uint8_t>(BLOCK_SIZE - buffered_);
+        std::memset(buffer_ + buffered_, pad, pad);
+        cbcBlocks(buffer_, dst, 1);
+        return BLOCK_SIZE;
+    }
+
+    if (!padding_) {
+        if (buffered_ != 0) {
+            throw std::runtime_error("Input is not a multiple of the block size");
+        }
+        return 0;
+    }
+
+    if (buffered_ != BLOCK_SIZE) {
+        throw std::runtime_error("Input is not a multiple of the block size");
+    }
+
+    if (dst == nullptr) {
+        throw std::invalid_argument("Output cannot be null");
+    }
+
+    uint8_t block[BLOCK_SIZE];
+    cbcBlocks(buffer_, block, 1);
+
+    // Check the padding without branching on individual byte values
+    const uint8_t pad = block[BLOCK_SIZE - 1];
+    uint8_t bad = static_cast<uint8_t>(pad == 0 || pad > BLOCK_SIZE);
+    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+        const uint8_t in_pad = static_cast<uint8_t>(i >= BLOCK_SIZE - pad);
+        bad |= static_cast<uint8_t>(in_pad & (block[i] != pad));
+    }
+    if (bad != 0) {
+        rc6_util::secureZero(block, sizeof(block));
+        throw std::runtime_error("Invalid padding");
+    }
+
+    const size_t length = BLOCK_SIZE - pad;
+    std::memcpy(dst, block, length);
+    rc6_util::secureZero(block, sizeof(block));
+    return length;
+}
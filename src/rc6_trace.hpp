@@ -0,0 +1,166 @@
+/**
+ * @file rc6_trace.hpp
+ * @brief Internal instrumentation hooks: usage counters and USDT probes.
+ *
+ * The hooks are called from the key schedule and the bulk entry points.
+ * With RC6_ENABLE_STATS each thread adds to its own block of counters;
+ * only the owning thread writes them, so an update is a relaxed load and
+ * store with no locked instruction, and RC6Stats::snapshot() sums all
+ * blocks on demand. With RC6_ENABLE_TRACEPOINTS the hooks also fire
+ * static probes (provider "rc6") for perf, bpftrace or SystemTap. Without
+ * either definition every hook is an empty inline function.
+ */
+#ifndef RC6_TRACE_HPP_
+#define RC6_TRACE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rc6_kernels.hpp"
+
+#ifdef RC6_ENABLE_STATS
+#include <atomic>
+#endif
+
+#ifdef RC6_ENABLE_TRACEPOINTS
+#include <sys/sdt.h>
+#endif
+
+namespace rc6_trace {
+    const size_t SIZE_BUCKETS = 12; //!< Blocks-per-call histogram buckets, powers of two
+
+    /**
+     * @brief Index of each counter in a thread's block.
+     */
+    enum Counter : size_t {
+        KEYS_EXPANDED,
+        ENCRYPT_CALLS,
+        ENCRYPT_BLOCKS,
+        DECRYPT_CALLS,
+        DECRYPT_BLOCKS,
+        CALLS_BY_BLOCKS, //!< SIZE_BUCKETS counters
+        BACKEND_BLOCKS = CALLS_BY_BLOCKS + SIZE_BUCKETS, //!< One per backend, then single-block tails
+        COUNTER_COUNT = BACKEND_BLOCKS + rc6_kernels::BACKEND_COUNT + 1
+    };
+
+#ifdef RC6_ENABLE_STATS
+    /**
+     * @brief Counters of one thread.
+     */
+    struct ThreadCounters {
+        std::atomic<uint64_t> values[COUNTER_COUNT];
+    };
+
+    extern thread_local ThreadCounters *thread_counters;
+
+    /**
+     * @brief Allocate and register the calling thread's counters.
+     * @return The counters, also stored in thread_counters.
+     */
+    ThreadCounters *registerThread();
+
+    inline void add(const Counter counter, const uint64_t n) {
+        ThreadCounters *counters = thread_counters;
+        if (counters == nullptr) {
+            counters = registerThread();
+        }
+        // Only this thread writes; readers just need an untorn value
+        std::atomic<uint64_t> &value = counters->values[counter];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    inline void countCall(const Counter calls, const size_t nblocks) {
+        size_t bucket = 0;
+        while (bucket + 1 < SIZE_BUCKETS && (nblocks >> (bucket + 1)) != 0) {
+            ++bucket;
+        }
+        add(calls, 1);
+        add(static_cast<Counter>(calls + 1), nblocks);
+        add(static_cast<Counter>(CALLS_BY_BLOCKS + bucket), 1);
+    }
+#endif
+
+    /**
+     * @brief Key schedule about to be computed for count keys.
+     */
+    inline void initEntry(const size_t count, const uint16_t keylength_bits, const uint8_t rounds) {
+#ifdef RC6_ENABLE_STATS
+        add(KEYS_EXPANDED, count);
+#endif
+#ifdef RC6_ENABLE_TRACEPOINTS
+        DTRACE_PROBE3(rc6, init__entry, count, keylength_bits, rounds);
+#endif
+        (void) count;
+        (void) keylength_bits;
+        (void) rounds;
+    }
+
+    /**
+     * @brief Key schedule computed for count keys.
+     */
+    inline void initReturn(const size_t count) {
+#ifdef RC6_ENABLE_TRACEPOINTS
+        DTRACE_PROBE1(rc6, init__return, count);
+#endif
+        (void) count;
+    }
+
+    /**
+     * @brief Bulk encryption of nblocks blocks starting.
+     */
+    inline void encryptEntry(const size_t nblocks) {
+#ifdef RC6_ENABLE_STATS
+        countCall(ENCRYPT_CALLS, nblocks);
+#endif
+#ifdef RC6_ENABLE_TRACEPOINTS
+        DTRACE_PROBE1(rc6, encrypt__entry, nblocks);
+#endif
+        (void) nblocks;
+    }
+
+    /**
+     * @brief Bulk encryption of nblocks blocks finished.
+     */
+    inline void encryptReturn(const size_t nblocks) {
+#ifdef RC6_ENABLE_TRACEPOINTS
+        DTRACE_PROBE1(rc6, encrypt__return, nblocks);
+#endif
+        (void) nblocks;
+    }
+
+    /**
+     * @brief Bulk decryption of nblocks blocks starting.
+     */
+    inline void decryptEntry(const size_t nblocks) {
+#ifdef RC6_ENABLE_STATS
+        countCall(DECRYPT_CALLS, nblocks);
+#endif
+#ifdef RC6_ENABLE_TRACEPOINTS
+        DTRACE_PROBE1(rc6, decrypt__entry, nblocks);
+#endif
+        (void) nblocks;
+    }
+
+    /**
+     * @brief Bulk decryption of nblocks blocks finished.
+     */
+    inline void decryptReturn(const size_t nblocks) {
+#ifdef RC6_ENABLE_TRACEPOINTS
+        DTRACE_PROBE1(rc6, decrypt__return, nblocks);
+#endif
+        (void) nblocks;
+    }
+
+    /**
+     * @brief Blocks processed by one backend, or one at a time for BACKEND_COUNT.
+     */
+    inline void backendBlocks(const rc6_kernels::BackendId backend, const size_t nblocks) {
+#ifdef RC6_ENABLE_STATS
+        add(static_cast<Counter>(BACKEND_BLOCKS + backend), nblocks);
+#endif
+        (void) backend;
+        (void) nblocks;
+    }
+}
+
+#endif /* RC6_TRACE_HPP_ */
@@ -0,0 +1,70 @@
+/**
+ * @file rc6_util.hpp
+ * @brief Internal helpers shared by the RC6 modes of operation.
+ */
+#ifndef RC6_UTIL_HPP_
+#define RC6_UTIL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "rc6_detail.hpp"
+
+namespace rc6_util {
+    /**
+     * @brief XOR two byte strings.
+     *
+     * Works on 64-bit words where possible; memcpy keeps the accesses valid
+     * for any alignment.
+     *
+     * @param out Pointer to the output (may equal a or b).
+     * @param a Pointer to the first input.
+     * @param b Pointer to the second input.
+     * @param len Number of bytes to combine.
+     */
+    inline void xorBytes(uint8_t *out, const uint8_t *a, const uint8_t *b, const size_t len) {
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            uint64_t x, y;
+            std::memcpy(&x, a + i, 8);
+            std::memcpy(&y, b + i, 8);
+            x ^= y;
+            std::memcpy(out + i, &x, 8);
+        }
+        for (; i < len; ++i) {
+            out[i] = a[i] ^ b[i];
+        }
+    }
+
+    /**
+     * @brief Zero memory holding key material.
+     * @see rc6_detail::secureZero()
+     */
+    using rc6_detail::secureZero;
+
+    /**
+     * @brief Wipes a scratch buffer when it goes out of scope.
+     *
+     * Covers the exception paths of functions that hold keystream or
+     * plaintext in a local buffer.
+     */
+    class ScopedWipe {
+        void *p_; //!< Buffer to wipe
+        size_t len_; //!< Its length in bytes
+
+    public:
+        ScopedWipe(void *p, const size_t len) : p_(p), len_(len) {
+        }
+
+        ~ScopedWipe() {
+            secureZero(p_, len_);
+        }
+
+        ScopedWipe(const ScopedWipe &) = delete;
+
+        ScopedWipe &operator=(const ScopedWipe &) = delete;
+    };
+}
+
+#endif /* RC6_UTIL_HPP_ */
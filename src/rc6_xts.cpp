@@ -0,0 +1,337 @@
+/**
+ * @file rc6_xts.cpp
+ * @brief Implementation file for RC6 in XTS mode for storage encryption.
+ *
+ * This file provides the implementation of XTS as defined in the
+ * rc6_xts.hpp header file.
+ */
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "rc6_util.hpp"
+#include "rc6_xts.hpp"
+
+constexpr size_t RC6XTS::BLOCK_SIZE;
+constexpr size_t RC6XTS::BATCH_BLOCKS;
+
+namespace {
+    /**
+     * @brief A tweak as two little-endian 64-bit halves.
+     */
+    struct Tweak {
+        uint64_t lo;
+        uint64_t hi;
+    };
+
+    Tweak loadTweak(const uint8_t *p) {
+        const uint64_t lo = rc6_detail::loadWord(p) | static_cast<uint64_t>(rc6_detail::loadWord(p + 4)) << 32;
+        const uint64_t hi = rc6_detail::loadWord(p + 8) | static_cast<uint64_t>(rc6_detail::loadWord(p + 12)) << 32;
+        return Tweak{lo, hi};
+    }
+
+    void storeTweak(uint8_t *p, const Tweak &t) {
+        rc6_detail::storeWord(p, static_cast<uint32_t>(t.lo));
+        rc6_detail::storeWord(p + 4, static_cast<uint32_t>(t.lo >> 32));
+        rc6_detail::storeWord(p + 8, static_cast<uint32_t>(t.hi));
+        rc6_detail::storeWord(p + 12, static_cast<uint32_t>(t.hi >> 32));
+    }
+
+    /**
+     * @brief Multiply by alpha in GF(2^128), little-endian convention.
+     *
+     * Two 64-bit shifts and a masked reduction, with no branch on the
+     * (secret) tweak.
+     */
+    Tweak doubleTweak(const Tweak &t) {
+        const uint64_t carry = t.hi >> 63;
+        return Tweak{(t.lo << 1) ^ (0x87 & (0 - carry)), (t.hi << 1) | (t.lo >> 63)};
+    }
+
+    /**
+     * @brief Run blocks through the cipher between two tweak whitenings.
+     *
+     * out = E(in ^ T) ^ T (or D for decryption), with the bulk kernels
+     * working in place on out.
+     */
+    void whitenedBlocks(const RC6 &cipher, const bool encrypting, const uint8_t *tweaks, const uint8_t *in,
+                        uint8_t *out, const size_t nblocks) {
+        rc6_util::xorBytes(out, in, tweaks, RC6XTS::BLOCK_SIZE * nblocks);
+        if (encrypting) {
+            cipher.encryptBlocksUnchecked(out, out, nblocks);
+        } else {
+            cipher.decryptBlocksUnchecked(out, out, nblocks);
+        }
+        rc6_util::xorBytes(out, out, tweaks, RC6XTS::BLOCK_SIZE * nblocks);
+    }
+
+    /**
+     * @brief XOR one block with a tweak, C = in ^ T.
+     */
+    void whiten(uint8_t *out, const uint8_t *in, const uint8_t *tweak) {
+        rc6_util::xorBytes(out, in, tweak, RC6XTS::BLOCK_SIZE);
+    }
+}
+
+/**
+ * @brief Constructor.
+ *
+ * Splits the key into the data and tweak halves and expands both with
+ * RC6::init(). Equal halves are rejected, as required by SP 800-38E.
+ *
+ * @param key Pointer to the key: the data key followed by the tweak key.
+ * @param keylength_bits Length of the whole key in bits (twice the RC6 key length).
+ * @param rounds The number of rounds to use (1-125, default: 20).
+ * @throws std::invalid_argument if key is null, keylength_bits is zero, odd
+ *         in bytes or greater than 4096, rounds is greater than 125, or the
+ *         two key halves are equal.
+ */
+RC6XTS::RC6XTS(const void *key, const uint16_t keylength_bits, const uint8_t rounds)
+    : data_cipher_(rounds), tweak_cipher_(rounds) {
+    if (key == nullptr) {
+        throw std::invalid_argument("Key cannot be null");
+    }
+
+    if (keylength_bits == 0 || keylength_bits % 16 != 0 || keylength_bits > 2 * RC6::MAX_KEY_BITS) {
+        throw std::invalid_argument("Invalid XTS key length");
+    }
+
+    const auto *bytes = static_cast<const uint8_t *>(key);
+    const size_t half = keylength_bits / 16;
+    if (std::memcmp(bytes, bytes + half, half) == 0) {
+        throw std::invalid_argument("XTS key halves must differ");
+    }
+
+    data_cipher_.init(bytes, static_cast<uint16_t>(keylength_bits / 2));
+    tweak_cipher_.init(bytes + half, static_cast<uint16_t>(keylength_bits / 2));
+}
+
+/**
+ * @brief Encrypt or decrypt one data unit given its encrypted tweak.
+ *
+ * Full blocks are handled in batches: the tweaks of the batch are written
+ * out, the input is whitened into the output, the output runs through the
+ * bulk kernels in place and is whitened again. When len is not a multiple
+ * of 16, the last full block and the partial block are finished with
+ * ciphertext stealing. The tweaks are as secret as the key, so the
+ * buffers holding them are wiped before returning.
+ *
+ * @param encrypting True to encrypt, false to decrypt.
+ * @param tweak Encrypted tweak of the first block.
+ * @param in Pointer to len bytes of input.
+ * @param out Pointer to len bytes of output.
+ * @param len Data unit length in bytes (at least 16).
+ */
+void RC6XTS::crypt(const bool encrypting, const uint8_t *tweak, const uint8_t *in, uint8_t *out,
+                   const size_t len) const {
+    const size_t tail = len % BLOCK_SIZE;
+    const size_t full = len / BLOCK_SIZE - (tail != 0 ? 1 : 0);
+
+    Tweak t = loadTweak(tweak);
+    uint8_t tweaks[BATCH_BLOCKS * BLOCK_SIZE];
+
+    for (size_t done = 0; done < full;) {
+        const size_t batch = std::min(full - done, BATCH_BLOCKS);
+        for (size_t n = 0; n < batch; ++n) {
+            storeTweak(tweaks + BLOCK_SIZE * n, t);
+            t = doubleTweak(t);
+        }
+        whitenedBlocks(data_cipher_, encrypting, tweaks, in + BLOCK_SIZE * done, out + BLOCK_SIZE * done, batch);
+        done += batch;
+    }
+    rc6_util::secureZero(tweaks, sizeof(tweaks));
+
+    if (tail == 0) {
+        rc6_util::secureZero(&t, sizeof(t));
+        return;
+    }
+
+    // Ciphertext stealing over block m-1 (full) and block m (tail bytes).
+    // Decryption uses the two tweaks in the opposite order.
+    const uint8_t *last_in = in + BLOCK_SIZE * full;
+    uint8_t *last_out = out + BLOCK_SIZE * full;
+    uint8_t first_tweak[BLOCK_SIZE], second_tweak[BLOCK_SIZE];
+    storeTweak(encrypting ? first_tweak : second_tweak, t);
+    storeTweak(encrypting ? second_tweak : first_tweak, doubleTweak(t));
+
+    uint8_t partial[BLOCK_SIZE];
+    std::memcpy(partial, last_in + BLOCK_SIZE, tail);
+
+    uint8_t block[BLOCK_SIZE];
+    whiten(block, last_in, first_tweak);
+    if (encrypting) {
+        data_cipher_.encryptUnchecked(block);
+    } else {
+        data_cipher_.decryptUnchecked(block);
+    }
+    whiten(block, block, first_tweak);
+
+    // The tail takes the head of this block; the tail input is padded with its remainder
+    std::memcpy(last_out + BLOCK_SIZE, block, tail);
+    std::memcpy(block, partial, tail);
+
+    whiten(block, block, second_tweak);
+    if (encrypting) {
+        data_cipher_.encryptUnchecked(block);
+    } else {
+        data_cipher_.decryptUnchecked(block);
+    }
+    whiten(last_out, block, second_tweak);
+
+    rc6_util::secureZero(&t, sizeof(t));
+    rc6_util::secureZero(first_tweak, sizeof(first_tweak));
+    rc6_util::secureZero(second_tweak, sizeof(second_tweak));
+    rc6_util::secureZero(partial, sizeof(partial));
+    rc6_util::secureZero(block, sizeof(block));
+}
+
+/**
+ * @brief Encrypt one data unit.
+ * @param tweak Pointer to the 16-byte tweak (data unit number).
+ * @param in Pointer to len bytes of plaintext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Data unit length in bytes (at least 16).
+ * @throws std::invalid_argument if a pointer is null or len is less than 16.
+ */
+void RC6XTS::encrypt(const void *tweak, const void *in, void *out, const size_t len) const {
+    if (tweak == nullptr || in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Data cannot be null");
+    }
+
+    if (len < BLOCK_SIZE) {
+        throw std::invalid_argument("XTS data unit must be at least 16 bytes");
+    }
+
+    uint8_t t[BLOCK_SIZE];
+    std::memcpy(t, tweak, BLOCK_SIZE);
+    tweak_cipher_.encryptUnchecked(t);
+    crypt(true, t, static_cast<const uint8_t *>(in), static_cast<uint8_t *>(out), len);
+    rc6_util::secureZero(t, sizeof(t));
+}
+
+/**
+ * @brief Decrypt one data unit.
+ * @param tweak Pointer to the 16-byte tweak (data unit number).
+ * @param in Pointer to len bytes of ciphertext.
+ * @param out Pointer to len bytes of output. Must either equal in or not overlap it.
+ * @param len Data unit length in bytes (at least 16).
+ * @throws std::invalid_argument if a pointer is null or len is less than 16.
+ */
+void RC6XTS::decrypt(const void *tweak, const void *in, void *out, const size_t len) const {
+    if (tweak == nullptr || in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Data cannot be null");
+    }
+
+    if (len < BLOCK_SIZE) {
+        throw std::invalid_argument("XTS data unit must be at least 16 bytes");
+    }
+
+    uint8_t t[BLOCK_SIZE];
+    std::memcpy(t, tweak, BLOCK_SIZE);
+    tweak_cipher_.encryptUnchecked(t);
+    crypt(false, t, static_cast<const uint8_t *>(in), static_cast<uint8_t *>(out), len);
+    rc6_util::secureZero(t, sizeof(t));
+}
+
+/**
+ * @brief Encrypt or decrypt consecutive sectors.
+ *
+ * The tweaks of up to BATCH_BLOCKS sectors are encrypted with one bulk
+ * call. When sectors are a whole number of blocks, the blocks of those
+ * sectors are then whitened and encrypted BATCH_BLOCKS at a time across
+ * sector boundaries, so small sectors still fill the vector lanes; other
+ * sector sizes go through crypt() one sector at a time for the stealing.
+ */
+void RC6XTS::cryptSectors(const bool encrypting, const uint64_t first_sector, const void *in, void *out,
+                          const size_t sector_size, const size_t count) const {
+    if (count == 0) {
+        return;
+    }
+
+    if (in == nullptr || out == nullptr) {
+        throw std::invalid_argument("Data cannot be null");
+    }
+
+    if (sector_size < BLOCK_SIZE) {
+        throw std::invalid_argument("XTS data unit must be at least 16 bytes");
+    }
+
+    const auto *src = static_cast<const uint8_t *>(in);
+    auto *dst = static_cast<uint8_t *>(out);
+    const size_t sector_blocks = sector_size / BLOCK_SIZE;
+    uint8_t sector_tweaks[BATCH_BLOCKS * BLOCK_SIZE];
+    uint8_t tweaks[BATCH_BLOCKS * BLOCK_SIZE];
+
+    for (size_t done = 0; done < count;) {
+        const size_t batch = std::min(count - done, BATCH_BLOCKS);
+        for (size_t n = 0; n < batch; ++n) {
+            storeTweak(sector_tweaks + BLOCK_SIZE * n, Tweak{first_sector + done + n, 0});
+        }
+        tweak_cipher_.encryptBlocksUnchecked(sector_tweaks, sector_tweaks, batch);
+
+        const uint8_t *group_in = src + sector_size * done;
+        uint8_t *group_out = dst + sector_size * done;
+        if (sector_size % BLOCK_SIZE != 0) {
+            for (size_t n = 0; n < batch; ++n) {
+                crypt(encrypting, sector_tweaks + BLOCK_SIZE * n, group_in + sector_size * n,
+                      group_out + sector_size * n, sector_size);
+            }
+            done += batch;
+            continue;
+        }
+
+        size_t sector = 0;
+        size_t block = 0;
+        Tweak t = loadTweak(sector_tweaks);
+        const size_t group_blocks = sector_blocks * batch;
+        for (size_t offset = 0; offset < group_blocks;) {
+            const size_t run = std::min(group_blocks - offset, BATCH_BLOCKS);
+            for (size_t n = 0; n < run; ++n) {
+                storeTweak(tweaks + BLOCK_SIZE * n, t);
+                t = doubleTweak(t);
+                if (++block == sector_blocks && ++sector < batch) {
+                    block = 0;
+                    t = loadTweak(sector_tweaks + BLOCK_SIZE * sector);
+                }
+            }
+            whitenedBlocks(data_cipher_, encrypting, tweaks, group_in + BLOCK_SIZE * offset,
+                           group_out + BLOCK_SIZE * offset, run);
+            offset += run;
+        }
+        rc6_util::secureZero(&t, sizeof(t));
+        done += batch;
+    }
+
+    rc6_util::secureZero(sector_tweaks, sizeof(sector_tweaks));
+    rc6_util::secureZero(tweaks, sizeof(tweaks));
+}
+
+/**
+ * @brief Encrypt consecutive sectors.
+ * @param first_sector Number of the first sector.
+ * @param in Pointer to count * sector_size bytes of plaintext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param sector_size Sector size in bytes (at least 16).
+ * @param count Number of sectors.
+ * @throws std::invalid_argument if in or out is null and count is non-zero,
+ *         or if sector_size is less than 16.
+ */
+void RC6XTS::encryptSectors(const uint64_t first_sector, const void *in, void *out, const size_t sector_size,
+                            const size_t count) const {
+    cryptSectors(true, first_sector, in, out, sector_size, count);
+}
+
+/**
+ * @brief Decrypt consecutive sectors.
+ * @param first_sector Number of the first sector.
+ * @param in Pointer to count * sector_size bytes of ciphertext.
+ * @param out Pointer to the output. Must either equal in or not overlap it.
+ * @param sector_size Sector size in bytes (at least 16).
+ * @param count Number of sectors.
+ * @throws std::invalid_argument if in or out is null and count is non-zero,
+ *         or if sector_size is less than 16.
+ */
+void RC6XTS::decryptSectors(const uint64_t first_sector, const void *in, void *out, const size_t sector_size,
+                            const size_t count) const {
+    cryptSectors(false, first_sector, in, out, sector_size, count);
+}
@@ -0,0 +1,290 @@
+/**
+ * @file rc6_c_test.c
+ * @brief Test program for the C interface of the RC6 library.
+ *
+ * Built as C and linked against the shared library only, so it also checks
+ * that rc6.h is valid C and that the library exports every entry point. The
+ * program returns non-zero if any check fails.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "rc6.h"
+
+static int failures = 0;
+
+/* Print one result line and count failures */
+static void report(const char *label, const int ok) {
+    printf("%-25s%s\n", label, ok ? "PASSED" : "FAILED");
+    if (!ok) {
+        ++failures;
+    }
+}
+
+static void title(const char *name) {
+    printf("%s\n===============================\n", name);
+}
+
+static void fill(unsigned char *data, const size_t len, const unsigned seed) {
+    size_t i;
+    for (i = 0; i < len; ++i) {
+        data[i] = (unsigned char) (i * 7 + seed);
+    }
+}
+
+static int allZero(const unsigned char *data, const size_t len) {
+    size_t i;
+    for (i = 0; i < len; ++i) {
+        if (data[i] != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void runBlockTest(const rc6_ctx *ctx) {
+    static const unsigned char plaintext[16] = {
+        0x02, 0x13, 0x24, 0x35, 0x46, 0x57, 0x68, 0x79,
+        0x8a, 0x9b, 0xac, 0xbd, 0xce, 0xdf, 0xe0, 0xf1
+    };
+    static const unsigned char expected[16] = {
+        0x52, 0x4e, 0x19, 0x2f, 0x47, 0x15, 0xc6, 0x23,
+        0x1f, 0x51, 0xf6, 0x36, 0x7e, 0xa4, 0x3f, 0x18
+    };
+    unsigned char block[16];
+    unsigned char data[37 * 16], bulk[37 * 16], single[37 * 16];
+    size_t i;
+
+    title("C API: blocks");
+
+    memcpy(block, plaintext, 16);
+    report("Known answer:", rc6_ecb_encrypt(ctx, block, block, 16) == RC6_OK &&
+                            memcmp(block, expected, 16) == 0 &&
+                            rc6_ecb_decrypt(ctx, block, block, 16) == RC6_OK &&
+                            memcmp(block, plaintext, 16) == 0);
+
+    /* One call over many blocks matches one call per block */
+    fill(data, sizeof(data), 1);
+    rc6_ecb_encrypt(ctx, data, bulk, sizeof(data));
+    for (i = 0; i < 37; ++i) {
+        rc6_ecb_encrypt(ctx, data + 16 * i, single + 16 * i, 16);
+    }
+    report("Bulk matches single:", memcmp(bulk, single, sizeof(bulk)) == 0 &&
+                                   rc6_ecb_decrypt(ctx, bulk, bulk, sizeof(bulk)) == RC6_OK &&
+                                   memcmp(bulk, data, sizeof(data)) == 0);
+    printf("\n");
+}
+
+static void runModeTest(const rc6_ctx *ctx) {
+    unsigned char iv[16], chain[16];
+    unsigned char data[1000], whole[1000], pieces[1000], back[1000];
+    unsigned char tag[16], short_tag[12];
+    static const unsigned char nonce[12] = {0xbb, 0xaa, 0x99, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00};
+    static const unsigned char ad[5] = {1, 2, 3, 4, 5};
+    static const size_t splits[] = {0, 1, 16, 31, 500, 999, 1000};
+    size_t i;
+    int ok;
+
+    title("C API: modes");
+    fill(iv, sizeof(iv), 9);
+    fill(data, sizeof(data), 3);
+
+    /* CTR pieces at their offsets match the whole message */
+    ok = rc6_ctr_crypt(ctx, iv, 0, data, whole, sizeof(data)) == RC6_OK;
+    for (i = 0; i + 1 < sizeof(splits) / sizeof(splits[0]); ++i) {
+        ok = ok && rc6_ctr_crypt(ctx, iv, splits[i], data + splits[i], pieces + splits[i],
+                                 splits[i + 1] - splits[i]) == RC6_OK;
+    }
+    ok = ok && memcmp(whole, pieces, sizeof(whole)) == 0 &&
+         rc6_ctr_crypt(ctx, iv, 0, whole, back, sizeof(whole)) == RC6_OK &&
+         memcmp(back, data, sizeof(data)) == 0;
+    report("CTR:", ok);
+
+    /* CBC updates the chaining value, so a message may be split */
+    memcpy(chain, iv, 16);
+    ok = rc6_cbc_encrypt(ctx, chain, data, whole, 992) == RC6_OK;
+    memcpy(chain, iv, 16);
+    ok = ok && rc6_cbc_encrypt(ctx, chain, data, pieces, 320) == RC6_OK &&
+         rc6_cbc_encrypt(ctx, chain, data + 320, pieces + 320, 672) == RC6_OK &&
+         memcmp(whole, pieces, 992) == 0;
+    memcpy(chain, iv, 16);
+    ok = ok && rc6_cbc_decrypt(ctx, chain, whole, back, 992) == RC6_OK && memcmp(back, data, 992) == 0;
+    report("CBC:", ok);
+
+    /* OCB round trip with full and truncated tags; a bad tag wipes the output */
+    ok = rc6_ocb_encrypt(ctx, nonce, sizeof(nonce), ad, sizeof(ad), data, sizeof(data), whole,
+                         tag, sizeof(tag)) == RC6_OK &&
+         rc6_ocb_decrypt(ctx, nonce, sizeof(nonce), ad, sizeof(ad), whole, sizeof(whole), back,
+                         tag, sizeof(tag)) == RC6_OK &&
+         memcmp(back, data, sizeof(data)) == 0;
+    ok = ok && rc6_ocb_encrypt(ctx, nonce, sizeof(nonce), NULL, 0, data, 33, pieces,
+                               short_tag, sizeof(short_tag)) == RC6_OK &&
+         rc6_ocb_decrypt(ctx, nonce, sizeof(nonce), NULL, 0, pieces, 33, back,
+                         short_tag, sizeof(short_tag)) == RC6_OK &&
+         memcmp(back, data, 33) == 0;
+    report("OCB round trip:", ok);
+
+    whole[500] ^= 0x01;
+    report("OCB rejects tampering:",
+           rc6_ocb_decrypt(ctx, nonce, sizeof(nonce), ad, sizeof(ad), whole, sizeof(whole), back,
+                           tag, sizeof(tag)) == RC6_ERROR_AUTHENTICATION &&
+           allZero(back, sizeof(back)));
+    printf("\n");
+}
+
+static void runXtsTest(void) {
+    unsigned char key[32], tweak[16];
+    unsigned char data[4 * 512], sectors[4 * 512], unit[512];
+    rc6_xts *xts = NULL;
+    int ok;
+
+    title("C API: XTS");
+    fill(key, sizeof(key), 5);
+    fill(data, sizeof(data), 11);
+
+    ok = rc6_xts_new(&xts, key, 256, RC6_DEFAULT_ROUNDS) == RC6_OK && xts != NULL;
+    ok = ok && rc6_xts_encrypt_sectors(xts, 7, data, sectors, 512, 4) == RC6_OK;
+
+    /* Sector 9 is the third sector, with its number as a little-endian tweak */
+    memset(tweak, 0, sizeof(tweak));
+    tweak[0] = 9;
+    ok = ok && rc6_xts_encrypt(xts, tweak, data + 1024, unit, 512) == RC6_OK &&
+         memcmp(unit, sectors + 1024, 512) == 0;
+    ok = ok && rc6_xts_decrypt_sectors(xts, 7, sectors, sectors, 512, 4) == RC6_OK &&
+         memcmp(sectors, data, sizeof(data)) == 0;
+    ok = ok && rc6_xts_encrypt(xts, tweak, data, unit, 37) == RC6_OK &&
+         rc6_xts_decrypt(xts, tweak, unit, unit, 37) == RC6_OK &&
+         memcmp(unit, data, 37) == 0;
+    report("Round trip:", ok);
+    rc6_xts_free(xts);
+
+    /* Equal key halves are rejected */
+    memcpy(key + 16, key, 16);
+    report("Equal halves rejected:", rc6_xts_new(&xts, key, 256, RC6_DEFAULT_ROUNDS) == RC6_ERROR_INVALID_KEY &&
+                                     xts == NULL);
+    printf("\n");
+}
+
+static void runStreamTest(const rc6_ctx *ctx) {
+    unsigned char iv[16], data[300], out[300 + 16], back[300 + 16], ctr[300];
+    rc6_stream *stream = NULL;
+    size_t total = 0, written = 0, i;
+    int ok;
+
+    title("C API: streams");
+    fill(iv, sizeof(iv), 2);
+    fill(data, sizeof(data), 4);
+
+    /* CBC with padding, fed in odd chunks */
+    ok = rc6_stream_new(&stream, ctx, RC6_STREAM_CBC, RC6_ENCRYPT, iv, 1) == RC6_OK;
+    for (i = 0; ok && i < sizeof(data); i += 37) {
+        const size_t chunk = sizeof(data) - i < 37 ? sizeof(data) - i : 37;
+        unsigned char buffer[37 + 15];
+        ok = rc6_stream_update(stream, data + i, chunk, buffer, &written) == RC6_OK;
+        memcpy(out + total, buffer, written);
+        total += written;
+    }
+    ok = ok && rc6_stream_final(stream, out + total, &written) == RC6_OK;
+    total += written;
+    ok = ok && total == 304 && rc6_stream_final(stream, out, &written) == RC6_ERROR_STATE;
+    rc6_stream_free(stream);
+
+    ok = ok && rc6_stream_new(&stream, ctx, RC6_STREAM_CBC, RC6_DECRYPT, iv, 1) == RC6_OK &&
+         rc6_stream_update(stream, out, total, back, &written) == RC6_OK;
+    total = written;
+    ok = ok && rc6_stream_final(stream, back + total, &written) == RC6_OK &&
+         total + written == sizeof(data) && memcmp(back, data, sizeof(data)) == 0;
+    rc6_stream_free(stream);
+    report("CBC with padding:", ok);
+
+    /* A CTR stream produces the same keystream as the stateless call */
+    ok = rc6_stream_new(&stream, ctx, RC6_STREAM_CTR, RC6_ENCRYPT, iv, 0) == RC6_OK &&
+         rc6_stream_update(stream, data, 100, out, &written) == RC6_OK && written == 100 &&
+         rc6_stream_update(stream, data + 100, 200, out + 100, &written) == RC6_OK && written == 200 &&
+         rc6_ctr_crypt(ctx, iv, 0, data, ctr, sizeof(data)) == RC6_OK &&
+         memcmp(out, ctr, sizeof(ctr)) == 0;
+    rc6_stream_free(stream);
+    report("CTR stream:", ok);
+
+    /* Incomplete ciphertext is reported, not thrown */
+    ok = rc6_stream_new(&stream, ctx, RC6_STREAM_CBC, RC6_DECRYPT, iv, 1) == RC6_OK &&
+         rc6_stream_update(stream, out, 17, back, &written) == RC6_OK &&
+         rc6_stream_final(stream, back, &written) == RC6_ERROR_BAD_PADDING;
+    rc6_stream_free(stream);
+    report("Incomplete input:", ok);
+    printf("\n");
+}
+
+static void runErrorTest(const rc6_ctx *ctx) {
+    unsigned char key[16] = {0}, block[32] = {0}, tag[16] = {0};
+    rc6_ctx *bad = (rc6_ctx *) block;
+    rc6_stream *stream = NULL;
+    size_t written = 0;
+    int ok;
+
+    title("C API: errors");
+
+    ok = rc6_ctx_new(NULL, key, 128, 20) == RC6_ERROR_NULL_POINTER &&
+         rc6_ctx_new(&bad, NULL, 128, 20) == RC6_ERROR_NULL_POINTER && bad == NULL &&
+         rc6_ctx_new(&bad, key, 0, 20) == RC6_ERROR_INVALID_KEY &&
+         rc6_ctx_new(&bad, key, RC6_MAX_KEY_BITS + 8, 20) == RC6_ERROR_INVALID_KEY &&
+         rc6_ctx_new(&bad, key, 128, RC6_MAX_ROUNDS + 1) == RC6_ERROR_INVALID_ROUNDS && bad == NULL;
+    report("Context creation:", ok);
+
+    ok = rc6_ecb_encrypt(NULL, block, block, 16) == RC6_ERROR_NULL_POINTER &&
+         rc6_ecb_encrypt(ctx, NULL, block, 16) == RC6_ERROR_NULL_POINTER &&
+         rc6_ecb_encrypt(ctx, NULL, NULL, 0) == RC6_OK &&
+         rc6_ecb_decrypt(ctx, block, block, 17) == RC6_ERROR_INVALID_LENGTH &&
+         rc6_cbc_encrypt(ctx, NULL, block, block, 16) == RC6_ERROR_NULL_POINTER &&
+         rc6_cbc_decrypt(ctx, tag, block, block, 15) == RC6_ERROR_INVALID_LENGTH &&
+         rc6_ctr_crypt(ctx, NULL, 0, block, block, 1) == RC6_ERROR_NULL_POINTER &&
+         rc6_ocb_encrypt(ctx, tag, 0, NULL, 0, block, 1, block, tag, 16) == RC6_ERROR_INVALID_LENGTH &&
+         rc6_ocb_encrypt(ctx, tag, 12, NULL, 0, block, 1, block, tag, 17) == RC6_ERROR_INVALID_LENGTH &&
+         rc6_ocb_decrypt(ctx, tag, 12, NULL, 1, block, 1, block, tag, 16) == RC6_ERROR_NULL_POINTER &&
+         rc6_xts_encrypt(NULL, tag, block, block, 16) == RC6_ERROR_NULL_POINTER;
+    report("Data calls:", ok);
+
+    ok = rc6_stream_new(&stream, ctx, (rc6_stream_mode) 9, RC6_ENCRYPT, tag, 1) == RC6_ERROR_INVALID_ARGUMENT &&
+         stream == NULL &&
+         rc6_stream_update(NULL, block, 1, block, &written) == RC6_ERROR_NULL_POINTER &&
+         rc6_stream_final(NULL, block, &written) == RC6_ERROR_NULL_POINTER;
+    report("Stream calls:", ok);
+
+    ok = rc6_abi_version() == RC6_ABI_VERSION &&
+         strcmp(rc6_status_string(RC6_OK), "Success") == 0 &&
+         strcmp(rc6_status_string((rc6_status) 99), "Unknown status") == 0 &&
+         rc6_backend_name() != NULL && rc6_backend_name()[0] != '\0';
+    report("Version and strings:", ok);
+
+    rc6_ctx_free(NULL);
+    rc6_xts_free(NULL);
+    rc6_stream_free(NULL);
+    printf("\n");
+}
+
+int main(void) {
+    static const unsigned char key[16] = {
+        0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+        0x01, 0x12, 0x23, 0x34, 0x45, 0x56, 0x67, 0x78
+    };
+    rc6_ctx *ctx = NULL;
+    rc6_status status;
+
+    printf("RC6 C API Test Suite\n====================\n\n");
+
+    status = rc6_ctx_new(&ctx, key, 128, RC6_DEFAULT_ROUNDS);
+    if (status != RC6_OK) {
+        printf("rc6_ctx_new: %s\n", rc6_status_string(status));
+        return 1;
+    }
+
+    runBlockTest(ctx);
+    runModeTest(ctx);
+    runXtsTest();
+    runStreamTest(ctx);
+    runErrorTest(ctx);
+    rc6_ctx_free(ctx);
+
+    printf("%s\n", failures == 0 ? "All tests passed" : "Some tests FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,304 @@
+/**
+ * @file rc6_ct_test.cpp
+ * @brief Timing-leak test for the RC6 library in the style of dudect.
+ *
+ * Each target operation is timed many times on two classes of secret
+ * input: one fixed value and fresh random values, interleaved at random.
+ * A Welch t-test compares the two timing distributions after discarding
+ * slow outliers. A constant-time operation shows no difference; a |t|
+ * above the threshold marks the target as leaking and the program fails.
+ *
+ * A deliberately leaky comparison is measured as well and must be
+ * detected, which shows that the harness can see a leak at all. The bulk
+ * targets are repeated with each other backend forced in turn.
+ *
+ * Without optimization or with sanitizers the timings say nothing about
+ * the shipped code, and the test reports itself skipped (exit code 77).
+ *
+ * Usage: rc6_ct_test [--samples=N] [--threshold=T]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define RC6_CT_HAVE_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define RC6_CT_HAVE_TSC 1
+#endif
+
+#include "rc6.hpp"
+#include "rc6_backend.hpp"
+#include "rc6_ocb.hpp"
+
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define RC6_CT_UNRELIABLE 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define RC6_CT_UNRELIABLE 1
+#endif
+#endif
+
+#if !defined(RC6_CT_UNRELIABLE) && (defined(__GNUC__) && !defined(__OPTIMIZE__))
+#define RC6_CT_UNRELIABLE 1
+#elif !defined(RC6_CT_UNRELIABLE) && defined(_MSC_VER) && defined(_DEBUG)
+#define RC6_CT_UNRELIABLE 1
+#endif
+
+namespace {
+    constexpr int SKIPPED = 77; //!< Exit code that CTest reports as skipped
+
+    uint64_t readTimer() {
+#ifdef RC6_CT_HAVE_TSC
+        _mm_lfence();
+        const uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Online mean and variance of two classes (Welford).
+     */
+    struct Welch {
+        double mean[2] = {0.0, 0.0};
+        double m2[2] = {0.0, 0.0};
+        double n[2] = {0.0, 0.0};
+
+        void push(const int cls, const double x) {
+            n[cls] += 1.0;
+            const double delta = x - mean[cls];
+            mean[cls] += delta / n[cls];
+            m2[cls] += delta * (x - mean[cls]);
+        }
+
+        double t() const {
+            if (n[0] < 2 || n[1] < 2) {
+                return 0.0;
+            }
+            const double var0 = m2[0] / (n[0] - 1);
+            const double var1 = m2[1] / (n[1] - 1);
+            const double den = std::sqrt(var0 / n[0] + var1 / n[1]);
+            return den == 0.0 ? 0.0 : (mean[0] - mean[1]) / den;
+        }
+    };
+
+    /**
+     * @brief One operation under test.
+     */
+    struct Target {
+        std::string name; //!< Printed name
+        size_t input_size; //!< Bytes of secret input per call
+        std::function<void(uint8_t *)> op; //!< Operation on a copy of the input
+        bool expect_leak; //!< True for the negative control
+        const uint8_t *fixed_input; //!< Input of the fixed class, or null for a random one
+    };
+
+    /**
+     * @brief Measure a target and return the largest |t| over the cropped sets.
+     */
+    double measure(const Target &target, const size_t samples, std::mt19937_64 &rng) {
+        const size_t batch = 1000;
+        const size_t size = target.input_size;
+        std::vector<uint8_t> fixed(size);
+        std::vector<uint8_t> inputs(batch * size);
+        std::vector<uint64_t> times(samples);
+        std::vector<uint8_t> classes(samples);
+
+        for (size_t i = 0; i < size; ++i) {
+            fixed[i] = target.fixed_input != nullptr ? target.fixed_input[i] : static_cast<uint8_t>(rng());
+        }
+
+        // Warm up caches and the kernel dispatcher
+        for (int i = 0; i < 1000; ++i) {
+            std::memcpy(inputs.data(), fixed.data(), size);
+            target.op(inputs.data());
+        }
+
+        // Inputs are prepared a batch ahead so that both classes reach the
+        // timed call in the same state
+        for (size_t first = 0; first < samples; first += batch) {
+            const size_t count = std::min(batch, samples - first);
+            for (size_t s = 0; s < count; ++s) {
+                uint8_t *input = &inputs[s * size];
+                classes[first + s] = static_cast<uint8_t>(rng() & 1);
+                if (classes[first + s] == 0) {
+                    std::memcpy(input, fixed.data(), size);
+                } else {
+                    for (size_t i = 0; i < size; i += 8) {
+                        const uint64_t r = rng();
+                        std::memcpy(input + i, &r, std::min<size_t>(8, size - i));
+                    }
+                }
+            }
+
+            for (size_t s = 0; s < count; ++s) {
+                const uint64_t start = readTimer();
+                target.op(&inputs[s * size]);
+                times[first + s] = readTimer() - start;
+            }
+        }
+
+        // Interrupts and migrations only ever add time, so crop from the top
+        std::vector<uint64_t> sorted(times);
+        std::sort(sorted.begin(), sorted.end());
+        const double percentiles[] = {0.5, 0.75, 0.9, 0.99};
+
+        double worst = 0.0;
+        for (const double p: percentiles) {
+            const uint64_t cutoff = sorted[static_cast<size_t>(p * static_cast<double>(samples - 1))];
+            Welch welch;
+            for (size_t s = 0; s < samples; ++s) {
+                if (times[s] <= cutoff) {
+                    welch.push(classes[s], static_cast<double>(times[s]));
+                }
+            }
+            worst = std::max(worst, std::fabs(welch.t()));
+        }
+        return worst;
+    }
+
+    // Defeats dead-code elimination of results
+    volatile uint8_t sink;
+}
+
+int main(int argc, char **argv) {
+    size_t samples = 200000;
+    double threshold = 10.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.compare(0, 10, "--samples=") == 0) {
+            samples = std::strtoull(arg.c_str() + 10, nullptr, 10);
+        } else if (arg.compare(0, 12, "--threshold=") == 0) {
+            threshold = std::strtod(arg.c_str() + 12, nullptr);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--samples=N] [--threshold=T]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (samples < 1000) {
+        std::cerr << "Error: at least 1000 samples are needed" << std::endl;
+        return 1;
+    }
+    if (threshold <= 0.0) {
+        std::cerr << "Error: threshold must be positive" << std::endl;
+        return 1;
+    }
+
+#ifdef RC6_CT_UNRELIABLE
+    std::cout << "RC6 timing-leak test skipped: unoptimized or sanitized build" << std::endl;
+    return SKIPPED;
+#else
+    try {
+        std::mt19937_64 rng(0x5eed);
+
+        uint8_t key[16];
+        for (size_t i = 0; i < sizeof(key); ++i) {
+            key[i] = static_cast<uint8_t>(rng());
+        }
+        RC6 rc6;
+        rc6.init(key, 128);
+
+        const size_t bulk_blocks = 64;
+        std::vector<uint8_t> bulk_out(bulk_blocks * 16);
+
+        std::vector<RC6> many(16);
+        std::vector<const void *> many_keys(many.size());
+
+        const RC6OCB ocb(rc6);
+        const uint8_t nonce[12] = {0};
+        uint8_t message[32] = {0};
+        uint8_t tag[16];
+        ocb.encrypt(nonce, sizeof(nonce), nullptr, 0, message, sizeof(message), message, tag);
+        uint8_t ocb_out[32];
+
+        uint8_t secret[64];
+        for (size_t i = 0; i < sizeof(secret); ++i) {
+            secret[i] = static_cast<uint8_t>(rng());
+        }
+
+        const std::vector<Target> targets = {
+            {"encrypt_block", 16, [&](uint8_t *in) { rc6.encryptUnchecked(in); }, false, nullptr},
+            {"decrypt_block", 16, [&](uint8_t *in) { rc6.decryptUnchecked(in); }, false, nullptr},
+            {"encrypt_blocks", bulk_blocks * 16, [&](uint8_t *in) {
+                rc6.encryptBlocksUnchecked(in, bulk_out.data(), bulk_blocks);
+            }, false, nullptr},
+            {"decrypt_blocks", bulk_blocks * 16, [&](uint8_t *in) {
+                rc6.decryptBlocksUnchecked(in, bulk_out.data(), bulk_blocks);
+            }, false, nullptr},
+            {"key_setup_128", 16, [&](uint8_t *in) { rc6.tryInit(in, 128); }, false, nullptr},
+            {"key_setup_256", 32, [&](uint8_t *in) { rc6.tryInit(in, 256); }, false, nullptr},
+            {"init_many_128x16", 16 * 16, [&](uint8_t *in) {
+                for (size_t k = 0; k < many.size(); ++k) {
+                    many_keys[k] = in + 16 * k;
+                }
+                RC6::initMany(many.data(), many_keys.data(), 128, many.size());
+            }, false, nullptr},
+            {"ocb_tag_check", 16, [&](uint8_t *in) {
+                sink = ocb.decrypt(nonce, sizeof(nonce), nullptr, 0, message, sizeof(message), ocb_out, in);
+            }, false, nullptr},
+            // Negative control: an early-exit comparison, whose fixed class equals the secret
+            {"leaky_compare", sizeof(secret), [&](uint8_t *in) {
+                size_t i = 0;
+                while (i < sizeof(secret) && in[i] == secret[i]) {
+                    ++i;
+                }
+                sink = static_cast<uint8_t>(i);
+            }, true, secret},
+        };
+
+        bool pass = true;
+        std::cout << std::left << std::setw(24) << "target" << std::right << std::setw(12) << "max |t|"
+                << "  result" << std::endl;
+        const auto check = [&](const Target &target, const std::string &label) {
+            // The key setup targets rekey the shared object
+            rc6.init(key, 128);
+            const double t = measure(target, samples, rng);
+            const bool leaks = t > threshold;
+            const bool ok = leaks == target.expect_leak;
+            pass = pass && ok;
+            std::cout << std::left << std::setw(24) << label << std::right << std::fixed
+                    << std::setprecision(2) << std::setw(12) << t << "  "
+                    << (target.expect_leak ? (leaks ? "detected (control)" : "NOT DETECTED (control)")
+                                           : (leaks ? "LEAKS" : "ok"))
+                    << std::endl;
+        };
+        for (const auto &target: targets) {
+            check(target, target.name);
+        }
+
+        // The bulk targets again on every other backend they can be pinned to
+        const std::string automatic = RC6Backend::active();
+        for (const auto &name: RC6Backend::available()) {
+            if (name == automatic) {
+                continue;
+            }
+            RC6Backend::force(name);
+            check(targets[2], targets[2].name + "/" + name);
+            check(targets[3], targets[3].name + "/" + name);
+        }
+        RC6Backend::reset();
+
+        std::cout << (pass ? "PASSED" : "FAILED") << std::endl;
+        return pass ? 0 : 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+#endif
+}
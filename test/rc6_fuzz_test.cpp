@@ -0,0 +1,829 @@
+/**
+ * @file rc6_fuzz_test.cpp
+ * @brief Randomized cross-check of every fast path against the reference.
+ *
+ * Each case is decoded from a short byte string: key, number of rounds,
+ * message length, buffer misalignment, IV, counter width, chunk boundaries
+ * and key assignment. The single-block transform, which no backend
+ * replaces, computes the expected output of ECB, CBC, CTR, CFB and OFB.
+ * Every bulk path, including batch key setup, per-lane keys, transposed
+ * schedules, batches and the parallel engine, then runs with each
+ * available backend forced in turn and must match it byte for byte. OCB
+ * and XTS have no second implementation here; they must match their own
+ * output under the scalar backend and decrypt back. Known-answer vectors
+ * anchor the reference and are pushed through the same paths.
+ *
+ * The byte strings come from a seeded generator, so a failure is replayed
+ * with the --seed and --case printed with it. Built with RC6_LIBFUZZER the
+ * file provides LLVMFuzzerTestOneInput instead of main, and the fuzzer
+ * supplies the bytes.
+ *
+ * Usage: rc6_fuzz_test [--seed=N] [--iterations=N] [--case=N]
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rc6.hpp"
+#include "rc6_backend.hpp"
+#include "rc6_batch.hpp"
+#include "rc6_cbc.hpp"
+#include "rc6_ctr.hpp"
+#include "rc6_generic.hpp"
+#include "rc6_ocb.hpp"
+#include "rc6_parallel.hpp"
+#include "rc6_schedule.hpp"
+#include "rc6_stream.hpp"
+#include "rc6_xts.hpp"
+
+namespace {
+    constexpr size_t BLOCK = 16; //!< RC6 block size in bytes
+    constexpr size_t MAX_BLOCKS = 160; //!< Longest message, enough for every batch size plus a tail
+    constexpr size_t ALIGNMENT = 64; //!< Buffers are placed at an offset from this boundary
+    constexpr size_t MAX_TENANTS = 5; //!< Most ciphers in a many-keys case
+    constexpr size_t CASE_BYTES = 96; //!< Length of a generated case
+
+    using Bytes = std::vector<uint8_t>;
+
+    /**
+     * @brief Decodes case parameters from the input bytes.
+     *
+     * Once the input is exhausted every read returns zero, so any input,
+     * including an empty one, is a valid case.
+     */
+    class CaseReader {
+        const uint8_t *data_;
+        size_t size_;
+        size_t pos_;
+
+    public:
+        CaseReader(const uint8_t *data, const size_t size) : data_(data), size_(size), pos_(0) {
+        }
+
+        uint8_t byte() {
+            return pos_ < size_ ? data_[pos_++] : 0;
+        }
+
+        // Value in [0, n) from two input bytes
+        size_t below(const size_t n) {
+            const size_t value = byte() | static_cast<size_t>(byte()) << 8;
+            return value % n;
+        }
+
+        void read(uint8_t *out, const size_t len) {
+            for (size_t i = 0; i < len; ++i) {
+                out[i] = byte();
+            }
+        }
+    };
+
+    /**
+     * @brief A buffer that starts a chosen number of bytes past an aligned address.
+     */
+    class Buffer {
+        Bytes storage_;
+        uint8_t *data_;
+        size_t len_;
+
+    public:
+        Buffer(const size_t len, const size_t misalign) : storage_(len + 2 * ALIGNMENT), len_(len) {
+            const auto base = reinterpret_cast<uintptr_t>(storage_.data());
+            const uintptr_t aligned = (base + ALIGNMENT - 1) & ~static_cast<uintptr_t>(ALIGNMENT - 1);
+            data_ = storage_.data() + (aligned - base) + misalign % ALIGNMENT;
+        }
+
+        uint8_t *data() {
+            return data_;
+        }
+
+        void assign(const Bytes &bytes) {
+            std::copy(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(len_), data_);
+        }
+
+        bool equals(const uint8_t *expected) const {
+            return len_ == 0 || std::memcmp(data_, expected, len_) == 0;
+        }
+    };
+
+    /**
+     * @brief Counts mismatches and reports the first few.
+     */
+    class Checker {
+        size_t failures_;
+        std::string context_;
+
+    public:
+        Checker() : failures_(0) {
+        }
+
+        void setContext(const std::string &context) {
+            context_ = context;
+        }
+
+        void check(const bool ok, const char *what) {
+            if (ok) {
+                return;
+            }
+            if (failures_ < 20) {
+                std::cout << "Mismatch: " << what << " [" << context_ << ", backend "
+                        << RC6Backend::active() << "]" << std::endl;
+            }
+            ++failures_;
+        }
+
+        size_t failures() const {
+            return failures_;
+        }
+    };
+
+    /**
+     * @brief Parameters of one case.
+     */
+    struct Case {
+        Bytes key;
+        uint8_t rounds;
+        size_t len;
+        size_t in_misalign;
+        size_t out_misalign;
+        uint8_t iv[BLOCK];
+        uint8_t counter_bytes;
+        uint64_t offset;
+        size_t chunk_seed;
+        size_t tenants;
+        size_t run_length;
+        size_t schedule_count;
+        size_t nonce_len;
+        size_t tag_len;
+        size_t ad_len;
+        size_t sector_size;
+        Bytes plaintext;
+    };
+
+    Case decodeCase(const uint8_t *data, const size_t size) {
+        CaseReader reader(data, size);
+        Case c;
+
+        // Mostly short keys, sometimes up to the 2048-bit maximum
+        const size_t key_bytes = reader.byte() < 32 ? 1 + reader.below(RC6::MAX_KEY_BITS / 8) : 1 + reader.below(32);
+        c.key.resize(key_bytes);
+        reader.read(c.key.data(), key_bytes);
+
+        // The standard 20 rounds half the time, otherwise 0 to 40
+        const uint8_t rounds = reader.byte();
+        c.rounds = rounds < 128 ? 20 : static_cast<uint8_t>(rounds % 41);
+
+        c.len = reader.below(MAX_BLOCKS * BLOCK + 1);
+        c.in_misalign = reader.below(ALIGNMENT);
+        c.out_misalign = reader.below(ALIGNMENT);
+
+        // Counters near the top of their field carry into the higher bytes
+        reader.read(c.iv, BLOCK);
+        if (reader.byte() & 1) {
+            std::fill(c.iv + BLOCK - 1 - reader.below(4), c.iv + BLOCK, 0xff);
+        }
+        c.counter_bytes = static_cast<uint8_t>(1 + reader.below(BLOCK));
+        c.offset = reader.below(1u << 16);
+        if (reader.byte() & 1) {
+            c.offset += static_cast<uint64_t>(reader.byte()) << 36;
+        }
+
+        c.chunk_seed = reader.below(1u << 16);
+        c.tenants = 1 + reader.below(MAX_TENANTS);
+        c.run_length = 1 + reader.below(20);
+        c.schedule_count = reader.below(5);
+        c.nonce_len = 1 + reader.below(RC6OCB::MAX_NONCE_SIZE);
+        c.tag_len = 1 + reader.below(RC6OCB::MAX_TAG_SIZE);
+        c.ad_len = reader.below(3 * BLOCK * 4);
+        c.sector_size = BLOCK + reader.below(4 * BLOCK * 8);
+
+        std::mt19937 fill(static_cast<uint32_t>(reader.below(1u << 16)));
+        c.plaintext.resize(c.len);
+        for (auto &byte: c.plaintext) {
+            byte = static_cast<uint8_t>(fill());
+        }
+        return c;
+    }
+
+    /**
+     * @brief Split a length into chunks of 0 to 40 bytes, with zero-length chunks.
+     */
+    std::vector<size_t> chunkSizes(const size_t len, const size_t seed) {
+        std::minstd_rand rng(static_cast<uint32_t>(seed + 1));
+        std::vector<size_t> sizes;
+        size_t done = 0;
+        while (done < len) {
+            const size_t chunk = std::min<size_t>(rng() % 41, len - done);
+            sizes.push_back(chunk);
+            done += chunk;
+        }
+        return sizes;
+    }
+
+    void xorInto(uint8_t *out, const uint8_t *a, const uint8_t *b, const size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            out[i] = static_cast<uint8_t>(a[i] ^ b[i]);
+        }
+    }
+
+    // Reference transforms built on the single-block path only
+
+    Bytes referenceECB(const RC6 &cipher, const Bytes &in, const bool encrypting) {
+        Bytes out(in);
+        for (size_t i = 0; i + BLOCK <= out.size(); i += BLOCK) {
+            if (encrypting) {
+                cipher.encrypt(&out[i]);
+            } else {
+                cipher.decrypt(&out[i]);
+            }
+        }
+        return out;
+    }
+
+    Bytes referenceCBC(const RC6 &cipher, const uint8_t *iv, const Bytes &in, const bool encrypting) {
+        Bytes out(in);
+        uint8_t chain[BLOCK];
+        std::memcpy(chain, iv, BLOCK);
+        for (size_t i = 0; i + BLOCK <= out.size(); i += BLOCK) {
+            if (encrypting) {
+                xorInto(&out[i], &in[i], chain, BLOCK);
+                cipher.encrypt(&out[i]);
+                std::memcpy(chain, &out[i], BLOCK);
+            } else {
+                cipher.decrypt(&out[i]);
+                xorInto(&out[i], &out[i], chain, BLOCK);
+                std::memcpy(chain, &in[i], BLOCK);
+            }
+        }
+        return out;
+    }
+
+    // Counter block of a block index: the low counter_bytes bytes are a big-endian sum, mod 2^(8 * width)
+    void counterBlock(const uint8_t *iv, const uint8_t counter_bytes, uint64_t index, uint8_t *block) {
+        std::memcpy(block, iv, BLOCK);
+        unsigned carry = 0;
+        for (size_t k = 0; k < counter_bytes; ++k) {
+            const size_t pos = BLOCK - 1 - k;
+            const unsigned sum = block[pos] + static_cast<unsigned>(index & 0xff) + carry;
+            block[pos] = static_cast<uint8_t>(sum);
+            carry = sum >> 8;
+            index >>= 8;
+        }
+    }
+
+    Bytes referenceCTR(const RC6 &cipher, const uint8_t *iv, const uint8_t counter_bytes, const uint64_t offset,
+                       const Bytes &in) {
+        Bytes out(in.size());
+        for (size_t i = 0; i < in.size(); ++i) {
+            const uint64_t position = offset + i;
+            uint8_t keystream[BLOCK];
+            counterBlock(iv, counter_bytes, position / BLOCK, keystream);
+            cipher.encrypt(keystream);
+            out[i] = static_cast<uint8_t>(in[i] ^ keystream[position % BLOCK]);
+        }
+        return out;
+    }
+
+    Bytes referenceCFB(const RC6 &cipher, const uint8_t *iv, const Bytes &in, const bool encrypting) {
+        Bytes out(in.size());
+        uint8_t feedback[BLOCK];
+        std::memcpy(feedback, iv, BLOCK);
+        for (size_t i = 0; i < in.size(); i += BLOCK) {
+            const size_t n = std::min(BLOCK, in.size() - i);
+            uint8_t keystream[BLOCK];
+            std::memcpy(keystream, feedback, BLOCK);
+            cipher.encrypt(keystream);
+            xorInto(&out[i], &in[i], keystream, n);
+            std::memcpy(feedback, encrypting ? &out[i] : &in[i], n);
+        }
+        return out;
+    }
+
+    Bytes referenceOFB(const RC6 &cipher, const uint8_t *iv, const Bytes &in) {
+        Bytes out(in.size());
+        uint8_t keystream[BLOCK];
+        std::memcpy(keystream, iv, BLOCK);
+        for (size_t i = 0; i < in.size(); i += BLOCK) {
+            cipher.encrypt(keystream);
+            xorInto(&out[i], &in[i], keystream, std::min(BLOCK, in.size() - i));
+        }
+        return out;
+    }
+
+    RC6Parallel &engine() {
+        // Small chunks so that short messages are split across tasks too
+        static RC6Parallel parallel(3, 64);
+        return parallel;
+    }
+
+    /**
+     * @brief Run a stream over chunked input and collect everything it writes.
+     */
+    Bytes runStream(const RC6 &cipher, const RC6Stream::Mode mode, const RC6Stream::Direction direction,
+                    const uint8_t *iv, const bool padding, const Bytes &in, const std::vector<size_t> &chunks) {
+        RC6Stream stream(cipher, mode, direction, iv, padding);
+        Bytes out(in.size() + 2 * BLOCK);
+        size_t read = 0, written = 0;
+        for (const size_t chunk: chunks) {
+            written += stream.update(in.data() + read, chunk, out.data() + written);
+            read += chunk;
+        }
+        written += stream.final(out.data() + written);
+        out.resize(written);
+        return out;
+    }
+
+    /**
+     * @brief Outputs of the modes whose expected value is their scalar-backend result.
+     */
+    struct SelfChecked {
+        Bytes ocb;
+        uint8_t tag[BLOCK];
+        Bytes xts;
+        Bytes sectors;
+        Bytes padded;
+    };
+
+    SelfChecked runSelfChecked(const Case &c, const RC6 &cipher, const RC6XTS &xts, Checker &checker) {
+        SelfChecked result;
+        const RC6OCB ocb(cipher, c.tag_len);
+        Bytes ad(c.ad_len);
+        for (size_t i = 0; i < ad.size(); ++i) {
+            ad[i] = static_cast<uint8_t>(i * 13 + c.len);
+        }
+
+        result.ocb.resize(c.len);
+        ocb.encrypt(c.iv, c.nonce_len, ad.data(), ad.size(), c.plaintext.data(), c.len,
+                    result.ocb.data(), result.tag);
+        Bytes opened(c.len);
+        checker.check(ocb.decrypt(c.iv, c.nonce_len, ad.data(), ad.size(), result.ocb.data(), c.len,
+                                  opened.data(), result.tag) && opened == c.plaintext, "OCB round trip");
+
+        if (c.len >= BLOCK) {
+            result.xts.resize(c.len);
+            xts.encrypt(c.iv, c.plaintext.data(), result.xts.data(), c.len);
+            xts.decrypt(c.iv, result.xts.data(), opened.data(), c.len);
+            checker.check(opened == c.plaintext, "XTS round trip");
+        }
+
+        const size_t sectors = c.len / c.sector_size;
+        result.sectors.resize(sectors * c.sector_size);
+        xts.encryptSectors(c.offset, c.plaintext.data(), result.sectors.data(), c.sector_size, sectors);
+        Bytes back(result.sectors.size());
+        xts.decryptSectors(c.offset, result.sectors.data(), back.data(), c.sector_size, sectors);
+        checker.check(std::equal(back.begin(), back.end(), c.plaintext.begin()), "XTS sectors round trip");
+
+        const std::vector<size_t> chunks = chunkSizes(c.len, c.chunk_seed);
+        result.padded = runStream(cipher, RC6Stream::Mode::CBC, RC6Stream::Direction::Encrypt, c.iv, true,
+                                  c.plaintext, chunks);
+        checker.check(runStream(cipher, RC6Stream::Mode::CBC, RC6Stream::Direction::Decrypt, c.iv, true,
+                                result.padded, chunkSizes(result.padded.size(), c.chunk_seed + 1)) == c.plaintext,
+                      "CBC stream with padding round trip");
+        return result;
+    }
+
+    /**
+     * @brief Check every bulk path of one case under the backend currently forced.
+     */
+    void checkBulkPaths(const Case &c, const RC6 &cipher, const RC6 *const *tenants, Checker &checker) {
+        const size_t nblocks = c.len / BLOCK;
+        const size_t whole = nblocks * BLOCK;
+        const Bytes blocks(c.plaintext.begin(), c.plaintext.begin() + static_cast<std::ptrdiff_t>(whole));
+        const Bytes ecb = referenceECB(cipher, blocks, true);
+
+        // ECB, out of place between misaligned buffers and in place
+        Buffer in(whole, c.in_misalign), out(whole, c.out_misalign);
+        in.assign(blocks);
+        cipher.encryptBlocks(in.data(), out.data(), nblocks);
+        checker.check(out.equals(ecb.data()), "encryptBlocks");
+        cipher.decryptBlocks(out.data(), nblocks);
+        checker.check(out.equals(blocks.data()), "decryptBlocks in place");
+        cipher.encryptBlocksUnchecked(in.data(), in.data(), nblocks);
+        checker.check(in.equals(ecb.data()), "encryptBlocksUnchecked in place");
+        in.assign(ecb);
+        cipher.decryptBlocksUnchecked(in.data(), out.data(), nblocks);
+        checker.check(out.equals(blocks.data()), "decryptBlocksUnchecked");
+
+        // Batch key setup through the backend's key mixing kernel
+        {
+            std::vector<RC6> keyed;
+            for (size_t k = 0; k < c.tenants + 2; ++k) {
+                keyed.emplace_back(c.rounds);
+            }
+            std::vector<const void *> keys(keyed.size(), c.key.data());
+            RC6::initMany(keyed.data(), keys.data(), static_cast<uint16_t>(8 * c.key.size()), keyed.size());
+            bool same = true;
+            for (const auto &k: keyed) {
+                Buffer one(whole, c.out_misalign);
+                k.encryptBlocks(blocks.data(), one.data(), nblocks);
+                same = same && one.equals(ecb.data());
+            }
+            checker.check(same, "initMany");
+        }
+
+        // Per-block ciphers in runs that straddle lane groups
+        {
+            std::vector<const RC6 *> owners(nblocks);
+            Bytes expected(blocks);
+            for (size_t i = 0; i < nblocks; ++i) {
+                owners[i] = tenants[i / c.run_length % c.tenants];
+                owners[i]->encrypt(&expected[BLOCK * i]);
+            }
+            in.assign(blocks);
+            RC6::encryptBlocksMany(owners.data(), in.data(), out.data(), nblocks);
+            checker.check(out.equals(expected.data()), "encryptBlocksMany");
+        }
+
+        // Transposed schedules, broadcast and with count keys over the lanes
+        {
+            const RC6Schedule broadcast(cipher);
+            in.assign(blocks);
+            broadcast.encryptBlocks(in.data(), out.data(), nblocks);
+            checker.check(out.equals(ecb.data()), "RC6Schedule encrypt");
+            broadcast.decryptBlocks(out.data(), nblocks);
+            checker.check(out.equals(blocks.data()), "RC6Schedule decrypt");
+
+            const size_t count = std::min<size_t>(static_cast<size_t>(1) << c.schedule_count, broadcast.lanes());
+            std::vector<const RC6 *> lane_ciphers(count);
+            for (size_t k = 0; k < count; ++k) {
+                lane_ciphers[k] = tenants[k % c.tenants];
+            }
+            const RC6Schedule lanes(lane_ciphers.data(), count);
+            Bytes expected(blocks);
+            for (size_t i = 0; i < nblocks; ++i) {
+                lane_ciphers[i % count]->encrypt(&expected[BLOCK * i]);
+            }
+            lanes.encryptBlocks(in.data(), out.data(), nblocks);
+            checker.check(out.equals(expected.data()), "RC6Schedule per lane encrypt");
+            lanes.decryptBlocks(out.data(), nblocks);
+            checker.check(out.equals(blocks.data()), "RC6Schedule per lane decrypt");
+        }
+
+        // CBC in one call, in two calls, and as several messages at once
+        {
+            const Bytes cbc = referenceCBC(cipher, c.iv, blocks, true);
+            const RC6CBC mode(cipher);
+            uint8_t chain[BLOCK];
+            std::memcpy(chain, c.iv, BLOCK);
+            const size_t first = nblocks / 3;
+            in.assign(blocks);
+            mode.encrypt(chain, in.data(), out.data(), first);
+            mode.encrypt(chain, in.data() + BLOCK * first, out.data() + BLOCK * first, nblocks - first);
+            checker.check(out.equals(cbc.data()), "CBC encrypt");
+            checker.check(nblocks == 0 || std::memcmp(chain, &cbc[whole - BLOCK], BLOCK) == 0, "CBC chaining value");
+
+            std::memcpy(chain, c.iv, BLOCK);
+            in.assign(cbc);
+            mode.decrypt(chain, in.data(), out.data(), nblocks);
+            checker.check(out.equals(blocks.data()), "CBC decrypt");
+
+            engine().decryptCBC(cipher, c.iv, in.data(), out.data(), nblocks);
+            checker.check(out.equals(blocks.data()), "parallel CBC decrypt");
+
+            std::vector<RC6CBC::Message> messages;
+            size_t start = 0;
+            while (start < nblocks) {
+                RC6CBC::Message message;
+                message.nblocks = std::min(nblocks - start, c.run_length);
+                message.in = &blocks[BLOCK * start];
+                message.out = out.data() + BLOCK * start;
+                std::memcpy(message.iv, c.iv, BLOCK);
+                message.iv[0] = static_cast<uint8_t>(message.iv[0] + messages.size());
+                messages.push_back(message);
+                start += message.nblocks;
+            }
+            mode.encryptMany(messages.data(), messages.size());
+            bool many = true;
+            for (size_t m = 0, block = 0; m < messages.size(); block += messages[m].nblocks, ++m) {
+                uint8_t iv[BLOCK];
+                std::memcpy(iv, c.iv, BLOCK);
+                iv[0] = static_cast<uint8_t>(iv[0] + m);
+                const Bytes part(blocks.begin() + static_cast<std::ptrdiff_t>(BLOCK * block),
+                                 blocks.begin() + static_cast<std::ptrdiff_t>(BLOCK * (block + messages[m].nblocks)));
+                const Bytes expected = referenceCBC(cipher, iv, part, true);
+                many = many && std::memcmp(out.data() + BLOCK * block, expected.data(), expected.size()) == 0;
+            }
+            checker.check(many, "CBC encryptMany");
+        }
+
+        // ECB on the parallel engine
+        in.assign(blocks);
+        engine().encryptECB(cipher, in.data(), out.data(), nblocks);
+        checker.check(out.equals(ecb.data()), "parallel ECB encrypt");
+        engine().decryptECB(cipher, out.data(), out.data(), nblocks);
+        checker.check(out.equals(blocks.data()), "parallel ECB decrypt");
+
+        // CTR at an offset, sequentially in chunks, on the engine and in batches
+        {
+            const Bytes expected = referenceCTR(cipher, c.iv, c.counter_bytes, c.offset, c.plaintext);
+            Buffer ctr_in(c.len, c.in_misalign), ctr_out(c.len, c.out_misalign);
+            ctr_in.assign(c.plaintext);
+            const RC6CTR ctr(cipher, c.iv, c.counter_bytes);
+            ctr.processAt(c.offset, ctr_in.data(), ctr_out.data(), c.len);
+            checker.check(ctr_out.equals(expected.data()), "CTR processAt");
+
+            engine().processCTR(ctr, c.offset, ctr_in.data(), ctr_out.data(), c.len);
+            checker.check(ctr_out.equals(expected.data()), "parallel CTR");
+
+            const Bytes from_start = referenceCTR(cipher, c.iv, c.counter_bytes, 0, c.plaintext);
+            RC6CTR sequential(cipher, c.iv, c.counter_bytes);
+            size_t done = 0;
+            for (const size_t chunk: chunkSizes(c.len, c.chunk_seed)) {
+                sequential.process(ctr_in.data() + done, ctr_out.data() + done, chunk);
+                done += chunk;
+            }
+            checker.check(ctr_out.equals(from_start.data()), "CTR process in chunks");
+
+            // One message per owner run, each under its own key and IV
+            std::vector<RC6Batch::Job> jobs;
+            Bytes batch_expected(c.len);
+            done = 0;
+            for (const size_t chunk: chunkSizes(c.len, c.chunk_seed + 7)) {
+                RC6Batch::Job job;
+                job.cipher = tenants[jobs.size() % c.tenants];
+                std::memcpy(job.iv, c.iv, BLOCK);
+                job.iv[3] = static_cast<uint8_t>(job.iv[3] ^ jobs.size());
+                job.in = ctr_in.data() + done;
+                job.out = ctr_out.data() + done;
+                job.len = chunk;
+                const Bytes part(c.plaintext.begin() + static_cast<std::ptrdiff_t>(done),
+                                 c.plaintext.begin() + static_cast<std::ptrdiff_t>(done + chunk));
+                const Bytes want = referenceCTR(*job.cipher, job.iv, BLOCK, 0, part);
+                std::copy(want.begin(), want.end(), batch_expected.begin() + static_cast<std::ptrdiff_t>(done));
+                jobs.push_back(job);
+                done += chunk;
+            }
+            RC6Batch::processCTR(jobs.data(), jobs.size());
+            checker.check(ctr_out.equals(batch_expected.data()), "RC6Batch CTR");
+        }
+
+        // Streams in chunks against the references
+        {
+            const std::vector<size_t> chunks = chunkSizes(c.len, c.chunk_seed + 3);
+            const std::vector<size_t> block_chunks = chunkSizes(whole, c.chunk_seed + 5);
+            const Bytes ctr = referenceCTR(cipher, c.iv, BLOCK, 0, c.plaintext);
+            const Bytes cfb = referenceCFB(cipher, c.iv, c.plaintext, true);
+            const Bytes ofb = referenceOFB(cipher, c.iv, c.plaintext);
+            const Bytes cbc = referenceCBC(cipher, c.iv, blocks, true);
+            using Mode = RC6Stream::Mode;
+            const auto enc = RC6Stream::Direction::Encrypt;
+            const auto dec = RC6Stream::Direction::Decrypt;
+
+            checker.check(runStream(cipher, Mode::CTR, enc, c.iv, false, c.plaintext, chunks) == ctr, "CTR stream");
+            checker.check(runStream(cipher, Mode::CFB, enc, c.iv, false, c.plaintext, chunks) == cfb,
+                          "CFB stream encrypt");
+            checker.check(runStream(cipher, Mode::CFB, dec, c.iv, false, cfb, chunks) == c.plaintext,
+                          "CFB stream decrypt");
+            checker.check(runStream(cipher, Mode::OFB, enc, c.iv, false, c.plaintext, chunks) == ofb, "OFB stream");
+            checker.check(runStream(cipher, Mode::CBC, enc, c.iv, false, blocks, block_chunks) == cbc,
+                          "CBC stream encrypt");
+            checker.check(runStream(cipher, Mode::CBC, dec, c.iv, false, cbc, block_chunks) == blocks,
+                          "CBC stream decrypt");
+        }
+    }
+
+    /**
+     * @brief Run one case under every backend.
+     * @return Number of mismatches.
+     */
+    size_t runCase(const uint8_t *data, const size_t size, Checker &checker) {
+        const size_t before = checker.failures();
+        const Case c = decodeCase(data, size);
+        const auto key_bits = static_cast<uint16_t>(8 * c.key.size());
+
+        RC6 cipher(c.rounds);
+        cipher.init(c.key.data(), key_bits);
+
+        // The single-block path itself against the independent template
+        if (c.rounds == 20) {
+            RC6T<uint32_t> generic;
+            generic.init(c.key.data(), key_bits);
+            const size_t whole = c.len / BLOCK * BLOCK;
+            Bytes expected(c.plaintext.begin(), c.plaintext.begin() + static_cast<std::ptrdiff_t>(whole));
+            generic.encryptBlocks(expected.data(), whole / BLOCK);
+            const Bytes blocks(c.plaintext.begin(), c.plaintext.begin() + static_cast<std::ptrdiff_t>(whole));
+            checker.check(referenceECB(cipher, blocks, true) == expected, "single block against RC6T");
+        }
+
+        // Tenants share the round count, so that every path accepts them
+        std::vector<RC6> tenants;
+        std::vector<const RC6 *> tenant_pointers;
+        for (size_t k = 0; k < c.tenants; ++k) {
+            Bytes key(c.key);
+            key[0] = static_cast<uint8_t>(key[0] ^ (k * 0x35));
+            tenants.emplace_back(c.rounds);
+            tenants.back().init(key.data(), key_bits);
+        }
+        for (const auto &tenant: tenants) {
+            tenant_pointers.push_back(&tenant);
+        }
+
+        // XTS with the case key as data key and a derived tweak key
+        Bytes xts_key(2 * std::min<size_t>(c.key.size(), RC6::MAX_KEY_BITS / 8));
+        for (size_t i = 0; i < xts_key.size() / 2; ++i) {
+            xts_key[i] = c.key[i];
+            xts_key[i + xts_key.size() / 2] = static_cast<uint8_t>(c.key[i] ^ 0xa5);
+        }
+        const RC6XTS xts(xts_key.data(), static_cast<uint16_t>(8 * xts_key.size()), c.rounds);
+
+        RC6Backend::force("scalar");
+        const SelfChecked scalar = runSelfChecked(c, cipher, xts, checker);
+
+        for (const auto &name: RC6Backend::available()) {
+            RC6Backend::force(name);
+            checkBulkPaths(c, cipher, tenant_pointers.data(), checker);
+
+            if (name != "scalar") {
+                const SelfChecked wide = runSelfChecked(c, cipher, xts, checker);
+                checker.check(wide.ocb == scalar.ocb && std::memcmp(wide.tag, scalar.tag, c.tag_len) == 0,
+                              "OCB against scalar");
+                checker.check(wide.xts == scalar.xts, "XTS against scalar");
+                checker.check(wide.sectors == scalar.sectors, "XTS sectors against scalar");
+                checker.check(wide.padded == scalar.padded, "CBC stream with padding against scalar");
+            }
+        }
+        RC6Backend::reset();
+        return checker.failures() - before;
+    }
+
+    /**
+     * @brief Known-answer vectors, each repeated through the bulk paths of every backend.
+     * @return Number of mismatches.
+     */
+    size_t runKnownAnswers(Checker &checker) {
+        struct Vector {
+            uint16_t key_bits;
+            uint8_t key[32];
+            uint8_t plaintext[BLOCK];
+            uint8_t ciphertext[BLOCK];
+        };
+        static const Vector vectors[] = {
+            {128, {0}, {0},
+             {0x8f, 0xc3, 0xa5, 0x36, 0x56, 0xb1, 0xf7, 0x78, 0xc1, 0x29, 0xdf, 0x4e, 0x98, 0x48, 0xa4, 0x1e}},
+            {128, {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x01, 0x12, 0x23, 0x34, 0x45, 0x56, 0x67, 0x78},
+             {0x02, 0x13, 0x24, 0x35, 0x46, 0x57, 0x68, 0x79, 0x8a, 0x9b, 0xac, 0xbd, 0xce, 0xdf, 0xe0, 0xf1},
+             {0x52, 0x4e, 0x19, 0x2f, 0x47, 0x15, 0xc6, 0x23, 0x1f, 0x51, 0xf6, 0x36, 0x7e, 0xa4, 0x3f, 0x18}},
+            {192, {0}, {0},
+             {0x6c, 0xd6, 0x1b, 0xcb, 0x19, 0x0b, 0x30, 0x38, 0x4e, 0x8a, 0x3f, 0x16, 0x86, 0x90, 0xae, 0x82}},
+            {192, {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x01, 0x12, 0x23, 0x34, 0x45, 0x56, 0x67, 0x78,
+                   0x89, 0x9a, 0xab, 0xbc, 0xcd, 0xde, 0xef, 0xf0},
+             {0x02, 0x13, 0x24, 0x35, 0x46, 0x57, 0x68, 0x79, 0x8a, 0x9b, 0xac, 0xbd, 0xce, 0xdf, 0xe0, 0xf1},
+             {0x68, 0x83, 0x29, 0xd0, 0x19, 0xe5, 0x05, 0x04, 0x1e, 0x52, 0xe9, 0x2a, 0xf9, 0x52, 0x91, 0xd4}},
+            {256, {0}, {0},
+             {0x8f, 0x5f, 0xbd, 0x05, 0x10, 0xd1, 0x5f, 0xa8, 0x93, 0xfa, 0x3f, 0xda, 0x6e, 0x85, 0x7e, 0xc2}},
+            {256, {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x01, 0x12, 0x23, 0x34, 0x45, 0x56, 0x67, 0x78,
+                   0x89, 0x9a, 0xab, 0xbc, 0xcd, 0xde, 0xef, 0xf0, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe},
+             {0x02, 0x13, 0x24, 0x35, 0x46, 0x57, 0x68, 0x79, 0x8a, 0x9b, 0xac, 0xbd, 0xce, 0xdf, 0xe0, 0xf1},
+             {0xc8, 0x24, 0x18, 0x16, 0xf0, 0xd7, 0xe4, 0x89, 0x20, 0xad, 0x16, 0xa1, 0x67, 0x4e, 0x5d, 0x48}}
+        };
+        constexpr size_t COUNT = sizeof(vectors) / sizeof(vectors[0]);
+        constexpr size_t COPIES = 16 + 8 + 4 + 2 + 1; //!< Every group width plus a tail
+        const size_t before = checker.failures();
+        checker.setContext("known answers");
+
+        RC6 ciphers[COUNT];
+        const RC6 *pointers[COUNT];
+        for (size_t v = 0; v < COUNT; ++v) {
+            ciphers[v].init(vectors[v].key, vectors[v].key_bits);
+            pointers[v] = &ciphers[v];
+        }
+
+        for (const auto &name: RC6Backend::available()) {
+            RC6Backend::force(name);
+            for (size_t v = 0; v < COUNT; ++v) {
+                const Vector &kat = vectors[v];
+                Buffer data(COPIES * BLOCK, 1 + v), out(COPIES * BLOCK, 3 + v);
+                for (size_t i = 0; i < COPIES; ++i) {
+                    std::memcpy(data.data() + BLOCK * i, kat.plaintext, BLOCK);
+                }
+
+                Bytes expected(COPIES * BLOCK);
+                for (size_t i = 0; i < COPIES; ++i) {
+                    std::memcpy(&expected[BLOCK * i], kat.ciphertext, BLOCK);
+                }
+
+                uint8_t single[BLOCK];
+                std::memcpy(single, kat.plaintext, BLOCK);
+                ciphers[v].encrypt(single);
+                checker.check(std::memcmp(single, kat.ciphertext, BLOCK) == 0, "single block");
+
+                ciphers[v].encryptBlocks(data.data(), out.data(), COPIES);
+                checker.check(out.equals(expected.data()), "encryptBlocks");
+
+                const RC6Schedule schedule(ciphers[v]);
+                schedule.encryptBlocks(data.data(), out.data(), COPIES);
+                checker.check(out.equals(expected.data()), "RC6Schedule");
+
+                engine().encryptECB(ciphers[v], data.data(), out.data(), COPIES);
+                checker.check(out.equals(expected.data()), "parallel ECB");
+
+                // The first keystream block of CTR is the encrypted IV
+                uint8_t zero[BLOCK] = {0}, keystream[BLOCK];
+                RC6CTR(ciphers[v], kat.plaintext).processAt(0, zero, keystream, BLOCK);
+                checker.check(std::memcmp(keystream, kat.ciphertext, BLOCK) == 0, "CTR");
+            }
+
+            // Block i under vector i % COUNT
+            std::vector<const RC6 *> owners(COPIES);
+            Buffer data(COPIES * BLOCK, 5), out(COPIES * BLOCK, 9);
+            Bytes expected(COPIES * BLOCK);
+            for (size_t i = 0; i < COPIES; ++i) {
+                owners[i] = pointers[i % COUNT];
+                std::memcpy(data.data() + BLOCK * i, vectors[i % COUNT].plaintext, BLOCK);
+                std::memcpy(&expected[BLOCK * i], vectors[i % COUNT].ciphertext, BLOCK);
+            }
+            RC6::encryptBlocksMany(owners.data(), data.data(), out.data(), COPIES);
+            checker.check(out.equals(expected.data()), "encryptBlocksMany");
+        }
+        RC6Backend::reset();
+        return checker.failures() - before;
+    }
+
+    void generateCase(const uint64_t seed, const uint64_t index, uint8_t *data) {
+        std::mt19937_64 rng(seed * 0x9e3779b97f4a7c15ull + index);
+        for (size_t i = 0; i < CASE_BYTES; ++i) {
+            data[i] = static_cast<uint8_t>(rng());
+        }
+    }
+}
+
+#ifdef RC6_LIBFUZZER
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, const size_t size) {
+    static bool anchored = false;
+    Checker checker;
+    if (!anchored) {
+        anchored = true;
+        if (runKnownAnswers(checker) != 0) {
+            std::abort();
+        }
+    }
+
+    checker.setContext("fuzzer input");
+    if (runCase(data, size, checker) != 0) {
+        std::abort();
+    }
+    return 0;
+}
+#else
+int main(int argc, char **argv) {
+    uint64_t seed = 1;
+    uint64_t iterations = 500;
+    uint64_t first = 0;
+    bool single = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.compare(0, 7, "--seed=") == 0) {
+            seed = std::strtoull(arg.c_str() + 7, nullptr, 10);
+        } else if (arg.compare(0, 13, "--iterations=") == 0) {
+            iterations = std::strtoull(arg.c_str() + 13, nullptr, 10);
+        } else if (arg.compare(0, 7, "--case=") == 0) {
+            first = std::strtoull(arg.c_str() + 7, nullptr, 10);
+            single = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--seed=N] [--iterations=N] [--case=N]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        std::cout << "RC6 Cross-check Test" << std::endl;
+        std::cout << "====================" << std::endl;
+        std::cout << "Backends:               ";
+        for (const auto &name: RC6Backend::available()) {
+            std::cout << ' ' << name;
+        }
+        std::cout << std::endl;
+
+        Checker checker;
+        const size_t known = runKnownAnswers(checker);
+        std::cout << "Known answers:           " << (known == 0 ? "PASSED" : "FAILED") << std::endl;
+
+        const uint64_t last = single ? first + 1 : iterations;
+        size_t failed_cases = 0;
+        for (uint64_t index = first; index < last; ++index) {
+            uint8_t data[CASE_BYTES];
+            generateCase(seed, index, data);
+            checker.setContext("--seed=" + std::to_string(seed) + " --case=" + std::to_string(index));
+            if (runCase(data, sizeof(data), checker) != 0) {
+                ++failed_cases;
+            }
+        }
+
+        // The empty input decodes to the smallest case
+        checker.setContext("empty input");
+        failed_cases += runCase(nullptr, 0, checker) != 0;
+
+        std::cout << "Random cases:            " << (failed_cases == 0 ? "PASSED" : "FAILED")
+                << " (" << (last - first + 1) << " cases, seed " << seed << ")" << std::endl;
+        return checker.failures() == 0 ? 0 : 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+#endif
@@ -0,0 +1,257 @@
+/**
+ * @file rc6_perf_test.cpp
+ * @brief Performance smoke test for the RC6 fast paths.
+ *
+ * Absolute throughput depends on the machine, so every check is a ratio
+ * between two paths measured in the same run: a bulk path against the
+ * one-block-per-call loop, a mode against bulk ECB on the same backend, or
+ * a vector backend against the interleaved scalar one. The minimum ratios
+ * sit well below what any supported backend reaches, so the test only
+ * fails when a fast path has fallen back to something much slower, such
+ * as a lost kernel, a per-block loop, or a serialized engine.
+ *
+ * Each path is timed several times and the best run counts, which keeps
+ * the test stable on loaded machines. Without optimization or with
+ * sanitizers the ratios mean nothing, and the test reports itself skipped
+ * (exit code 77).
+ *
+ * Usage: rc6_perf_test [--slack=F] [--min-time=SECONDS]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "rc6.hpp"
+#include "rc6_backend.hpp"
+#include "rc6_cbc.hpp"
+#include "rc6_ctr.hpp"
+#include "rc6_ocb.hpp"
+#include "rc6_parallel.hpp"
+#include "rc6_schedule.hpp"
+#include "rc6_xts.hpp"
+
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define RC6_PERF_UNRELIABLE 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define RC6_PERF_UNRELIABLE 1
+#endif
+#endif
+
+#if !defined(RC6_PERF_UNRELIABLE) && (defined(__GNUC__) && !defined(__OPTIMIZE__))
+#define RC6_PERF_UNRELIABLE 1
+#elif !defined(RC6_PERF_UNRELIABLE) && defined(_MSC_VER) && defined(_DEBUG)
+#define RC6_PERF_UNRELIABLE 1
+#endif
+
+namespace {
+    constexpr int SKIPPED = 77; //!< Exit code that CTest reports as skipped
+    constexpr size_t BLOCK = 16; //!< RC6 block size in bytes
+    constexpr size_t BYTES = 64 * 1024; //!< Data per timed call, well inside L2
+    constexpr int RUNS = 5; //!< Timed runs per path; the fastest counts
+
+    double min_time = 0.02; //!< Seconds per timed run
+
+#ifndef RC6_PERF_UNRELIABLE
+    /**
+     * @brief Measure throughput of one path.
+     * @param body Processes BYTES bytes once.
+     * @return Best throughput over RUNS runs, in bytes per second.
+     */
+    double measure(const std::function<void()> &body) {
+        using Clock = std::chrono::steady_clock;
+        body();
+
+        double best = 0.0;
+        for (int run = 0; run < RUNS; ++run) {
+            size_t calls = 0;
+            const auto start = Clock::now();
+            double elapsed = 0.0;
+            do {
+                body();
+                ++calls;
+                elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            } while (elapsed < min_time);
+            best = std::max(best, static_cast<double>(calls * BYTES) / elapsed);
+        }
+        return best;
+    }
+
+    /**
+     * @brief Compares measured ratios against their minimum.
+     */
+    class Ratios {
+        double slack_;
+        size_t failures_;
+
+    public:
+        explicit Ratios(const double slack) : slack_(slack), failures_(0) {
+        }
+
+        void check(const std::string &label, const double fast, const double baseline, const double minimum) {
+            const double ratio = fast / baseline;
+            const bool ok = ratio >= minimum * slack_;
+            std::cout << std::left << std::setw(34) << label << std::right << std::fixed << std::setprecision(2)
+                    << std::setw(8) << ratio << "x  (min " << minimum * slack_ << "x)  "
+                    << (ok ? "PASSED" : "FAILED") << std::endl;
+            failures_ += ok ? 0 : 1;
+        }
+
+        size_t failures() const {
+            return failures_;
+        }
+    };
+#endif
+}
+
+int main(int argc, char **argv) {
+    double slack = 1.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.compare(0, 8, "--slack=") == 0) {
+            slack = std::strtod(arg.c_str() + 8, nullptr);
+        } else if (arg.compare(0, 11, "--min-time=") == 0) {
+            min_time = std::strtod(arg.c_str() + 11, nullptr);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--slack=F] [--min-time=SECONDS]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (slack <= 0.0 || min_time <= 0.0) {
+        std::cerr << "Error: slack and min-time must be positive" << std::endl;
+        return 1;
+    }
+
+#ifdef RC6_PERF_UNRELIABLE
+    std::cout << "RC6 performance smoke test skipped: unoptimized or sanitized build" << std::endl;
+    return SKIPPED;
+#else
+    try {
+        std::cout << "RC6 Performance Smoke Test" << std::endl;
+        std::cout << "==========================" << std::endl;
+
+        const uint8_t key[16] = {
+            0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+            0x01, 0x12, 0x23, 0x34, 0x45, 0x56, 0x67, 0x78
+        };
+        RC6 rc6;
+        rc6.init(key, 128);
+
+        std::vector<uint8_t> in(BYTES), out(BYTES);
+        for (size_t i = 0; i < in.size(); ++i) {
+            in[i] = static_cast<uint8_t>(i * 7 + 1);
+        }
+        const size_t nblocks = BYTES / BLOCK;
+        Ratios ratios(slack);
+
+        // The baseline of the bulk paths: one call per block
+        const double single = measure([&] {
+            for (size_t i = 0; i < nblocks; ++i) {
+                rc6.encrypt(&out[BLOCK * i]);
+            }
+        });
+        std::cout << "Single-block loop:                " << std::fixed << std::setprecision(1)
+                << single / 1e6 << " MB/s" << std::endl;
+
+        // Bulk ECB of every backend, so that a slow one is caught on its own; even
+        // the narrowest stays close to the single-block loop
+        double scalar = 0.0;
+        const std::vector<std::string> backends = RC6Backend::available();
+        std::vector<double> ecb(backends.size());
+        for (size_t b = 0; b < backends.size(); ++b) {
+            RC6Backend::force(backends[b]);
+            ecb[b] = measure([&] { rc6.encryptBlocks(in.data(), out.data(), nblocks); });
+            if (backends[b] == "scalar") {
+                scalar = ecb[b];
+            }
+        }
+        for (size_t b = 0; b < backends.size(); ++b) {
+            ratios.check(backends[b] + " ECB vs single-block", ecb[b], single, 0.7);
+        }
+        for (size_t b = 0; b < backends.size(); ++b) {
+            // Eight or more lanes clearly outrun two interleaved scalar blocks
+            RC6Backend::force(backends[b]);
+            if (rc6.bulkLanes() >= 8) {
+                ratios.check(backends[b] + " ECB vs scalar ECB", ecb[b], scalar, 1.0);
+            }
+        }
+        RC6Backend::reset();
+
+        // Modes and helpers against bulk ECB on the automatic backend
+        const double base = measure([&] { rc6.encryptBlocks(in.data(), out.data(), nblocks); });
+
+        const RC6Schedule schedule(rc6);
+        ratios.check("RC6Schedule vs ECB", measure([&] {
+            schedule.encryptBlocks(in.data(), out.data(), nblocks);
+        }), base, 0.5);
+
+        const double decrypt = measure([&] { rc6.decryptBlocks(in.data(), out.data(), nblocks); });
+        ratios.check("ECB decrypt vs ECB", decrypt, base, 0.5);
+
+        uint8_t iv[BLOCK] = {0};
+        const RC6CTR ctr(rc6, iv);
+        ratios.check("CTR vs ECB", measure([&] { ctr.processAt(0, in.data(), out.data(), BYTES); }), base, 0.15);
+
+        const RC6CBC cbc(rc6);
+        ratios.check("CBC decrypt vs ECB", measure([&] {
+            uint8_t chain[BLOCK] = {0};
+            cbc.decrypt(chain, in.data(), out.data(), nblocks);
+        }), base, 0.4);
+
+        const RC6OCB ocb(rc6);
+        ratios.check("OCB encrypt vs ECB", measure([&] {
+            uint8_t tag[BLOCK];
+            ocb.encrypt(iv, 12, nullptr, 0, in.data(), BYTES, out.data(), tag);
+        }), base, 0.2);
+
+        uint8_t xts_key[32];
+        for (size_t i = 0; i < sizeof(xts_key); ++i) {
+            xts_key[i] = static_cast<uint8_t>(i * 3 + 1);
+        }
+        const RC6XTS xts(xts_key, 256);
+        ratios.check("XTS sectors vs ECB", measure([&] {
+            xts.encryptSectors(0, in.data(), out.data(), 512, BYTES / 512);
+        }), base, 0.2);
+
+        // Lane-major blocks under as many keys as lanes
+        std::vector<RC6> tenants(rc6.bulkLanes());
+        std::vector<const RC6 *> owners(nblocks);
+        for (size_t k = 0; k < tenants.size(); ++k) {
+            uint8_t tenant_key[16];
+            std::memcpy(tenant_key, key, sizeof(tenant_key));
+            tenant_key[0] = static_cast<uint8_t>(k);
+            tenants[k].init(tenant_key, 128);
+        }
+        for (size_t i = 0; i < nblocks; ++i) {
+            owners[i] = &tenants[i % tenants.size()];
+        }
+        ratios.check("Many keys vs single-block", measure([&] {
+            RC6::encryptBlocksMany(owners.data(), in.data(), out.data(), nblocks);
+        }), single, 1.0);
+
+        // The engine must not be much slower than one thread, whatever the core count
+        RC6Parallel engine(0, 16 * 1024);
+        ratios.check("Parallel ECB vs ECB", measure([&] {
+            engine.encryptECB(rc6, in.data(), out.data(), nblocks);
+        }), base, 0.5);
+
+        if (ratios.failures() != 0) {
+            std::cout << ratios.failures() << " ratios FAILED" << std::endl;
+            return 1;
+        }
+        std::cout << "All ratios passed" << std::endl;
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+#endif
+}
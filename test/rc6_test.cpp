@@ -1,9 +1,34 @@
 #include <iostream>
+#include <fstream>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <iterator>
+#include <limits>
+#include <cstdio>
 #include <iomanip>
 #include <cstring>
-#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <thread>
 
 #include "rc6.hpp"
+#include "rc6_async.hpp"
+#include "rc6_backend.hpp"
+#include "rc6_batch.hpp"
+#include "rc6_cache.hpp"
+#include "rc6_cbc.hpp"
+#include "rc6_ctr.hpp"
+#include "rc6_file.hpp"
+#include "rc6_generic.hpp"
+#include "rc6_ocb.hpp"
+#include "rc6_parallel.hpp"
+#include "rc6_schedule.hpp"
+#include "rc6_secure_pool.hpp"
+#include "rc6_stats.hpp"
+#include "rc6_stream.hpp"
+#include "rc6_xts.hpp"
 
 // Function to print a block of data in hex format
 void printBlock(const uint8_t *block, const size_t size) {
@@ -14,6 +39,17 @@ void printBlock(const uint8_t *block, const size_t size) {
     std::cout << std::dec << std::endl;
 }
 
+// Number of failed checks; main returns non-zero if there are any
+size_t failedChecks = 0;
+
+// Function to turn a check into its result text, counting failures
+const char *verdict(const bool passed) {
+    if (!passed) {
+        ++failedChecks;
+    }
+    return passed ? "PASSED" : "FAILED";
+}
+
 // Function to run a test case
 void runTestCase(const std::string &testName,
                  const uint8_t *plaintext,
@@ -56,11 +92,1469 @@ void runTestCase(const std::string &testName,
 
     // Verify ciphertext matches expected
     const bool ciphertextMatch = (std::memcmp(ciphertext, expectedCiphertext, 16) == 0);
-    std::cout << "Ciphertext verification: " << (ciphertextMatch ? "PASSED" : "FAILED") << std::endl;
+    std::cout << "Ciphertext verification: " << verdict(ciphertextMatch) << std::endl;
 
     // Verify decryption is correct
     const bool decryptionMatch = (std::memcmp(plaintext, decryptedtext, 16) == 0);
-    std::cout << "Decryption verification: " << (decryptionMatch ? "PASSED" : "FAILED") << std::endl;
+    std::cout << "Decryption verification: " << verdict(decryptionMatch) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check bulk encryption against the single-block API
+void runBulkTest(const uint8_t *key, const uint16_t keyLengthBits, const size_t blocks,
+                 const uint8_t rounds = 20) {
+    std::cout << "Bulk block operations (" << blocks << " blocks, "
+            << static_cast<int>(rounds) << " rounds)" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 rc6(rounds);
+    rc6.init(key, keyLengthBits);
+
+    std::vector<uint8_t> plaintext(blocks * 16);
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+
+    // Reference result using one call per block
+    std::vector<uint8_t> expected(plaintext);
+    for (size_t i = 0; i < blocks; ++i) {
+        rc6.encrypt(&expected[16 * i]);
+    }
+
+    std::vector<uint8_t> ciphertext(blocks * 16);
+    rc6.encryptBlocks(plaintext.data(), ciphertext.data(), blocks);
+    const bool outOfPlaceMatch = (ciphertext == expected);
+    std::cout << "Out-of-place encryption: " << verdict(outOfPlaceMatch) << std::endl;
+
+    std::vector<uint8_t> inPlace(plaintext);
+    rc6.encryptBlocks(inPlace.data(), blocks);
+    const bool inPlaceMatch = (inPlace == expected);
+    std::cout << "In-place encryption:     " << verdict(inPlaceMatch) << std::endl;
+
+    std::vector<uint8_t> decrypted(blocks * 16);
+    rc6.decryptBlocks(ciphertext.data(), decrypted.data(), blocks);
+    rc6.decryptBlocks(inPlace.data(), blocks);
+    const bool decryptionMatch = (decrypted == plaintext) && (inPlace == plaintext);
+    std::cout << "Bulk decryption:         " << verdict(decryptionMatch) << std::endl;
+
+    // Misaligned input and output, including the single-block path
+    std::vector<uint8_t> misaligned(blocks * 16 + 4);
+    std::vector<uint8_t> misalignedOut(blocks * 16 + 4);
+    std::copy(plaintext.begin(), plaintext.end(), misaligned.begin() + 1);
+    rc6.encryptBlocks(&misaligned[1], &misalignedOut[3], blocks);
+    rc6.encryptUnchecked(&misaligned[1]);
+    rc6.encrypt(&misaligned[1]);
+    rc6.decrypt(&misaligned[1]);
+    const bool misalignedMatch = std::equal(expected.begin(), expected.end(), misalignedOut.begin() + 3) &&
+                                 std::equal(expected.begin(), expected.begin() + 16, misaligned.begin() + 1);
+    std::cout << "Misaligned buffers:      " << verdict(misalignedMatch) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check that every backend can be forced and gives the same bulk results
+void runBackendTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "Kernel backends" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    const std::vector<std::string> backends = RC6Backend::available();
+    std::cout << "Available:              ";
+    for (const auto &name: backends) {
+        std::cout << ' ' << name;
+    }
+    std::cout << std::endl;
+
+    // Keep a backend pinned through RC6_BACKEND for the rest of the run
+    const bool pinned = RC6Backend::isForced();
+    const std::string pinnedName = RC6Backend::active();
+    RC6Backend::reset();
+
+    const bool listed = !backends.empty() && backends.back() == "scalar" && !RC6Backend::isForced() &&
+                        std::find(backends.begin(), backends.end(), RC6Backend::active()) != backends.end();
+    std::cout << "Automatic selection:     " << verdict(listed) << std::endl;
+
+    RC6 rc6;
+    rc6.init(key, keyLengthBits);
+
+    // Enough blocks for every width, plus a tail below the narrowest
+    const size_t blocks = 16 + 8 + 4 + 2 + 1;
+    std::vector<uint8_t> plaintext(blocks * 16);
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 11 + 5);
+    }
+    std::vector<uint8_t> expected(plaintext.size());
+    rc6.encryptBlocks(plaintext.data(), expected.data(), blocks);
+
+    // Runs of shared schedules that straddle groups, and a different round count
+    RC6 tenants[4] = {RC6(), RC6(), RC6(12), RC6()};
+    for (size_t k = 0; k < 4; ++k) {
+        uint8_t tenantKey[32];
+        std::memcpy(tenantKey, key, keyLengthBits / 8);
+        tenantKey[1] ^= static_cast<uint8_t>(k + 1);
+        tenants[k].init(tenantKey, keyLengthBits);
+    }
+    std::vector<const RC6 *> blockCiphers(blocks);
+    std::vector<uint8_t> manyExpected(plaintext.size());
+    for (size_t i = 0; i < blocks; ++i) {
+        blockCiphers[i] = &tenants[i < 16 ? i / 5 % 2 : i / 3 % 4];
+        blockCiphers[i]->encryptBlocks(&plaintext[16 * i], &manyExpected[16 * i], 1);
+    }
+
+    bool forced = true;
+    for (const auto &name: backends) {
+        RC6Backend::force(name);
+        forced = forced && RC6Backend::active() == name && RC6Backend::isForced();
+
+        std::vector<uint8_t> data(plaintext.size());
+        rc6.encryptBlocks(plaintext.data(), data.data(), blocks);
+        forced = forced && data == expected;
+        rc6.decryptBlocks(data.data(), blocks);
+        forced = forced && data == plaintext;
+
+        RC6 keyed[3];
+        const void *keys[3] = {key, key, key};
+        RC6::initMany(keyed, keys, keyLengthBits, 3);
+        std::vector<uint8_t> manyOut(plaintext.size());
+        keyed[2].encryptBlocks(plaintext.data(), manyOut.data(), blocks);
+        forced = forced && manyOut == expected;
+
+        RC6::encryptBlocksMany(blockCiphers.data(), plaintext.data(), manyOut.data(), blocks);
+        forced = forced && manyOut == manyExpected;
+    }
+    RC6Backend::reset();
+    forced = forced && !RC6Backend::isForced();
+    std::cout << "Forced backends:         " << verdict(forced) << std::endl;
+
+    bool rejected = false;
+    try {
+        RC6Backend::force("no-such-backend");
+    } catch (const std::invalid_argument &) {
+        rejected = !RC6Backend::isForced();
+    }
+    RC6Backend::force("auto");
+    std::cout << "Unknown backend:         " << verdict(rejected && !RC6Backend::isForced())
+            << std::endl;
+
+    if (pinned) {
+        RC6Backend::force(pinnedName);
+    }
+
+    std::cout << std::endl;
+}
+
+// Function to check the transposed key schedules on every backend
+void runScheduleTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "Transposed schedules" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    const bool pinned = RC6Backend::isForced();
+    const std::string pinnedName = RC6Backend::active();
+
+    RC6 tenants[16];
+    for (size_t k = 0; k < 16; ++k) {
+        uint8_t tenantKey[32];
+        std::memcpy(tenantKey, key, keyLengthBits / 8);
+        tenantKey[2] ^= static_cast<uint8_t>(k + 1);
+        tenants[k].init(tenantKey, keyLengthBits);
+    }
+    const RC6 *tenantPointers[16];
+    for (size_t k = 0; k < 16; ++k) {
+        tenantPointers[k] = &tenants[k];
+    }
+
+    // Two groups of the widest backend plus a tail of every length below it
+    const size_t blocks = 2 * 16 + 15;
+    std::vector<uint8_t> plaintext(blocks * 16);
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 13 + 1);
+    }
+
+    bool broadcast = true;
+    bool many = true;
+    for (const auto &name: RC6Backend::available()) {
+        RC6Backend::force(name);
+
+        std::vector<uint8_t> expected(plaintext.size()), data(plaintext.size());
+        tenants[0].encryptBlocks(plaintext.data(), expected.data(), blocks);
+        const RC6Schedule single(tenants[0]);
+        single.encryptBlocks(plaintext.data(), data.data(), blocks);
+        broadcast = broadcast && single.lanes() == RC6::bulkLanes() && data == expected;
+        single.decryptBlocks(data.data(), blocks);
+        broadcast = broadcast && data == plaintext;
+
+        // One key per lane, and half as many keys repeated across the lanes
+        for (size_t count = single.lanes(); count >= single.lanes() / 2 && count > 0; count /= 2) {
+            for (size_t i = 0; i < blocks; ++i) {
+                tenants[i % count].encryptBlocks(&plaintext[16 * i], &expected[16 * i], 1);
+            }
+            const RC6Schedule schedule(tenantPointers, count);
+            schedule.encryptBlocks(plaintext.data(), data.data(), blocks);
+            many = many && data == expected;
+            schedule.decryptBlocks(data.data(), blocks);
+            many = many && data == plaintext;
+        }
+    }
+    RC6Backend::reset();
+    if (pinned) {
+        RC6Backend::force(pinnedName);
+    }
+    std::cout << "Broadcast layout:        " << verdict(broadcast) << std::endl;
+    std::cout << "Layout per lane:         " << verdict(many) << std::endl;
+
+    RC6Schedule schedule(tenants[1]);
+    RC6Schedule moved(std::move(schedule));
+    std::vector<uint8_t> expected(plaintext.size()), data(plaintext.size());
+    tenants[1].encryptBlocks(plaintext.data(), expected.data(), blocks);
+    moved.encryptBlocks(plaintext.data(), data.data(), blocks);
+    bool moveSemantics = data == expected && !schedule.isInitialized();
+    schedule = std::move(moved);
+    moveSemantics = moveSemantics && schedule.isInitialized() && !moved.isInitialized();
+    schedule.clear();
+    moveSemantics = moveSemantics && !schedule.isInitialized();
+    std::cout << "Move and clear:          " << verdict(moveSemantics) << std::endl;
+
+    size_t rejected = 0;
+    try {
+        schedule.encryptBlocks(data.data(), 1);
+    } catch (const std::runtime_error &) {
+        ++rejected;
+    }
+    try {
+        const RC6Schedule uneven(tenantPointers, 3);
+    } catch (const std::invalid_argument &) {
+        ++rejected;
+    }
+    RC6 shortCipher(12);
+    shortCipher.init(key, keyLengthBits);
+    const RC6 *mixed[2] = {&tenants[0], &shortCipher};
+    try {
+        const RC6Schedule mixedRounds(mixed, 2);
+    } catch (const std::invalid_argument &) {
+        ++rejected;
+    }
+    RC6 unkeyed;
+    try {
+        const RC6Schedule empty(unkeyed);
+    } catch (const std::runtime_error &) {
+        ++rejected;
+    }
+    std::cout << "Invalid arguments:       " << verdict(rejected == 4) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Check one RC6-w/r/b instance against a vector with key and plaintext bytes 00 01 02 ...
+template<typename Cipher>
+bool checkGenericVector(const size_t keyBytes, const uint8_t *expected) {
+    uint8_t key[32], block[Cipher::BLOCK_SIZE];
+    for (size_t i = 0; i < keyBytes; ++i) {
+        key[i] = static_cast<uint8_t>(i);
+    }
+    for (size_t i = 0; i < Cipher::BLOCK_SIZE; ++i) {
+        block[i] = static_cast<uint8_t>(i);
+    }
+
+    Cipher cipher;
+    cipher.init(key, static_cast<uint16_t>(8 * keyBytes));
+    cipher.encrypt(block);
+    bool match = std::memcmp(block, expected, Cipher::BLOCK_SIZE) == 0;
+    cipher.decrypt(block);
+    for (size_t i = 0; i < Cipher::BLOCK_SIZE; ++i) {
+        match = match && block[i] == i;
+    }
+    return match;
+}
+
+// Check that bulk calls of an RC6-w/r/b instance match single blocks and invert
+template<typename Cipher>
+bool checkGenericBulk(const uint8_t *key, const uint16_t keyLengthBits) {
+    Cipher cipher;
+    cipher.init(key, keyLengthBits);
+
+    const size_t blocks = 7;
+    std::vector<uint8_t> plaintext(blocks * Cipher::BLOCK_SIZE);
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 3 + 7);
+    }
+    std::vector<uint8_t> expected(plaintext);
+    for (size_t n = 0; n < blocks; ++n) {
+        cipher.encrypt(&expected[n * Cipher::BLOCK_SIZE]);
+    }
+
+    std::vector<uint8_t> data(plaintext.size());
+    cipher.encryptBlocks(plaintext.data(), data.data(), blocks);
+    bool match = data == expected && data != plaintext;
+    cipher.decryptBlocks(data.data(), blocks);
+    match = match && data == plaintext;
+
+    Cipher moved(std::move(cipher));
+    moved.encryptBlocks(data.data(), blocks);
+    match = match && data == expected && !cipher.isInitialized();
+    return match;
+}
+
+// Function to check the RC6-w/r/b template
+void runGenericTest(const uint8_t *key, const uint16_t keyLengthBits, const uint8_t *plaintext) {
+    std::cout << "RC6-w/r/b template" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    // Vectors from the RC6 paper's family of parameters (draft-krovetz-rc6-rc5-vectors)
+    const uint8_t expected16[8] = {0x2f, 0xf0, 0xb6, 0x8e, 0xae, 0xff, 0xad, 0x5b};
+    const uint8_t expected32[16] = {
+        0x3a, 0x96, 0xf9, 0xc7, 0xf6, 0x75, 0x5c, 0xfe, 0x46, 0xf0, 0x0e, 0x3d, 0xcd, 0x5d, 0x2a, 0x3c
+    };
+    const uint8_t expected64[32] = {
+        0xc0, 0x02, 0xde, 0x05, 0x0b, 0xd5, 0x5e, 0x5d, 0x36, 0x86, 0x4a, 0xb9, 0x85, 0x33, 0x38, 0xe6,
+        0xdc, 0x4a, 0x13, 0x26, 0xc6, 0xbd, 0xaa, 0xeb, 0x1b, 0xc9, 0xe4, 0xfd, 0x67, 0x88, 0x66, 0x17
+    };
+    std::cout << "RC6-16/16/8:             "
+            << verdict(checkGenericVector<RC6T<uint16_t, 16> >(8, expected16)) << std::endl;
+    std::cout << "RC6-32/20/16:            "
+            << verdict(checkGenericVector<RC6T<uint32_t, 20> >(16, expected32)) << std::endl;
+    std::cout << "RC6-64/24/24:            "
+            << verdict(checkGenericVector<RC6T<uint64_t, 24> >(24, expected64)) << std::endl;
+
+    // 32-bit words compute the RC6 class's function for any round count
+    bool same = true;
+    uint8_t expected[16], actual[16];
+    RC6 rc6;
+    rc6.init(key, keyLengthBits);
+    RC6T<uint32_t> generic;
+    generic.init(key, keyLengthBits);
+    std::memcpy(expected, plaintext, 16);
+    std::memcpy(actual, plaintext, 16);
+    rc6.encrypt(expected);
+    generic.encrypt(actual);
+    same = same && std::memcmp(expected, actual, 16) == 0;
+    RC6 rc6_12(12);
+    rc6_12.init(key, keyLengthBits - 3);
+    RC6T<uint32_t, 12> generic12;
+    generic12.init(key, keyLengthBits - 3);
+    rc6_12.encrypt(expected);
+    generic12.encrypt(actual);
+    same = same && std::memcmp(expected, actual, 16) == 0;
+    std::cout << "Matches RC6 (w = 32):    " << verdict(same) << std::endl;
+
+    const bool bulk = checkGenericBulk<RC6T<uint16_t, 16> >(key, keyLengthBits) &&
+                      checkGenericBulk<RC6T<uint32_t, 20> >(key, keyLengthBits) &&
+                      checkGenericBulk<RC6T<uint64_t, 24> >(key, keyLengthBits);
+    std::cout << "Bulk and move:           " << verdict(bulk) << std::endl;
+
+    bool rejected = false;
+    try {
+        RC6T<uint64_t> unkeyed;
+        unkeyed.encrypt(actual);
+    } catch (const std::runtime_error &) {
+        try {
+            generic.init(nullptr, 128);
+        } catch (const std::invalid_argument &) {
+            rejected = true;
+        }
+    }
+    std::cout << "Invalid arguments:       " << verdict(rejected) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check the usage counters, or that they stay zero when compiled out
+void runStatsTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "Usage counters (" << (RC6Stats::enabled() ? "enabled" : "disabled") << ")" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6Stats::reset();
+
+    RC6 rc6;
+    rc6.init(key, keyLengthBits);
+    std::vector<uint8_t> data(37 * 16, 0x3c);
+    rc6.encryptBlocks(data.data(), 37);
+    rc6.decryptBlocks(data.data(), 3);
+
+    RC6 many[3];
+    const void *keys[3] = {key, key, key};
+    RC6::initMany(many, keys, keyLengthBits, 3);
+
+    // Counters of an exited thread are kept
+    std::thread worker([&] {
+        uint8_t block[16] = {0};
+        rc6.encryptBlocks(block, 1);
+    });
+    worker.join();
+
+    const RC6Stats stats = RC6Stats::snapshot();
+    uint64_t backendTotal = 0;
+    for (const auto &entry: stats.blocks_by_backend) {
+        backendTotal += entry.second;
+    }
+
+    bool counted;
+    if (RC6Stats::enabled()) {
+        counted = stats.keys_expanded == 4 && stats.encrypt_calls == 2 && stats.encrypt_blocks == 38 &&
+                  stats.decrypt_calls == 1 && stats.decrypt_blocks == 3 && stats.calls_by_blocks[0] == 1 &&
+                  stats.calls_by_blocks[1] == 1 && stats.calls_by_blocks[5] == 1 && backendTotal == 41;
+    } else {
+        counted = stats.keys_expanded == 0 && stats.encrypt_calls == 0 && stats.decrypt_calls == 0 &&
+                  backendTotal == 0;
+    }
+    std::cout << "Snapshot:                " << verdict(counted) << std::endl;
+
+    RC6Stats::reset();
+    const RC6Stats cleared = RC6Stats::snapshot();
+    const bool reset = cleared.keys_expanded == 0 && cleared.encrypt_blocks == 0 && cleared.blocks_by_backend.empty();
+    std::cout << "Reset:                   " << verdict(reset) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check that moving a cipher transfers the key schedule
+void runMoveTest(const uint8_t *key, const uint16_t keyLengthBits, const uint8_t *plaintext) {
+    std::cout << "Move semantics" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 original;
+    original.init(key, keyLengthBits);
+    uint8_t expected[16];
+    std::memcpy(expected, plaintext, 16);
+    original.encrypt(expected);
+
+    RC6 moved(std::move(original));
+    RC6 assigned(12);
+    assigned = std::move(moved);
+
+    uint8_t ciphertext[16];
+    std::memcpy(ciphertext, plaintext, 16);
+    assigned.encrypt(ciphertext);
+
+    const bool match = (std::memcmp(ciphertext, expected, 16) == 0) &&
+                       !original.isInitialized() && !moved.isInitialized();
+    std::cout << "Move construct/assign:   " << verdict(match) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to count non-zero bytes of an object's storage
+size_t nonZeroBytes(const void *storage, const size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(storage);
+    return static_cast<size_t>(std::count_if(bytes, bytes + size, [](const uint8_t b) { return b != 0; }));
+}
+
+// Function to check that key material is wiped and the locked pool hands out working ciphers
+void runWipeTest(const uint8_t *key, const uint16_t keyLengthBits, const uint8_t *plaintext) {
+    std::cout << "Key wiping" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    // Only the rounds and state flag bytes may survive in the storage of a destroyed or moved-from object
+    alignas(RC6) uint8_t storage[sizeof(RC6)];
+    std::memset(storage, 0, sizeof(storage));
+    RC6 *destroyed = new(storage) RC6();
+    destroyed->init(key, keyLengthBits);
+    destroyed->~RC6();
+    const bool destroyWiped = nonZeroBytes(storage, sizeof(storage)) <= 2;
+
+    std::memset(storage, 0, sizeof(storage));
+    RC6 *source = new(storage) RC6();
+    source->init(key, keyLengthBits);
+    RC6 target(std::move(*source));
+    const bool moveWiped = nonZeroBytes(storage, sizeof(storage)) <= 2;
+    source->~RC6();
+
+    RC6 cleared;
+    cleared.init(key, keyLengthBits);
+    cleared.clear();
+    uint8_t block[16];
+    const bool clearWiped = !cleared.isInitialized() &&
+                            cleared.tryEncryptBlocks(block, block, 1) == RC6Status::NotInitialized;
+    std::cout << "Destroy, move and clear: "
+              << verdict(destroyWiped && moveWiped && clearWiped) << std::endl;
+
+    uint8_t expected[16];
+    std::memcpy(expected, plaintext, 16);
+    target.encrypt(expected);
+
+    // More objects than one slab, released and created again from the free list
+    RC6SecurePool pool(64);
+    std::vector<RC6SecurePool::Handle> handles;
+    bool poolMatch = true;
+    for (int round = 0; round < 2; ++round) {
+        for (size_t i = 0; i < 200; ++i) {
+            handles.push_back(pool.create(key, keyLengthBits));
+        }
+        for (const auto &handle: handles) {
+            std::memcpy(block, plaintext, 16);
+            handle->encrypt(block);
+            poolMatch = poolMatch && std::memcmp(block, expected, 16) == 0;
+        }
+        poolMatch = poolMatch && pool.size() == 200;
+        handles.clear();
+        poolMatch = poolMatch && pool.size() == 0;
+    }
+    const size_t capacity = pool.capacity();
+    poolMatch = poolMatch && capacity >= 200 && capacity < 400;
+    std::cout << "Secure pool:             " << verdict(poolMatch) << std::endl;
+    std::cout << "Pool pages locked:       " << (pool.isLocked() ? "yes" : "no (memlock limit)") << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check batch key setup against one init() per key
+void runInitManyTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "Batch key setup" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    const size_t count = 37;
+    const size_t keyBytes = (keyLengthBits + 7) / 8;
+    std::vector<uint8_t> keys(count * keyBytes);
+    std::vector<const void *> keyPointers(count);
+    std::vector<RC6> batch;
+    batch.reserve(count);
+    for (size_t k = 0; k < count; ++k) {
+        for (size_t i = 0; i < keyBytes; ++i) {
+            keys[k * keyBytes + i] = static_cast<uint8_t>(key[i % 16] ^ (k * 29 + i));
+        }
+        keyPointers[k] = &keys[k * keyBytes];
+        // Mix round counts so that runs of different schedule sizes are grouped
+        batch.emplace_back(static_cast<uint8_t>(k % 11 < 8 ? 20 : 12));
+    }
+
+    RC6::initMany(batch.data(), keyPointers.data(), keyLengthBits, count);
+
+    bool match = true;
+    for (size_t k = 0; k < count; ++k) {
+        RC6 single(static_cast<uint8_t>(k % 11 < 8 ? 20 : 12));
+        single.init(keyPointers[k], keyLengthBits);
+
+        uint8_t expected[16], actual[16];
+        for (size_t i = 0; i < 16; ++i) {
+            expected[i] = actual[i] = static_cast<uint8_t>(k + i);
+        }
+        single.encrypt(expected);
+        batch[k].encrypt(actual);
+        match = match && batch[k].isInitialized() && std::memcmp(expected, actual, 16) == 0;
+    }
+    std::cout << "initMany (" << keyLengthBits << "-bit keys):  " << verdict(match) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check the unchecked and status-code entry points
+void runNoThrowTest(const uint8_t *key, const uint16_t keyLengthBits, const uint8_t *plaintext) {
+    std::cout << "Non-throwing entry points" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 checked;
+    checked.init(key, keyLengthBits);
+    uint8_t expected[64];
+    for (size_t i = 0; i < sizeof(expected); ++i) {
+        expected[i] = plaintext[i % 16];
+    }
+    checked.encryptBlocks(expected, 4);
+
+    RC6 rc6;
+    uint8_t blocks[64];
+    std::memcpy(blocks, expected, sizeof(blocks));
+    const bool statusMatch = rc6.tryEncryptBlocks(blocks, blocks, 4) == RC6Status::NotInitialized &&
+                             rc6.tryInit(nullptr, keyLengthBits) == RC6Status::NullPointer &&
+                             rc6.tryInit(key, 0) == RC6Status::InvalidKeyLength &&
+                             rc6.tryInit(key, RC6::MAX_KEY_BITS + 1) == RC6Status::InvalidKeyLength &&
+                             !rc6.isInitialized() &&
+                             rc6.tryInit(key, keyLengthBits) == RC6Status::Ok &&
+                             rc6.tryEncryptBlocks(nullptr, blocks, 4) == RC6Status::NullPointer &&
+                             rc6.tryEncryptBlocks(nullptr, nullptr, 0) == RC6Status::Ok;
+    std::cout << "Status codes:            " << verdict(statusMatch) << std::endl;
+
+    for (size_t i = 0; i < sizeof(blocks); ++i) {
+        blocks[i] = plaintext[i % 16];
+    }
+    rc6.encryptUnchecked(blocks);
+    rc6.encryptUnchecked(blocks + 16);
+    rc6.encryptBlocksUnchecked(blocks + 32, blocks + 32, 2);
+    bool match = std::memcmp(blocks, expected, sizeof(blocks)) == 0;
+    rc6.decryptUnchecked(blocks);
+    match = match && rc6.tryDecryptBlocks(blocks + 16, blocks + 16, 3) == RC6Status::Ok;
+    for (size_t i = 0; i < sizeof(blocks); ++i) {
+        match = match && blocks[i] == plaintext[i % 16];
+    }
+    std::cout << "Unchecked transforms:    " << verdict(match) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check counter mode against a block-by-block construction
+void runCtrTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "CTR mode" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 rc6;
+    rc6.init(key, keyLengthBits);
+
+    // Counter field is the last 4 bytes and starts just below a carry
+    const uint8_t iv[16] = {
+        0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+        0xf8, 0xf9, 0xfa, 0xfb, 0x00, 0x00, 0x00, 0xfe
+    };
+    const size_t length = 16 * 150 + 5;
+    std::vector<uint8_t> plaintext(length);
+    for (size_t i = 0; i < length; ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 13 + 1);
+    }
+
+    // Reference: encrypt each counter block individually
+    std::vector<uint8_t> expected(length);
+    uint8_t counter[16];
+    std::memcpy(counter, iv, 16);
+    for (size_t offset = 0; offset < length; offset += 16) {
+        uint8_t keystream[16];
+        std::memcpy(keystream, counter, 16);
+        rc6.encrypt(keystream);
+        for (size_t i = 0; i < 16 && offset + i < length; ++i) {
+            expected[offset + i] = plaintext[offset + i] ^ keystream[i];
+        }
+        for (size_t i = 16; i-- > 12;) {
+            if (++counter[i] != 0) {
+                break;
+            }
+        }
+    }
+
+    RC6CTR ctr(rc6, iv, 4);
+    std::vector<uint8_t> ciphertext(length);
+    ctr.process(plaintext.data(), ciphertext.data(), length);
+    const bool oneShotMatch = (ciphertext == expected);
+    std::cout << "One-shot encryption:     " << verdict(oneShotMatch) << std::endl;
+
+    // Odd-sized chunks must produce the same stream
+    RC6CTR chunked(rc6, iv, 4);
+    std::vector<uint8_t> pieces(plaintext);
+    for (size_t offset = 0, step = 1; offset < length; offset += step, step = step * 3 + 1) {
+        const size_t chunk = std::min(step, length - offset);
+        chunked.process(&pieces[offset], &pieces[offset], chunk);
+    }
+    const bool chunkedMatch = (pieces == expected);
+    std::cout << "Chunked encryption:      " << verdict(chunkedMatch) << std::endl;
+
+    // Decrypt a slice starting in the middle of a block
+    const size_t sliceStart = 16 * 70 + 9;
+    const size_t sliceLength = 300;
+    std::vector<uint8_t> slice(sliceLength);
+    ctr.seek(sliceStart);
+    ctr.process(&ciphertext[sliceStart], slice.data(), sliceLength);
+    const bool seekMatch = std::equal(slice.begin(), slice.end(), plaintext.begin() + sliceStart);
+    std::cout << "Seek and decrypt:        " << verdict(seekMatch) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to encrypt or decrypt a whole message through a stream context in uneven chunks
+std::vector<uint8_t> streamChunked(const RC6 &rc6, const RC6Stream::Mode mode,
+                                   const RC6Stream::Direction direction,
+                                   const uint8_t *iv, const std::vector<uint8_t> &input) {
+    RC6Stream stream(rc6, mode, direction, iv);
+    std::vector<uint8_t> output(input.size() + 2 * RC6Stream::BLOCK_SIZE);
+    size_t produced = 0;
+    for (size_t offset = 0, step = 1; offset < input.size(); offset += step, step = step * 2 + 3) {
+        const size_t chunk = std::min(step, input.size() - offset);
+        produced += stream.update(&input[offset], chunk, &output[produced]);
+    }
+    produced += stream.final(&output[produced]);
+    output.resize(produced);
+    return output;
+}
+
+// Function to run a whole message through a stream context from and into uneven segments
+std::vector<uint8_t> streamSegmented(const RC6 &rc6, const RC6Stream::Mode mode,
+                                     const RC6Stream::Direction direction,
+                                     const uint8_t *iv, const std::vector<uint8_t> &input, const bool inPlace) {
+    RC6Stream stream(rc6, mode, direction, iv);
+    std::vector<uint8_t> output(input.size() + 2 * RC6Stream::BLOCK_SIZE);
+
+    // Input and output boundaries fall at different places, with empty segments mixed in
+    std::vector<RC6Stream::ConstSegment> in;
+    for (size_t offset = 0, step = 0; offset < input.size(); offset += step, step = (step * 7 + 5) % 97) {
+        step = std::min(step, input.size() - offset);
+        in.push_back(RC6Stream::ConstSegment{&input[offset], step});
+    }
+    std::vector<RC6Stream::Segment> out;
+    for (size_t offset = 0, step = 3; offset < output.size(); offset += step, step = (step * 5 + 1) % 71) {
+        step = std::min(step, output.size() - offset);
+        out.push_back(RC6Stream::Segment{&output[offset], step});
+    }
+
+    size_t produced;
+    if (inPlace) {
+        std::copy(input.begin(), input.end(), output.begin());
+        std::vector<RC6Stream::Segment> segments;
+        for (const auto &segment: in) {
+            segments.push_back(RC6Stream::Segment{&output[static_cast<const uint8_t *>(segment.data) - &input[0]],
+                                                  segment.len});
+        }
+        stream.update(segments.data(), segments.size());
+        produced = input.size();
+    } else {
+        produced = stream.update(in.data(), in.size(), out.data(), out.size());
+    }
+    produced += stream.final(&output[produced]);
+    output.resize(produced);
+    return output;
+}
+
+// Function to check the stream context against block-by-block constructions
+void runStreamTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "Stream context" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 rc6;
+    rc6.init(key, keyLengthBits);
+
+    const uint8_t iv[16] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+    };
+    const size_t length = 16 * 90 + 11;
+    std::vector<uint8_t> plaintext(length);
+    for (size_t i = 0; i < length; ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 29 + 5);
+    }
+
+    // CBC reference with PKCS#7 padding
+    std::vector<uint8_t> padded(plaintext);
+    padded.resize(16 * (length / 16 + 1), static_cast<uint8_t>(16 - length % 16));
+    std::vector<uint8_t> cbc(padded);
+    uint8_t chain[16];
+    std::memcpy(chain, iv, 16);
+    for (size_t offset = 0; offset < cbc.size(); offset += 16) {
+        for (size_t i = 0; i < 16; ++i) {
+            cbc[offset + i] ^= chain[i];
+        }
+        rc6.encrypt(&cbc[offset]);
+        std::memcpy(chain, &cbc[offset], 16);
+    }
+
+    // CFB and OFB references
+    std::vector<uint8_t> cfb(length), ofb(length);
+    uint8_t cfbRegister[16], ofbRegister[16];
+    std::memcpy(cfbRegister, iv, 16);
+    std::memcpy(ofbRegister, iv, 16);
+    for (size_t offset = 0; offset < length; offset += 16) {
+        uint8_t keystream[16];
+        std::memcpy(keystream, cfbRegister, 16);
+        rc6.encrypt(keystream);
+        rc6.encrypt(ofbRegister);
+        for (size_t i = 0; i < 16 && offset + i < length; ++i) {
+            cfb[offset + i] = plaintext[offset + i] ^ keystream[i];
+            ofb[offset + i] = plaintext[offset + i] ^ ofbRegister[i];
+        }
+        if (offset + 16 <= length) {
+            std::memcpy(cfbRegister, &cfb[offset], 16);
+        }
+    }
+
+    std::vector<uint8_t> ctr(length);
+    RC6CTR(rc6, iv).process(plaintext.data(), ctr.data(), length);
+
+    const struct {
+        const char *name;
+        RC6Stream::Mode mode;
+        const std::vector<uint8_t> &expected;
+    } cases[] = {
+        {"CBC", RC6Stream::Mode::CBC, cbc},
+        {"CTR", RC6Stream::Mode::CTR, ctr},
+        {"CFB", RC6Stream::Mode::CFB, cfb},
+        {"OFB", RC6Stream::Mode::OFB, ofb},
+    };
+
+    for (const auto &c: cases) {
+        const std::vector<uint8_t> ciphertext =
+                streamChunked(rc6, c.mode, RC6Stream::Direction::Encrypt, iv, plaintext);
+        const std::vector<uint8_t> decrypted =
+                streamChunked(rc6, c.mode, RC6Stream::Direction::Decrypt, iv, ciphertext);
+        const bool match = (ciphertext == c.expected) && (decrypted == plaintext);
+        std::cout << c.name << " chunked round trip:   " << verdict(match) << std::endl;
+
+        const bool inPlace = c.mode != RC6Stream::Mode::CBC;
+        const bool segmentedMatch =
+                streamSegmented(rc6, c.mode, RC6Stream::Direction::Encrypt, iv, plaintext, false) == c.expected &&
+                streamSegmented(rc6, c.mode, RC6Stream::Direction::Decrypt, iv, ciphertext, false) == plaintext &&
+                (!inPlace ||
+                 streamSegmented(rc6, c.mode, RC6Stream::Direction::Decrypt, iv, ciphertext, true) == plaintext);
+        std::cout << c.name << " scatter/gather:       " << verdict(segmentedMatch) << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+// Function to check CBC mode, including multi-buffer encryption
+void runCbcTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "CBC mode" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 rc6;
+    rc6.init(key, keyLengthBits);
+    const RC6CBC cbc(rc6);
+
+    const uint8_t iv[16] = {
+        0x0f, 0x1e, 0x2d, 0x3c, 0x4b, 0x5a, 0x69, 0x78,
+        0x87, 0x96, 0xa5, 0xb4, 0xc3, 0xd2, 0xe1, 0xf0
+    };
+    const size_t blocks = 150;
+    std::vector<uint8_t> plaintext(blocks * 16);
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 13 + 5);
+    }
+
+    // Reference built from single-block encryption
+    std::vector<uint8_t> expected(plaintext);
+    uint8_t chain[16];
+    std::memcpy(chain, iv, 16);
+    for (size_t n = 0; n < blocks; ++n) {
+        for (size_t i = 0; i < 16; ++i) {
+            expected[16 * n + i] ^= chain[i];
+        }
+        rc6.encrypt(&expected[16 * n]);
+        std::memcpy(chain, &expected[16 * n], 16);
+    }
+
+    // Two calls continue the same message through the chaining value
+    std::vector<uint8_t> actual(plaintext.size());
+    std::memcpy(chain, iv, 16);
+    cbc.encrypt(chain, plaintext.data(), actual.data(), 7);
+    cbc.encrypt(chain, &plaintext[16 * 7], &actual[16 * 7], blocks - 7);
+    const bool encryptMatch = (actual == expected) && std::memcmp(chain, &expected[16 * (blocks - 1)], 16) == 0;
+    std::cout << "Encryption:              " << verdict(encryptMatch) << std::endl;
+
+    std::vector<uint8_t> decrypted(plaintext.size());
+    std::memcpy(chain, iv, 16);
+    cbc.decrypt(chain, expected.data(), decrypted.data(), blocks);
+    std::memcpy(chain, iv, 16);
+    cbc.decrypt(chain, actual.data(), actual.data(), 100);
+    cbc.decrypt(chain, &actual[16 * 100], &actual[16 * 100], blocks - 100);
+    const bool decryptMatch = (decrypted == plaintext) && (actual == plaintext);
+    std::cout << "Decryption:              " << verdict(decryptMatch) << std::endl;
+
+    // Messages of different lengths, more than one group, some in place
+    const size_t count = 70;
+    std::vector<RC6CBC::Message> messages(count);
+    std::vector<std::vector<uint8_t> > outputs(count);
+    std::vector<std::vector<uint8_t> > references(count);
+    for (size_t k = 0; k < count; ++k) {
+        const size_t length = (k * 7) % 11;
+        references[k].assign(plaintext.begin() + 16 * k, plaintext.begin() + 16 * (k + length));
+        outputs[k] = references[k];
+        uint8_t messageIv[16];
+        for (size_t i = 0; i < 16; ++i) {
+            messageIv[i] = static_cast<uint8_t>(iv[i] + k);
+        }
+        cbc.encrypt(messageIv, references[k].data(), references[k].data(), length);
+
+        messages[k].in = outputs[k].data();
+        messages[k].out = outputs[k].data();
+        messages[k].nblocks = length;
+        for (size_t i = 0; i < 16; ++i) {
+            messages[k].iv[i] = static_cast<uint8_t>(iv[i] + k);
+        }
+    }
+    cbc.encryptMany(messages.data(), count);
+    bool manyMatch = true;
+    for (size_t k = 0; k < count; ++k) {
+        manyMatch = manyMatch && outputs[k] == references[k] &&
+                    (references[k].empty() || std::memcmp(messages[k].iv, &references[k][references[k].size() - 16], 16) == 0);
+    }
+    std::cout << "Multi-buffer encryption: " << verdict(manyMatch) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check OCB authenticated encryption
+void runOcbTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "OCB mode" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 rc6;
+    rc6.init(key, keyLengthBits);
+    const RC6OCB ocb(rc6);
+
+    const uint8_t nonce[12] = {0xbb, 0xaa, 0x99, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00};
+    std::vector<uint8_t> ad(40);
+    for (size_t i = 0; i < ad.size(); ++i) {
+        ad[i] = static_cast<uint8_t>(i);
+    }
+
+    // Lengths around the block size and the bulk batch size
+    bool roundTrip = true;
+    const size_t lengths[] = {0, 1, 15, 16, 17, 100, 1024, 1031, 16 * 64 + 16 * 3 + 5};
+    for (const size_t length: lengths) {
+        std::vector<uint8_t> plaintext(length), ciphertext(length), decrypted(length);
+        for (size_t i = 0; i < length; ++i) {
+            plaintext[i] = static_cast<uint8_t>(i * 3 + 1);
+        }
+        uint8_t tag[16];
+        ocb.encrypt(nonce, sizeof(nonce), ad.data(), length % ad.size(), plaintext.data(), length,
+                    ciphertext.data(), tag);
+
+        std::vector<uint8_t> inPlace(plaintext);
+        uint8_t inPlaceTag[16];
+        ocb.encrypt(nonce, sizeof(nonce), ad.data(), length % ad.size(), inPlace.data(), length,
+                    inPlace.data(), inPlaceTag);
+
+        roundTrip = roundTrip && inPlace == ciphertext && std::memcmp(tag, inPlaceTag, 16) == 0 &&
+                    ocb.decrypt(nonce, sizeof(nonce), ad.data(), length % ad.size(), ciphertext.data(), length,
+                                decrypted.data(), tag) &&
+                    decrypted == plaintext;
+    }
+    std::cout << "Round trip:              " << verdict(roundTrip) << std::endl;
+
+    // Any change to the ciphertext, associated data, nonce or tag is rejected
+    std::vector<uint8_t> plaintext(100, 0x42), ciphertext(100), decrypted(100);
+    uint8_t tag[16];
+    ocb.encrypt(nonce, sizeof(nonce), ad.data(), ad.size(), plaintext.data(), plaintext.size(),
+                ciphertext.data(), tag);
+
+    std::vector<uint8_t> tampered(ciphertext);
+    tampered[99] ^= 0x01;
+    bool rejected = !ocb.decrypt(nonce, sizeof(nonce), ad.data(), ad.size(), tampered.data(), tampered.size(),
+                                 decrypted.data(), tag) &&
+                    std::all_of(decrypted.begin(), decrypted.end(), [](const uint8_t b) { return b == 0; });
+    ad[0] ^= 0x01;
+    rejected = rejected && !ocb.decrypt(nonce, sizeof(nonce), ad.data(), ad.size(), ciphertext.data(),
+                                        ciphertext.size(), decrypted.data(), tag);
+    ad[0] ^= 0x01;
+    rejected = rejected && !ocb.decrypt(nonce, sizeof(nonce) - 1, ad.data(), ad.size(), ciphertext.data(),
+                                        ciphertext.size(), decrypted.data(), tag);
+    tag[15] ^= 0x80;
+    rejected = rejected && !ocb.decrypt(nonce, sizeof(nonce), ad.data(), ad.size(), ciphertext.data(),
+                                        ciphertext.size(), decrypted.data(), tag);
+
+    // A shorter tag is not a prefix of the full one, since the tag length is bound into the nonce
+    const RC6OCB shortTag(rc6, 8);
+    uint8_t tag8[8];
+    shortTag.encrypt(nonce, sizeof(nonce), ad.data(), ad.size(), plaintext.data(), plaintext.size(),
+                     decrypted.data(), tag8);
+    rejected = rejected && std::memcmp(tag8, tag, 8) != 0 &&
+               shortTag.decrypt(nonce, sizeof(nonce), ad.data(), ad.size(), decrypted.data(), decrypted.size(),
+                                decrypted.data(), tag8) &&
+               decrypted == plaintext;
+    std::cout << "Authentication:          " << verdict(rejected) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check XTS data units, ciphertext stealing and the sector APIs
+void runXtsTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "XTS mode" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    uint8_t xtsKey[64];
+    for (size_t i = 0; i < 2 * keyLengthBits / 8u; ++i) {
+        xtsKey[i] = static_cast<uint8_t>(key[i % (keyLengthBits / 8)] + (i >= keyLengthBits / 8u ? 0x5a : 0));
+    }
+    const RC6XTS xts(xtsKey, static_cast<uint16_t>(2 * keyLengthBits));
+
+    uint8_t tweak[16];
+    for (size_t i = 0; i < sizeof(tweak); ++i) {
+        tweak[i] = static_cast<uint8_t>(0xf0 + i);
+    }
+
+    // Whole blocks, stolen tails and a unit spanning several bulk batches, in place
+    bool roundTrip = true;
+    bool stealing = true;
+    for (const size_t len: {16, 17, 31, 32, 47, 512, 4096 + 5}) {
+        std::vector<uint8_t> plain(len), data(len);
+        for (size_t i = 0; i < len; ++i) {
+            plain[i] = static_cast<uint8_t>(i * 13 + len);
+        }
+        data = plain;
+        xts.encrypt(tweak, data.data(), data.data(), len);
+        roundTrip = roundTrip && data != plain;
+
+        // The stolen tail must not change the whole-block prefix before the last full block
+        if (len % 16 != 0 && len > 32) {
+            std::vector<uint8_t> prefix(len - len % 16 - 16);
+            xts.encrypt(tweak, plain.data(), prefix.data(), prefix.size());
+            stealing = stealing && std::equal(prefix.begin(), prefix.end(), data.begin());
+        }
+
+        xts.decrypt(tweak, data.data(), data.data(), len);
+        roundTrip = roundTrip && data == plain;
+    }
+    std::cout << "Round trip:              " << verdict(roundTrip) << std::endl;
+    std::cout << "Ciphertext stealing:     " << verdict(stealing) << std::endl;
+
+    // Sector batches against one call per sector with little-endian sector tweaks
+    bool sectors = true;
+    for (const size_t sectorSize: {size_t(16), size_t(512), size_t(520)}) {
+        const size_t count = 70;
+        const uint64_t firstSector = 0x1fffffffeULL;
+        std::vector<uint8_t> plain(sectorSize * count), batched(plain.size()), expected(plain.size());
+        for (size_t i = 0; i < plain.size(); ++i) {
+            plain[i] = static_cast<uint8_t>(i * 5 + 1);
+        }
+
+        xts.encryptSectors(firstSector, plain.data(), batched.data(), sectorSize, count);
+        for (size_t n = 0; n < count; ++n) {
+            uint8_t sectorTweak[16] = {0};
+            for (size_t b = 0; b < 8; ++b) {
+                sectorTweak[b] = static_cast<uint8_t>((firstSector + n) >> (8 * b));
+            }
+            xts.encrypt(sectorTweak, &plain[sectorSize * n], &expected[sectorSize * n], sectorSize);
+        }
+        sectors = sectors && batched == expected;
+
+        xts.decryptSectors(firstSector, batched.data(), batched.data(), sectorSize, count);
+        sectors = sectors && batched == plain;
+    }
+    std::cout << "Sector batches:          " << verdict(sectors) << std::endl;
+
+    bool rejected = false;
+    uint8_t sameHalves[32] = {0};
+    try {
+        RC6XTS weak(sameHalves, 256);
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    try {
+        xts.encrypt(tweak, sameHalves, sameHalves, 15);
+        rejected = false;
+    } catch (const std::invalid_argument &) {
+    }
+    std::cout << "Invalid input:           " << verdict(rejected) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check batched CTR jobs against one RC6CTR per message
+void runBatchTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "Batch jobs" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    std::vector<RC6> ciphers(3);
+    for (size_t k = 0; k < ciphers.size(); ++k) {
+        uint8_t tenantKey[32];
+        std::memcpy(tenantKey, key, keyLengthBits / 8);
+        tenantKey[0] ^= static_cast<uint8_t>(k);
+        ciphers[k].init(tenantKey, keyLengthBits);
+    }
+
+    // Runs of jobs per key, including empty jobs and jobs spanning several kernel calls
+    const size_t lengths[] = {16, 1, 0, 64, 17, 2000, 15, 48, 0, 33, 1030, 64, 5};
+    const size_t keyOf[] = {0, 0, 0, 1, 1, 1, 0, 2, 2, 2, 2, 1, 1};
+    const size_t jobCount = sizeof(lengths) / sizeof(lengths[0]);
+
+    std::vector<std::vector<uint8_t> > inputs(jobCount), outputs(jobCount), expected(jobCount);
+    std::vector<RC6Batch::Job> jobs(jobCount);
+    for (size_t i = 0; i < jobCount; ++i) {
+        inputs[i].resize(lengths[i]);
+        for (size_t b = 0; b < lengths[i]; ++b) {
+            inputs[i][b] = static_cast<uint8_t>(b * 7 + i);
+        }
+        outputs[i] = inputs[i];
+        expected[i].resize(lengths[i]);
+
+        RC6Batch::Job &job = jobs[i];
+        job.cipher = &ciphers[keyOf[i]];
+        std::memset(job.iv, static_cast<int>(i), 16);
+        job.iv[15] = 0xfe; // counter carries into the upper bytes
+        job.iv[14] = 0xff;
+        // Every other job in place
+        job.in = i % 2 ? inputs[i].data() : outputs[i].data();
+        job.out = outputs[i].data();
+        job.len = lengths[i];
+
+        RC6CTR(*job.cipher, job.iv).process(inputs[i].data(), expected[i].data(), lengths[i]);
+    }
+
+    RC6Batch::processCTR(jobs.data(), jobs.size());
+    bool match = true;
+    for (size_t i = 0; i < jobCount; ++i) {
+        match = match && outputs[i] == expected[i];
+    }
+    std::cout << "CTR jobs:                " << verdict(match) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check the key schedule cache
+void runCacheTest(const uint8_t *key, const uint16_t keyLengthBits, const uint8_t *plaintext) {
+    std::cout << "Key schedule cache" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 reference;
+    reference.init(key, keyLengthBits);
+    uint8_t expected[16];
+    std::memcpy(expected, plaintext, 16);
+    reference.encrypt(expected);
+
+    RC6KeyCache cache(2);
+    const RC6KeyCache::Handle first = cache.get(1, key, keyLengthBits);
+    const RC6KeyCache::Handle again = cache.get(1, nullptr, 0);
+    uint8_t block[16];
+    std::memcpy(block, plaintext, 16);
+    first->encrypt(block);
+    const bool hitMatch = (first == again) && std::memcmp(block, expected, 16) == 0;
+    std::cout << "Hit returns shared schedule: " << verdict(hitMatch) << std::endl;
+
+    // Key 1 was used last, so inserting key 3 evicts key 2
+    cache.get(2, plaintext, 128);
+    cache.find(1);
+    cache.get(3, plaintext, 128);
+    const bool lruMatch = cache.size() == 2 && cache.find(1) && !cache.find(2) && cache.find(3);
+
+    // Handles outlive their entries
+    cache.clear();
+    std::memcpy(block, plaintext, 16);
+    first->encrypt(block);
+    const bool evictMatch = lruMatch && cache.size() == 0 && !cache.find(1) &&
+                            std::memcmp(block, expected, 16) == 0;
+    std::cout << "LRU eviction:                " << verdict(evictMatch) << std::endl;
+
+    // Lock-free hits racing with inserts and evictions in every shard
+    const size_t keyCount = 512;
+    std::vector<std::vector<uint8_t> > keys(keyCount, std::vector<uint8_t>(16));
+    std::vector<std::vector<uint8_t> > ciphertexts(keyCount, std::vector<uint8_t>(plaintext, plaintext + 16));
+    for (size_t id = 0; id < keyCount; ++id) {
+        for (size_t i = 0; i < 16; ++i) {
+            keys[id][i] = static_cast<uint8_t>(id * 31 + i);
+        }
+        RC6 keyed;
+        keyed.init(keys[id].data(), 128);
+        keyed.encrypt(ciphertexts[id].data());
+    }
+    RC6KeyCache shared(384);
+    std::vector<std::thread> readers;
+    std::vector<char> readerMatch(4, 1);
+    for (size_t t = 0; t < readerMatch.size(); ++t) {
+        readers.emplace_back([&, t] {
+            uint8_t out[16];
+            for (size_t n = 0; n < 20000; ++n) {
+                // Mostly hot keys, with a cold tail that keeps the shards evicting
+                const size_t id = n % 8 == 0 ? (n * 7 + t * 131) % keyCount : (n + t) % 64;
+                std::memcpy(out, plaintext, 16);
+                shared.get(id, keys[id].data(), 128)->encrypt(out);
+                readerMatch[t] = readerMatch[t] && std::memcmp(out, ciphertexts[id].data(), 16) == 0;
+            }
+        });
+    }
+    for (auto &reader: readers) {
+        reader.join();
+    }
+    const bool concurrentMatch = shared.size() <= shared.capacity() &&
+                                 std::count(readerMatch.begin(), readerMatch.end(), 1) == 4;
+    std::cout << "Concurrent lookups:          " << verdict(concurrentMatch) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check the parallel engine against the single-threaded API
+void runParallelTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "Parallel engine" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 rc6;
+    rc6.init(key, keyLengthBits);
+
+    const uint8_t iv[16] = {
+        0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+        0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+    };
+    const size_t blocks = 1000;
+    std::vector<uint8_t> plaintext(blocks * 16);
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 11 + 9);
+    }
+
+    // Small chunks so that every call is split into many tasks
+    RC6Parallel engine(4, 1000);
+
+    std::vector<uint8_t> expected(plaintext.size()), actual(plaintext.size());
+    rc6.encryptBlocks(plaintext.data(), expected.data(), blocks);
+    engine.encryptECB(rc6, plaintext.data(), actual.data(), blocks);
+    const bool ecbMatch = (actual == expected);
+    engine.decryptECB(rc6, actual.data(), actual.data(), blocks);
+    const bool ecbDecryptMatch = (actual == plaintext);
+    std::cout << "ECB:                     " << verdict(ecbMatch && ecbDecryptMatch) << std::endl;
+
+    const size_t ctrLength = plaintext.size() - 7;
+    RC6CTR ctr(rc6, iv);
+    ctr.processAt(3, plaintext.data(), expected.data(), ctrLength);
+    engine.processCTR(ctr, 3, plaintext.data(), actual.data(), ctrLength);
+    const bool ctrMatch = std::equal(actual.begin(), actual.begin() + ctrLength, expected.begin());
+    std::cout << "CTR:                     " << verdict(ctrMatch) << std::endl;
+
+    RC6Stream cbc(rc6, RC6Stream::Mode::CBC, RC6Stream::Direction::Encrypt, iv, false);
+    cbc.update(plaintext.data(), plaintext.size(), expected.data());
+    actual = expected;
+    engine.decryptCBC(rc6, iv, actual.data(), actual.data(), blocks);
+    const bool cbcMatch = (actual == plaintext);
+    std::cout << "CBC decryption:          " << verdict(cbcMatch) << std::endl;
+
+    // Callers sharing the ticket ring, each with mid-sized buffers of many chunks
+    RC6Parallel shared(3, 1000);
+    ctr.processAt(0, plaintext.data(), expected.data(), plaintext.size());
+    bool concurrentMatch = shared.chunkBytes() == 1008;
+    std::vector<std::vector<uint8_t> > results(4, std::vector<uint8_t>(plaintext.size()));
+    std::vector<std::thread> callers;
+    for (size_t t = 0; t < results.size(); ++t) {
+        callers.emplace_back([&, t] {
+            for (size_t round = 0; round < 50; ++round) {
+                shared.processCTR(ctr, 0, plaintext.data(), results[t].data(), plaintext.size());
+            }
+        });
+    }
+    for (auto &caller: callers) {
+        caller.join();
+    }
+    for (const auto &result: results) {
+        concurrentMatch = concurrentMatch && result == expected;
+    }
+    std::cout << "Concurrent callers:      " << verdict(concurrentMatch) << std::endl;
+
+    // Chunk sizes that are zero or wrap to zero when rounded up are rejected
+    const size_t maxSize = std::numeric_limits<size_t>::max();
+    bool chunkRejected = true;
+    for (const size_t chunkBytes: {static_cast<size_t>(0), maxSize, maxSize - 14}) {
+        try {
+            RC6Parallel bad(2, chunkBytes);
+            chunkRejected = false;
+        } catch (const std::invalid_argument &) {
+        }
+    }
+    std::cout << "Invalid chunk size:      " << verdict(chunkRejected) << std::endl;
+
+    std::cout << std::endl;
+}
+
+#ifdef RC6_ASYNC_COROUTINES
+// Coroutine that runs to completion on its own; the test waits on a promise
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() {
+        }
+
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+};
+
+DetachedTask encryptThenDecrypt(RC6Async &async, RC6Async::Request request, std::promise<void> &finished) {
+    try {
+        co_await async.schedule(request);
+        request.operation = RC6Async::Operation::DecryptECB;
+        request.in = request.out;
+        co_await async.schedule(request);
+        finished.set_value();
+    } catch (...) {
+        finished.set_exception(std::current_exception());
+    }
+}
+#endif
+
+// Function to check asynchronous submission against the synchronous API
+void runAsyncTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "Asynchronous jobs" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 ciphers[2];
+    for (size_t k = 0; k < 2; ++k) {
+        uint8_t tenantKey[32];
+        std::memcpy(tenantKey, key, keyLengthBits / 8);
+        tenantKey[0] ^= static_cast<uint8_t>(k);
+        ciphers[k].init(tenantKey, keyLengthBits);
+    }
+
+    const size_t blocks = 500;
+    std::vector<uint8_t> plaintext(blocks * 16);
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 5 + 3);
+    }
+
+    RC6Parallel engine(2, 1000);
+    RC6Async async(engine, 256);
+
+    // A burst of small CTR jobs with interleaved keys, plus some above the batch limit
+    const size_t jobCount = 40;
+    std::vector<std::vector<uint8_t> > outputs(jobCount), expected(jobCount);
+    std::mutex mutex;
+    std::condition_variable doneCv;
+    size_t done = 0;
+    bool errorSeen = false;
+    std::vector<size_t> order;
+    for (size_t i = 0; i < jobCount; ++i) {
+        const size_t len = i % 10 == 9 ? 1000 + i : 1 + 7 * i;
+        RC6Async::Request request = {RC6Async::Operation::ProcessCTR, &ciphers[i % 2], {0}, plaintext.data(),
+                                     nullptr, len};
+        std::memset(request.iv, static_cast<int>(i), 16);
+        request.iv[15] = 0xff;
+        outputs[i].resize(len);
+        expected[i].resize(len);
+        request.out = outputs[i].data();
+        RC6CTR(ciphers[i % 2], request.iv).process(plaintext.data(), expected[i].data(), len);
+
+        async.submit(request, [&, i](const std::exception_ptr error) {
+            std::lock_guard<std::mutex> lock(mutex);
+            errorSeen = errorSeen || error != nullptr;
+            order.push_back(i);
+            ++done;
+            doneCv.notify_all();
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCv.wait(lock, [&] { return done == jobCount; });
+    }
+    bool ctrMatch = !errorSeen;
+    for (size_t i = 0; i < jobCount; ++i) {
+        ctrMatch = ctrMatch && outputs[i] == expected[i];
+    }
+    std::cout << "CTR callbacks:           " << verdict(ctrMatch) << std::endl;
+    std::cout << "Submission order:        " << verdict(std::is_sorted(order.begin(), order.end()))
+              << std::endl;
+
+    // Hold the dispatcher in a handler while a queued job's cipher is cleared;
+    // only that job may fail, not the small jobs batched with it
+    RC6 doomed;
+    doomed.init(key, keyLengthBits);
+    std::promise<void> holding, release;
+    std::shared_future<void> released = release.get_future().share();
+    RC6Async::Request hold = {RC6Async::Operation::ProcessCTR, &ciphers[0], {0}, plaintext.data(),
+                              outputs[0].data(), 1};
+    async.submit(hold, [&holding, released](const std::exception_ptr) {
+        holding.set_value();
+        released.wait();
+    });
+    holding.get_future().wait();
+    std::vector<std::future<void> > isolated;
+    for (size_t i = 1; i < 4; ++i) {
+        RC6Async::Request request = {RC6Async::Operation::ProcessCTR, i == 2 ? &doomed : &ciphers[0], {0},
+                                     plaintext.data(), outputs[i].data(), outputs[i].size()};
+        isolated.push_back(async.submit(request));
+    }
+    doomed.clear();
+    release.set_value();
+    bool isolatedFailure = true;
+    for (size_t i = 0; i < isolated.size(); ++i) {
+        try {
+            isolated[i].get();
+            isolatedFailure = isolatedFailure && i != 1;
+        } catch (const std::runtime_error &) {
+            isolatedFailure = isolatedFailure && i == 1;
+        }
+    }
+    std::cout << "Per-job validation:      " << verdict(isolatedFailure) << std::endl;
+
+    std::vector<uint8_t> ecbExpected(plaintext.size()), ecbActual(plaintext.size());
+    ciphers[0].encryptBlocks(plaintext.data(), ecbExpected.data(), blocks);
+    RC6Async::Request ecb = {RC6Async::Operation::EncryptECB, &ciphers[0], {0}, plaintext.data(),
+                             ecbActual.data(), plaintext.size()};
+    std::future<void> ecbDone = async.submit(ecb);
+
+    // CBC decryption of the same ciphertext interpreted as a CBC message with a zero IV
+    std::vector<uint8_t> cbcActual(plaintext.size());
+    RC6Async::Request cbc = {RC6Async::Operation::DecryptCBC, &ciphers[0], {0}, ecbExpected.data(),
+                             cbcActual.data(), plaintext.size()};
+    std::future<void> cbcDone = async.submit(cbc);
+    ecbDone.get();
+    cbcDone.get();
+    bool cbcMatch = true;
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        const uint8_t chain = i < 16 ? 0 : ecbExpected[i - 16];
+        cbcMatch = cbcMatch && static_cast<uint8_t>(cbcActual[i] ^ chain) == plaintext[i];
+    }
+    std::cout << "ECB/CBC futures:         " << verdict(ecbActual == ecbExpected && cbcMatch)
+              << std::endl;
+
+#ifdef RC6_ASYNC_COROUTINES
+    std::vector<uint8_t> roundTrip(plaintext.size());
+    std::promise<void> finished;
+    std::future<void> coroutineDone = finished.get_future();
+    encryptThenDecrypt(async, RC6Async::Request{RC6Async::Operation::EncryptECB, &ciphers[1], {0},
+                                                plaintext.data(), roundTrip.data(), plaintext.size()}, finished);
+    coroutineDone.get();
+    std::cout << "Coroutine awaitables:    " << verdict(roundTrip == plaintext) << std::endl;
+#endif
+
+    // Argument errors are reported by submit, not by the completion
+    RC6 uninitialized;
+    RC6Async::Request bad = ecb;
+    bad.len = 17;
+    bool rejected = false;
+    try {
+        async.submit(bad);
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    bad.len = 16;
+    bad.cipher = &uninitialized;
+    try {
+        async.submit(bad);
+        rejected = false;
+    } catch (const std::runtime_error &) {
+    }
+    std::cout << "Invalid input:           " << verdict(rejected) << std::endl;
+
+    std::cout << std::endl;
+}
+
+// Function to check file encryption against in-memory CTR
+void runFileTest(const uint8_t *key, const uint16_t keyLengthBits) {
+    std::cout << "File encryption" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    RC6 rc6;
+    rc6.init(key, keyLengthBits);
+
+    const uint8_t iv[16] = {
+        0xf0, 0xe1, 0xd2, 0xc3, 0xb4, 0xa5, 0x96, 0x87,
+        0x78, 0x69, 0x5a, 0x4b, 0x3c, 0x2d, 0x1e, 0x0f
+    };
+    const RC6CTR ctr(rc6, iv);
+
+    // Several windows plus a partial one
+    std::vector<uint8_t> plaintext(3 * 4096 + 123);
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 13 + 5);
+    }
+    std::vector<uint8_t> expected(plaintext.size());
+    ctr.processAt(0, plaintext.data(), expected.data(), plaintext.size());
+
+    const char *inPath = "rc6_file_test_in.bin";
+    const char *outPath = "rc6_file_test_out.bin";
+    std::ofstream(inPath, std::ios::binary).write(reinterpret_cast<const char *>(plaintext.data()),
+                                                  static_cast<std::streamsize>(plaintext.size()));
+
+    const auto readBack = [](const char *path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+
+    RC6Parallel engine(2, 1000);
+    const RC6File files(engine, 4096);
+
+    const bool copyMatch = files.process(ctr, inPath, outPath) == plaintext.size() && readBack(outPath) == expected;
+    std::cout << "Copy:                    " << verdict(copyMatch) << std::endl;
+
+    const bool inPlaceMatch = files.processInPlace(ctr, inPath) == plaintext.size() &&
+                              readBack(inPath) == expected &&
+                              files.processInPlace(ctr, outPath) == plaintext.size() &&
+                              readBack(outPath) == plaintext;
+    std::cout << "In place:                " << verdict(inPlaceMatch) << std::endl;
+
+    // Naming the same file twice must not truncate it
+    const bool samePath = files.process(ctr, outPath, outPath) == plaintext.size() && readBack(outPath) == expected;
+    std::cout << "Same input and output:   " << verdict(samePath) << std::endl;
+
+    std::remove(inPath);
+    std::remove(outPath);
 
     std::cout << std::endl;
 }
@@ -180,10 +1674,50 @@ int main() {
         if (std::memcmp(plaintext1, decryptedtext12, 16) == 0) {
             std::cout << "Test passed: Decryption with 12 rounds matches plaintext!" << std::endl;
         } else {
+            ++failedChecks;
             std::cout << "Test failed: Decryption with 12 rounds does not match plaintext!" << std::endl;
         }
 
-        std::cout << "\nAll tests completed!" << std::endl;
+        std::cout << std::endl;
+        // Block counts chosen to exercise every vector width plus a scalar tail
+        runBulkTest(key6, 256, 1);
+        runBulkTest(key6, 256, 37);
+        runBulkTest(key2, 128, 1000);
+        runBulkTest(key6, 256, 3);
+
+        // Interleaved scalar kernel with rounds that are not a multiple of its unroll
+        runBulkTest(key2, 128, 7, 13);
+        runBackendTest(key6, 256);
+        runScheduleTest(key2, 128);
+        runGenericTest(key6, 256, plaintext2);
+        runStatsTest(key2, 128);
+
+        // Unrolled single-block kernels against the generic vector loop
+        runBulkTest(key2, 128, 64, 12);
+        runBulkTest(key2, 128, 64, 16);
+        runBulkTest(key2, 128, 64, 7);
+        runMoveTest(key6, 256, plaintext2);
+        runWipeTest(key6, 256, plaintext2);
+        runNoThrowTest(key6, 256, plaintext2);
+        runInitManyTest(key2, 128);
+        runInitManyTest(key6, 200);
+        runCtrTest(key6, 256);
+        runStreamTest(key2, 128);
+        runCbcTest(key4, 192);
+        runOcbTest(key2, 128);
+        runXtsTest(key6, 256);
+        runBatchTest(key4, 192);
+        runParallelTest(key4, 192);
+        runAsyncTest(key6, 256);
+        runFileTest(key2, 128);
+        runCacheTest(key6, 256, plaintext2);
+
+        if (failedChecks != 0) {
+            std::cout << failedChecks << " checks FAILED" << std::endl;
+            return 1;
+        }
+
+        std::cout << "All tests completed!" << std::endl;
         return 0;
     } catch (const std::exception &e) {
         std::cerr << "Error: " << e.what() << std::endl;